@@ -316,6 +316,30 @@ return -- default actionName key binding
         actionName = "builtin.closePanel",
         keys       = { "Escape" },
     },
+    {
+        actionName = "builtin.cancelAsyncActions",
+        keys       = { "Escape" },
+    },
+    {
+        actionName = "builtin.cancelFindInFiles",
+        keys       = { "Escape" },
+    },
+    {
+        actionName = "builtin.removeAdditionalCursors",
+        keys       = { "Escape" },
+    },
+    {
+        actionName = "builtin.addCursorBelow",
+        keys       = { "Alt+Shift+Down", "Alt+Shift+KP_Down" },
+    },
+    {
+        actionName = "builtin.addCursorAbove",
+        keys       = { "Alt+Shift+Up", "Alt+Shift+KP_Up" },
+    },
+    {
+        actionName = "builtin.addCursorsToSelectedLines",
+        keys       = { "Alt+Shift+L" },
+    },
     {
         actionName = "builtin.focusNext",
         keys       = { "Tab" },
@@ -400,6 +424,42 @@ return -- default actionName key binding
         actionName = "builtin.findAgainBackward",
         keys       = { "Ctrl+Shift+G" },
     },
+    {
+        actionName = "builtin.findSelectionInFiles",
+        keys       = { "Ctrl+Alt+F" },
+    },
+    {
+        actionName = "builtin.gotoLocationAtCursor",
+        keys       = { "F4" },
+    },
+    {
+        actionName = "builtin.gotoDefinition",
+        keys       = { "F3" },
+    },
+    {
+        actionName = "builtin.completeSymbol",
+        keys       = { "Ctrl+Alt+space" },
+    },
+    {
+        actionName = "builtin.highlightAllMatches",
+        keys       = { "Ctrl+Alt+H" },
+    },
+    {
+        actionName = "builtin.toggleMacroRecording",
+        keys       = { "Alt+Shift+R" },
+    },
+    {
+        actionName = "builtin.replayMacro",
+        keys       = { "Alt+Shift+P" },
+    },
+    {
+        actionName = "builtin.replayMacroToEndOfFile",
+        keys       = { "Alt+Shift+E" },
+    },
+    {
+        actionName = "builtin.completeWord",
+        keys       = { "Alt+slash" },
+    },
     {
         actionName = "builtin.requestProgramTermination",
         keys       = { "Ctrl+Q" },
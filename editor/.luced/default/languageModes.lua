@@ -8,6 +8,12 @@ return
       hilitingBreakPointDistance = 50,
       hardTabWidth = 8,
       softTabWidth = 4,
+      definitionPatterns = {
+          { kind = "class",    regex = [[(?m)^[ \t]*(?:template[ \t]*<[^>]*>\s*)?(?:class|struct|union|enum)\s+(?:\w+\s+)?(\w+)\s*(?::[^;{]*)?\{]] },
+          { kind = "function", regex = [[(?m)^[A-Za-z_][\w:<>,*& \t]*?\b(\w+)\s*\([^;{}()]*\)\s*(?:const\s*)?(?::[^;{]*)?\{]] },
+          { kind = "macro",    regex = [[(?m)^[ \t]*#[ \t]*define[ \t]+(\w+)]] },
+          { kind = "typedef",  regex = [[(?m)^[ \t]*typedef\b[^;{}]*?\b(\w+)[ \t]*;]] },
+      },
     },
     
     {
@@ -38,6 +44,13 @@ return
       hilitingBreakPointDistance = 50,
       hardTabWidth = 8,
       softTabWidth = 4,
+      blockBeginWords  = "function if do repeat while:do for:do",
+      blockMiddleWords = "then else elseif",
+      blockEndWords    = "end until",
+      definitionPatterns = {
+          { kind = "function", regex = [[(?m)^[ \t]*(?:local[ \t]+)?function[ \t]+([\w.:]+)]] },
+          { kind = "function", regex = [[(?m)^[ \t]*(?:local[ \t]+)?([\w.]+)[ \t]*=[ \t]*function\b]] },
+      },
     },
     
     {
@@ -48,6 +61,12 @@ return
       hilitingBreakPointDistance = 50,
       hardTabWidth = 8,
       softTabWidth = 4,
+      blockBeginWords  = "if case do",
+      blockMiddleWords = "then else elif",
+      blockEndWords    = "fi esac done",
+      definitionPatterns = {
+          { kind = "function", regex = [[(?m)^[ \t]*(?:function[ \t]+)?(\w+)[ \t]*\([ \t]*\)]] },
+      },
     },
     
     {
@@ -0,0 +1,245 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "AsyncLuaAction.hpp"
+#include "EventDispatcher.hpp"
+#include "GlobalLuaInterpreter.hpp"
+#include "ViewLuaInterface.hpp"
+#include "LuaException.hpp"
+#include "LuaFunctionArguments.hpp"
+#include "Commandline.hpp"
+#include "ByteBuffer.hpp"
+#include "File.hpp"
+#include "FileException.hpp"
+
+using namespace LucED;
+
+namespace // anonymous namespace
+{
+
+const char* const resumeFunctionScript = 
+    "return function(co, ...)\n"
+    "    local rslt = { coroutine.resume(co, ...) }\n"
+    "    rslt.dead = (coroutine.status(co) == 'dead')\n"
+    "    return rslt\n"
+    "end\n";
+
+} // anonymous namespace
+
+
+AsyncLuaAction::WeakPtr AsyncLuaAction::start(const LuaVar&            function,
+                                              RawPtr<TextEditorWidget> textEditor,
+                                              Callback<>::Ptr          exceptionHandler)
+{
+    LuaAccess luaAccess = GlobalLuaInterpreter::getInstance()->getCurrentLuaAccess();
+
+    OwningPtr rslt(new AsyncLuaAction(textEditor, exceptionHandler));
+    
+    LuaVar coroutineModule = luaAccess.getGlobalVariables()["coroutine"];
+    LuaVar coroutineCreate = coroutineModule["create"];
+    LuaVar coroutine       = coroutineCreate.call(function);
+    LuaVar view(luaAccess, textEditor->getViewLuaInterface());
+
+    rslt->resumeFunctionReference = luaAccess.loadString(resumeFunctionScript).call().store();
+    rslt->coroutineReference      = coroutine.store();
+    rslt->resumeValues.append(view.store());
+
+    EventDispatcher::getInstance()->registerRunningComponent(rslt);
+    EventDispatcher::getInstance()->registerProcess(rslt->processHandler);
+
+    return rslt;
+}
+
+
+AsyncLuaAction::AsyncLuaAction(RawPtr<TextEditorWidget> textEditor,
+                               Callback<>::Ptr          exceptionHandler)
+    : state(READY),
+      textEditor(textEditor),
+      exceptionHandler(exceptionHandler),
+      processHandler(ProcessHandler::create(this, &AsyncLuaAction::process,
+                                                  &AsyncLuaAction::needsProcessing))
+{}
+
+
+void AsyncLuaAction::cancel()
+{
+    if (state != FINISHED) {
+        finish();
+    }
+}
+
+
+void AsyncLuaAction::finish()
+{
+    state = FINISHED;
+    resumeValues.clear();
+    processHandler->disable();
+    EventDispatcher::getInstance()->deregisterRunningComponent(this);
+}
+
+
+bool AsyncLuaAction::needsProcessing()
+{
+    return state == READY;
+}
+
+
+int AsyncLuaAction::process(TimeStamp endTime)
+{
+    do
+    {
+        if (!textEditor.isValid()) {
+            finish();
+        }
+        else
+        {
+            try
+            {
+                TextData::HistorySection::Ptr historySectionHolder = textEditor->getTextData()->createHistorySection();
+                resume();
+            }
+            catch (...)
+            {
+                finish();
+                if (exceptionHandler.isValid()) {
+                    exceptionHandler->call();
+                }
+            }
+        }
+    }
+    while (state == READY && TimeStamp::now() < endTime);
+    
+    return 0;
+}
+
+
+void AsyncLuaAction::resume()
+{
+    LuaAccess luaAccess = GlobalLuaInterpreter::getInstance()->getCurrentLuaAccess();
+
+    LuaFunctionArguments args(luaAccess);
+    
+    args << luaAccess.retrieve(coroutineReference);
+    
+    for (int i = 0; i < resumeValues.getLength(); ++i) {
+        args << luaAccess.retrieve(resumeValues[i]);
+    }
+    resumeValues.clear();
+
+    LuaVar rslt = luaAccess.retrieve(resumeFunctionReference).call(args);
+    
+    if (!rslt[1].toBoolean()) {
+        throw LuaException(rslt[2]);
+    }
+    if (rslt["dead"].toBoolean()) {
+        finish();
+    } else {
+        handleRequest(rslt[2], rslt[3], rslt[4]);
+    }
+}
+
+
+void AsyncLuaAction::handleRequest(const LuaVar& request, const LuaVar& argument1, const LuaVar& argument2)
+{
+    String requestName = request.isString() ? request.toString() : "yield";
+
+    if (requestName == "sleep")
+    {
+        double secs = argument1.isNumber() ? argument1.toNumber() : 0;
+        if (secs < 0) {
+            secs = 0;
+        }
+        long microSecs = (long)(secs * 1000 * 1000);
+        
+        state = SLEEPING;
+        EventDispatcher::getInstance()->registerTimerCallback(Seconds(microSecs / (1000 * 1000)),
+                                                              MicroSeconds(microSecs % (1000 * 1000)),
+                                                              newCallback(this, &AsyncLuaAction::handleWakeup));
+    }
+    else if (requestName == "execute")
+    {
+        if (!argument1.isString()) {
+            throw LuaException(argument1.getLuaAccess(), "luced.execute needs script string argument");
+        }
+        Commandline::Ptr commandline = Commandline::create();
+                         commandline->append("/bin/sh");
+                         commandline->append("-c");
+                         commandline->append(argument1.toString());
+        
+        HeapHashMap<String,String>::Ptr env = HeapHashMap<String,String>::create();
+                                        env->set("FILE", textEditor->getTextData()->getFileName());
+        state = WAITING_FOR_REQUEST;
+        ProgramExecutor::start(commandline,
+                               argument2.isString() ? argument2.toString() : String(),
+                               env,
+                               newCallback(this, &AsyncLuaAction::handleProgramResult));
+    }
+    else if (requestName == "readFile")
+    {
+        if (!argument1.isString()) {
+            throw LuaException(argument1.getLuaAccess(), "luced.readFile needs file name argument");
+        }
+        readFile(argument1.toString());
+    }
+    else {
+        // "yield" and unknown requests: continue in the next slice
+    }
+}
+
+
+void AsyncLuaAction::readFile(const String& fileName)
+{
+    LuaAccess luaAccess = GlobalLuaInterpreter::getInstance()->getCurrentLuaAccess();
+
+    try
+    {
+        ByteBuffer buffer;
+        File(fileName).loadInto(&buffer);
+        resumeValues.append(LuaVar(luaAccess, buffer.toString()).store());
+    }
+    catch (FileException& ex)
+    {
+        resumeValues.append(LuaVar(luaAccess).store());
+        resumeValues.append(LuaVar(luaAccess, ex.getMessage()).store());
+    }
+}
+
+
+void AsyncLuaAction::handleWakeup()
+{
+    if (state == SLEEPING) {
+        state = READY;
+    }
+}
+
+
+void AsyncLuaAction::handleProgramResult(ProgramExecutor::Result rslt)
+{
+    if (state == WAITING_FOR_REQUEST)
+    {
+        LuaAccess luaAccess = GlobalLuaInterpreter::getInstance()->getCurrentLuaAccess();
+
+        resumeValues.append(LuaVar(luaAccess, (long)rslt.returnCode).store());
+        resumeValues.append(LuaVar(luaAccess, rslt.outputBuffer->toString()).store());
+        state = READY;
+    }
+}
+
@@ -0,0 +1,98 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ASYNC_LUA_ACTION_HPP
+#define ASYNC_LUA_ACTION_HPP
+
+#include "RunningComponent.hpp"
+#include "OwningPtr.hpp"
+#include "WeakPtr.hpp"
+#include "RawPtr.hpp"
+#include "ObjectArray.hpp"
+#include "Callback.hpp"
+#include "ProcessHandler.hpp"
+#include "ProgramExecutor.hpp"
+#include "TextEditorWidget.hpp"
+#include "LuaVar.hpp"
+#include "LuaStoredObjectReference.hpp"
+
+namespace LucED
+{
+
+/**
+ * Runs a Lua action function as coroutine that is resumed in
+ * process slices of the EventDispatcher.
+ *
+ * The coroutine gives control back to the event loop by calling
+ * luced.yield(), luced.sleep(seconds), luced.execute(script, input)
+ * or luced.readFile(fileName). The last two are resumed with the
+ * result of the request.
+ */
+class AsyncLuaAction : public RunningComponent
+{
+public:
+    typedef LucED::OwningPtr<AsyncLuaAction> OwningPtr;
+    typedef LucED::WeakPtr  <AsyncLuaAction> WeakPtr;
+
+    static WeakPtr start(const LuaVar&            function,
+                         RawPtr<TextEditorWidget> textEditor,
+                         Callback<>::Ptr          exceptionHandler);
+    
+    void cancel();
+
+    bool isRunning() const {
+        return state != FINISHED;
+    }
+
+private:
+    enum State
+    {
+        READY,
+        SLEEPING,
+        WAITING_FOR_REQUEST,
+        FINISHED
+    };
+
+    AsyncLuaAction(RawPtr<TextEditorWidget> textEditor,
+                   Callback<>::Ptr          exceptionHandler);
+    
+    bool needsProcessing();
+    int  process(TimeStamp endTime);
+
+    void resume();
+    void handleRequest(const LuaVar& request, const LuaVar& argument1, const LuaVar& argument2);
+    void handleWakeup();
+    void handleProgramResult(ProgramExecutor::Result rslt);
+    void readFile(const String& fileName);
+    void finish();
+
+    State                                 state;
+    LucED::WeakPtr<TextEditorWidget>      textEditor;
+    Callback<>::Ptr                       exceptionHandler;
+    ProcessHandler::Ptr                   processHandler;
+    LuaStoredObjectReference              resumeFunctionReference;
+    LuaStoredObjectReference              coroutineReference;
+    ObjectArray<LuaStoredObjectReference> resumeValues;
+};
+
+} // namespace LucED
+
+#endif // ASYNC_LUA_ACTION_HPP
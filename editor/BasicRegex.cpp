@@ -44,6 +44,8 @@ void BasicRegex::initialize(const char* expr, CreateOptions createOptions)
     const char* errortext;
     int errorpos;
 
+    studyData = NULL;
+
     re = pcre_compile(expr, 
                       createOptions.getOptions()|PCRE_UTF8|PCRE_NO_UTF8_CHECK, 
                       &errortext,
@@ -69,9 +71,25 @@ BasicRegex::BasicRegex(const ByteArray& expr, CreateOptions createOptions)
 }
 
 
+void BasicRegex::study()
+{
+    ASSERT(re != NULL);
+    ASSERT(studyData == NULL);
+    
+    const char* errortext = NULL;
+    
+    studyData = pcre_study(re, 0, &errortext);
+
+    if (errortext != NULL) {
+        throw RegexException(errortext);
+    }
+}
+
+
 BasicRegex::BasicRegex(const BasicRegex& src)
 {
-    re = src.re;
+    re        = src.re;
+    studyData = src.studyData;
     if (re != NULL) {
         pcre_refcount(re, +1);
     }
@@ -80,8 +98,10 @@ BasicRegex::BasicRegex(const BasicRegex& src)
 
 BasicRegex& BasicRegex::operator=(const BasicRegex& src)
 {
-    pcre* oldRe = re;
-    re = src.re;
+    pcre*       oldRe        = re;
+    pcre_extra* oldStudyData = studyData;
+    re        = src.re;
+    studyData = src.studyData;
     if (re != NULL) {
         pcre_refcount(re, +1);
     }
@@ -89,6 +109,9 @@ BasicRegex& BasicRegex::operator=(const BasicRegex& src)
         int refCount = pcre_refcount(oldRe, -1);
         if (refCount == 0) {
             pcre_free(oldRe);
+            if (oldStudyData != NULL) {
+                pcre_free(oldStudyData);
+            }
         }
     }
     return *this;
@@ -102,6 +125,10 @@ BasicRegex::~BasicRegex()
         if (refCount == 0) {
             pcre_free(re);
             re = NULL;
+            if (studyData != NULL) {
+                pcre_free(studyData);
+                studyData = NULL;
+            }
         }
     }
 }
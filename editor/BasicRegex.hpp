@@ -35,7 +35,7 @@ namespace LucED
 class BasicRegex : public BasicRegexTypes
 {
 public:
-    BasicRegex() : re(NULL) {
+    BasicRegex() : re(NULL), studyData(NULL) {
         pcre_callout = pcreCalloutCallback;
     }
     BasicRegex(const String&    expr, CreateOptions createOptions = CreateOptions());
@@ -49,6 +49,13 @@ public:
         return re != NULL;
     }
 
+    /**
+     * Analyzes the pattern for the set of bytes a match can start with.
+     * pcre_exec then skips to candidate positions instead of trying the
+     * pattern at each byte. Should be called before the regex is copied.
+     */
+    void study();
+
     int getCaptureNumberByName(const String& substringName) const;
     int getCaptureNumberByName(const ByteArray& substringName) const;
 
@@ -64,7 +71,7 @@ public:
     {
         ASSERT(pcre_callout == pcreCalloutCallback);
 
-        return pcre_exec(re, NULL, subject, length, startoffset, matchOptions.getOptions()|PCRE_NO_UTF8_CHECK, 
+        return pcre_exec(re, studyData, subject, length, startoffset, matchOptions.getOptions()|PCRE_NO_UTF8_CHECK, 
                 ovector.getPtr(0), ovector.getLength()) > 0;
     }
     
@@ -84,6 +91,11 @@ public:
                    extra.flags        = PCRE_EXTRA_CALLOUT_DATA;
                    extra.callout_data = &calloutData;
         
+        if (studyData != NULL) {
+                   extra.flags     |= PCRE_EXTRA_STUDY_DATA;
+                   extra.study_data = studyData->study_data;
+        }
+        
         bool rslt = pcre_exec(re, &extra, subject, length, startoffset, matchOptions.getOptions()|PCRE_NO_UTF8_CHECK, 
                     ovector.getPtr(0), ovector.getLength()) > 0;
 
@@ -103,6 +115,7 @@ private:
     static int pcreCalloutCallback(pcre_callout_block*);
     static const unsigned char* pcreCharTable;
     pcre* re;
+    pcre_extra* studyData;
 };
 
 } // namespace LucED
@@ -0,0 +1,432 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "BlockMatcher.hpp"
+#include "util.hpp"
+
+using namespace LucED;
+
+namespace // anonymous namespace
+{
+
+const long INDEX_CHUNK_SIZE = 8 * 1024;
+
+inline bool isWordByte(byte c)
+{
+    return (c >= 'a' && c <= 'z')
+        || (c >= 'A' && c <= 'Z')
+        || (c >= '0' && c <= '9')
+        ||  c == '_'
+        ||  c >= 0x80;
+}
+
+} // anonymous namespace
+
+
+BlockMatcher::BlockMatcher(HilitedText::Ptr hilitedText)
+    : hilitedText(hilitedText),
+      textData(hilitedText->getTextData()),
+      hilitingBuffer(HilitingBuffer::create(hilitedText)),
+      indexedEndPos(0),
+      maxWordLength(0)
+{
+    resetIndex();
+
+    textData      ->registerUpdateListener             (newCallback(this, &BlockMatcher::treatTextDataUpdate));
+    hilitingBuffer->registerUpdateListener             (newCallback(this, &BlockMatcher::treatHilitingUpdate));
+    hilitingBuffer->registerTextStylesChangedListeners (newCallback(this, &BlockMatcher::treatTextStylesChanged));
+    hilitingBuffer->registerLanguageModeChangedCallback(newCallback(this, &BlockMatcher::treatLanguageModeChange));
+
+    treatLanguageModeChange(hilitedText->getLanguageMode());
+}
+
+
+void BlockMatcher::addWords(const String& wordList, ElementType type)
+{
+    long i = 0;
+    long n = wordList.getLength();
+    
+    while (i < n)
+    {
+        while (i < n && !isWordByte(wordList[i])) {
+            ++i;
+        }
+        long begin = i;
+        while (i < n && isWordByte(wordList[i])) {
+            ++i;
+        }
+        if (i > begin)
+        {
+            String word = wordList.getSubstring(Pos(begin), Pos(i));
+
+            words.set(word, type);
+            isWordBeginByte[(byte) wordList[begin]] = true;
+            util::maximize(&maxWordLength, (int)(i - begin));
+            
+            if (i < n && wordList[i] == ':')
+            {
+                long contBegin = ++i;
+                while (i < n && isWordByte(wordList[i])) {
+                    ++i;
+                }
+                if (i > contBegin)
+                {
+                    String continuationWord = wordList.getSubstring(Pos(contBegin), Pos(i));
+                    
+                    continuationWordIds.set(word, continuationWords.getLength());
+                    continuationWords.append(continuationWord);
+                    
+                    if (!words.get(continuationWord).isValid()) {
+                        words.set(continuationWord, MIDDLE);
+                        isWordBeginByte[(byte) wordList[contBegin]] = true;
+                        util::maximize(&maxWordLength, (int)(i - contBegin));
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+void BlockMatcher::treatLanguageModeChange(LanguageMode::Ptr languageMode)
+{
+    words.clear();
+    continuationWordIds.clear();
+    continuationWords.clear();
+    memset(isWordBeginByte, 0, sizeof(isWordBeginByte));
+    maxWordLength = 0;
+
+    if (languageMode.isValid())
+    {
+        addWords(languageMode->getBlockBeginWords(),  BEGIN);
+        addWords(languageMode->getBlockMiddleWords(), MIDDLE);
+        addWords(languageMode->getBlockEndWords(),    END);
+    }
+    treatTextStylesChanged(hilitedText->getSyntaxPatterns()->getTextStylesArray());
+}
+
+
+void BlockMatcher::treatTextStylesChanged(const ObjectArray<TextStyle::Ptr>& newTextStyles)
+{
+    SyntaxPatterns::Ptr syntaxPatterns = hilitedText->getSyntaxPatterns();
+
+    isRegionStyle.clear();
+    isRegionStyle.appendAmount(newTextStyles.getLength());
+    
+    for (int i = 0; i < isRegionStyle.getLength(); ++i) {
+        isRegionStyle[i] = false;
+    }
+    if (syntaxPatterns->hasPatterns())
+    {
+        int rootStyle = syntaxPatterns->get(0)->style;
+        
+        for (int i = 1; i < syntaxPatterns->getNumberOfPatterns(); ++i)
+        {
+            SyntaxPattern* sp = syntaxPatterns->get(i);
+            
+            if (   sp->hasEndPattern 
+                && sp->style != rootStyle 
+                && sp->style < isRegionStyle.getLength())
+            {
+                isRegionStyle[sp->style] = true;
+            }
+        }
+    }
+    resetIndex();
+}
+
+
+void BlockMatcher::resetIndex()
+{
+    elements.clear();
+    indexedEndPos = 0;
+    
+    for (int f = 0; f < NUMBER_OF_FAMILIES; ++f) {
+        state.levels[f] = 0;
+    }
+    state.continuationLevel  = -1;
+    state.continuationWordId = -1;
+}
+
+
+void BlockMatcher::truncateIndex(long pos)
+{
+    if (pos < indexedEndPos)
+    {
+        long i = elements.getLength();
+        while (i > 0 && elements[i - 1].endPos >= pos) {
+            --i;
+        }
+        elements.removeTail(i);
+        
+        if (i > 0) {
+            const Element& last = elements.getLast();
+            indexedEndPos = last.endPos;
+            state         = last.stateAfter;
+        } else {
+            resetIndex();
+        }
+    }
+}
+
+
+void BlockMatcher::treatTextDataUpdate(TextData::UpdateInfo update)
+{
+    // styles of text before the changed position can depend on lookahead
+    
+    truncateIndex(update.beginChangedPos - hilitedText->getSyntaxPatterns()->getTotalMaxExtend());
+}
+
+
+void BlockMatcher::treatHilitingUpdate(HilitingBuffer::UpdateInfo update)
+{
+    truncateIndex(update.beginPos);
+}
+
+
+bool BlockMatcher::isInsideRegion(long pos)
+{
+    int style = hilitingBuffer->getTextStyle(pos);
+    
+    return style < isRegionStyle.getLength() && isRegionStyle[style];
+}
+
+
+void BlockMatcher::appendElement(long beginPos, long endPos, ElementType type, int family)
+{
+    int& level = state.levels[family];
+    
+    if (type != BEGIN && level == 0) {
+        return; // no open block of this family
+    }
+    Element e;
+            e.beginPos = beginPos;
+            e.endPos   = endPos;
+            e.type     = type;
+            e.family   = family;
+    switch (type) {
+        case BEGIN:  e.level = level++;   break;
+        case MIDDLE: e.level = level - 1; break;
+        case END:    e.level = --level;   break;
+    }
+    if (family == KEYWORD_FAMILY && level <= state.continuationLevel) {
+        state.continuationLevel = -1; // block was closed before its continuation word
+    }
+    e.stateAfter = state;
+    elements.append(e);
+}
+
+
+bool BlockMatcher::extendIndex()
+{
+    const long textLength = textData->getLength();
+
+    if (indexedEndPos >= textLength) {
+        return false;
+    }
+    long pos    = indexedEndPos;
+    long endPos = util::minimum(pos + INDEX_CHUNK_SIZE, textLength);
+    
+    while (pos < endPos)
+    {
+        byte c = textData->getByte(pos);
+
+        if (isWordByte(c))
+        {
+            long wordEnd = pos + 1;
+            while (wordEnd < textLength && isWordByte(textData->getByte(wordEnd))) {
+                ++wordEnd;
+            }
+            if (isWordBeginByte[c] && wordEnd - pos <= maxWordLength)
+            {
+                String                     word      = textData->getSubstring(Pos(pos), Pos(wordEnd));
+                HashMap<String,int>::Value foundType = words.get(word);
+                
+                if (foundType.isValid() && !isInsideRegion(pos))
+                {
+                    ElementType type = (ElementType) foundType.get();
+
+                    if (   state.continuationLevel >= 0
+                        && state.continuationLevel + 1 == state.levels[KEYWORD_FAMILY]
+                        && continuationWords[state.continuationWordId] == word)
+                    {
+                        type = MIDDLE;
+                        state.continuationLevel = -1;
+                    }
+                    else if (type == BEGIN)
+                    {
+                        HashMap<String,int>::Value continuationWordId = continuationWordIds.get(word);
+                        
+                        if (continuationWordId.isValid()) {
+                            state.continuationLevel  = state.levels[KEYWORD_FAMILY];
+                            state.continuationWordId = continuationWordId.get();
+                        }
+                    }
+                    appendElement(pos, wordEnd, type, KEYWORD_FAMILY);
+                }
+            }
+            pos = wordEnd;
+        }
+        else
+        {
+            int         family = -1;
+            ElementType type   = BEGIN;
+
+            switch (c) {
+                case '(': family = 0; type = BEGIN; break;
+                case ')': family = 0; type = END;   break;
+                case '[': family = 1; type = BEGIN; break;
+                case ']': family = 1; type = END;   break;
+                case '{': family = 2; type = BEGIN; break;
+                case '}': family = 2; type = END;   break;
+            }
+            if (family >= 0 && !isInsideRegion(pos)) {
+                appendElement(pos, pos + 1, type, BRACKET_FAMILY_OFFSET + family);
+            }
+            ++pos;
+        }
+    }
+    indexedEndPos = pos;
+    return true;
+}
+
+
+void BlockMatcher::extendIndexTo(long pos)
+{
+    textData->flushPendingUpdates();
+
+    while (indexedEndPos < pos && extendIndex())
+    {}
+}
+
+
+long BlockMatcher::findElementAt(long pos, bool preferElementBefore)
+{
+    extendIndexTo(pos + 1);
+    
+    long before = -1;
+    long after  = -1;
+    
+    long i = findPrevElement(pos);
+    if (i >= 0 && elements[i].endPos == pos) {
+        before = i;
+    }
+    if (i + 1 < elements.getLength() && elements[i + 1].beginPos <= pos) {
+        after = i + 1;
+    }
+    if (before >= 0 && (preferElementBefore || after < 0)) {
+        return before;
+    } else {
+        return after;
+    }
+}
+
+
+long BlockMatcher::findPrevElement(long pos)
+{
+    extendIndexTo(pos);
+
+    // binary search for last element with endPos <= pos
+
+    long lo = 0;
+    long hi = elements.getLength();
+    
+    while (lo < hi)
+    {
+        long m = (lo + hi) / 2;
+        if (elements[m].endPos <= pos) {
+            lo = m + 1;
+        } else {
+            hi = m;
+        }
+    }
+    return lo - 1;
+}
+
+
+long BlockMatcher::findNextElement(long pos)
+{
+    long i = findPrevElement(pos) + 1;
+    
+    while (i >= elements.getLength() || elements[i].beginPos < pos)
+    {
+        if (i < elements.getLength()) {
+            ++i;
+        }
+        else if (!extendIndex()) {
+            return -1;
+        }
+    }
+    return i;
+}
+
+
+long BlockMatcher::findNextElementOfBlock(long index)
+{
+    const int family = elements[index].family;
+    const int level  = elements[index].level;
+    
+    for (long i = index + 1; i < elements.getLength() || extendIndex(); ++i)
+    {
+        if (i < elements.getLength())
+        {
+            const Element& e = elements[i];
+            
+            if (e.family != family) {
+                continue;
+            }
+            if (e.level < level) {
+                return -1;
+            }
+            if (e.level == level) {
+                return (e.type != BEGIN) ? i : -1;
+            }
+        }
+        else {
+            --i;
+        }
+    }
+    return -1;
+}
+
+
+long BlockMatcher::findPrevElementOfBlock(long index)
+{
+    const int family = elements[index].family;
+    const int level  = elements[index].level;
+    
+    for (long i = index - 1; i >= 0; --i)
+    {
+        const Element& e = elements[i];
+        
+        if (e.family != family) {
+            continue;
+        }
+        if (e.level < level) {
+            return -1;
+        }
+        if (e.level == level) {
+            return (e.type != END) ? i : -1;
+        }
+    }
+    return -1;
+}
+
@@ -0,0 +1,170 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef BLOCK_MATCHER_HPP
+#define BLOCK_MATCHER_HPP
+
+#include "HeapObject.hpp"
+#include "OwningPtr.hpp"
+#include "MemArray.hpp"
+#include "HashMap.hpp"
+#include "String.hpp"
+#include "TextData.hpp"
+#include "HilitedText.hpp"
+#include "HilitingBuffer.hpp"
+#include "LanguageModes.hpp"
+
+namespace LucED
+{
+
+/**
+ * Index of brackets and block keywords of a text buffer. 
+ *
+ * Brackets are matched in every language mode, block keywords are taken
+ * from the language mode fields 'blockBeginWords', 'blockMiddleWords' and
+ * 'blockEndWords'. A begin word may be given as "while:do", then the next
+ * "do" of this block is a middle element instead of beginning a new block.
+ * Elements within strings, comments and other syntax pattern regions are 
+ * ignored.
+ *
+ * Keywords and each kind of bracket are nested independently. End elements
+ * without open block, e.g. ')' of a shell case pattern, are ignored.
+ *
+ * The index is built lazily up to the position that is needed and is
+ * truncated at the first changed position if the text is modified.
+ */
+class BlockMatcher : public HeapObject
+{
+public:
+    typedef OwningPtr<BlockMatcher> Ptr;
+    
+    static Ptr create(HilitedText::Ptr hilitedText) {
+        return Ptr(new BlockMatcher(hilitedText));
+    }
+    
+    enum ElementType
+    {
+        BEGIN,
+        MIDDLE,
+        END
+    };
+    
+private:
+    enum 
+    {
+        KEYWORD_FAMILY        = 0,
+        BRACKET_FAMILY_OFFSET = 1,
+        NUMBER_OF_FAMILIES    = 4
+    };
+
+    struct State
+    {
+        int levels[NUMBER_OF_FAMILIES];
+        int continuationLevel;
+        int continuationWordId;
+    };
+
+public:
+    struct Element
+    {
+        long        beginPos;
+        long        endPos;
+        ElementType type;
+        int         family;
+        int         level;
+        State       stateAfter;
+    };
+    
+    HilitedText::Ptr getHilitedText() const {
+        return hilitedText;
+    }
+    
+    const Element& getElement(long index) const {
+        return elements[index];
+    }
+    
+    /**
+     * Returns index of element containing the text position or -1.
+     * If two elements are adjacent at this position, the element before
+     * is preferred if preferElementBefore is true.
+     */
+    long findElementAt(long pos, bool preferElementBefore);
+
+    /**
+     * Returns index of first element beginning at or after pos or -1.
+     */
+    long findNextElement(long pos);
+
+    /**
+     * Returns index of last element ending at or before pos or -1.
+     */
+    long findPrevElement(long pos);
+    
+    /**
+     * Returns index of the next middle or end element of the block 
+     * the element belongs to or -1.
+     */
+    long findNextElementOfBlock(long index);
+
+    /**
+     * Returns index of the previous begin or middle element of the block 
+     * the element belongs to or -1.
+     */
+    long findPrevElementOfBlock(long index);
+
+private:
+    BlockMatcher(HilitedText::Ptr hilitedText);
+    
+    bool extendIndex();
+    void extendIndexTo(long pos);
+    void truncateIndex(long pos);
+    void resetIndex();
+    
+    void appendElement(long beginPos, long endPos, ElementType type, int family);
+    bool isInsideRegion(long pos);
+    
+    void treatTextDataUpdate(TextData::UpdateInfo update);
+    void treatHilitingUpdate(HilitingBuffer::UpdateInfo update);
+    void treatTextStylesChanged(const ObjectArray<TextStyle::Ptr>& newTextStyles);
+    void treatLanguageModeChange(LanguageMode::Ptr newLanguageMode);
+    
+    void addWords(const String& words, ElementType type);
+    
+    HilitedText::Ptr        hilitedText;
+    TextData::Ptr           textData;
+    HilitingBuffer::Ptr     hilitingBuffer;
+    
+    MemArray<Element>       elements;
+    long                    indexedEndPos;
+    State                   state;
+    
+    HashMap<String,int>     words;
+    HashMap<String,int>     continuationWordIds;
+    ObjectArray<String>     continuationWords;
+    bool                    isWordBeginByte[256];
+    int                     maxWordLength;
+    
+    MemArray<bool>          isRegionStyle;
+};
+
+} // namespace LucED
+
+#endif // BLOCK_MATCHER_HPP
@@ -236,6 +236,21 @@ return
     
     
     
+    { name = "sortLines",                         description = "",
+                                                  classes = { "MultiLineEditActions" },
+    },
+    { name = "sortLinesNumerically",              description = "",
+                                                  classes = { "MultiLineEditActions" },
+    },
+    { name = "uniqueLines",                       description = "",
+                                                  classes = { "MultiLineEditActions" },
+    },
+    { name = "reverseLines",                      description = "",
+                                                  classes = { "MultiLineEditActions" },
+    },
+    
+    
+    
     { name = "findNextLuaStructureElement",       description = "",
                                                   classes = { "MultiLineEditActions" },
     },
@@ -245,6 +260,21 @@ return
     
     
     
+    { name = "addCursorBelow",                    description = "",
+                                                  classes = { "MultiLineEditActions" },
+    },
+    { name = "addCursorAbove",                    description = "",
+                                                  classes = { "MultiLineEditActions" },
+    },
+    { name = "addCursorsToSelectedLines",         description = "",
+                                                  classes = { "MultiLineEditActions" },
+    },
+    { name = "removeAdditionalCursors",           description = "",
+                                                  classes = { "MultiLineEditActions" },
+    },
+    
+    
+    
     { name = "historyBackward",                   description = "", 
                                                   classes     = {    "FindPanel::EditFieldActions",
                                                                   "ReplacePanel::EditFieldActions" },
@@ -378,6 +408,59 @@ return
                                                   classes     = { "EditorTopWinActions", },
     },
         
+    { name = "findSelectionInFiles",              description = "", 
+                                                  classes     = { "EditorTopWinActions", },
+    },
+        
+    { name = "cancelFindInFiles",                 description = "", 
+                                                  classes     = { "EditorTopWinActions", },
+    },
+        
+    { name = "gotoLocationAtCursor",              description = "", 
+                                                  classes     = { "EditorTopWinActions", },
+    },
+        
+    { name = "gotoDefinition",                    description = "", 
+                                                  classes     = { "EditorTopWinActions", },
+    },
+        
+    { name = "completeSymbol",                    description = "", 
+                                                  classes     = { "EditorTopWinActions", },
+    },
+        
+    { name = "highlightAllMatches",               description = "", 
+                                                  classes     = { "EditorTopWinActions", },
+    },
+        
+    { name = "showMemoryStatistics",              description = "", 
+                                                  classes     = { "EditorTopWinActions", },
+    },
+        
+    { name = "releaseMemory",                     description = "", 
+                                                  classes     = { "EditorTopWinActions", },
+    },
+        
+    { name = "toggleMacroRecording",              description = "", 
+                                                  classes     = { "EditorTopWinActions", },
+    },
+        
+    { name = "replayMacro",                       description = "", 
+                                                  classes     = { "EditorTopWinActions", },
+    },
+        
+    { name = "replayMacroToEndOfFile",            description = "", 
+                                                  classes     = { "EditorTopWinActions", },
+    },
+        
+    { name = "completeWord",                      description = "", 
+                                                  classes     = { "EditorTopWinActions", },
+    },
+        
+    -- handled by UserDefinedActionMethods
+    { name = "cancelAsyncActions",                description = "", 
+                                                  classes     = { },
+    },
+        
         
         
 }
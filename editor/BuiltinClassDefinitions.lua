@@ -46,6 +46,57 @@ return
                      },
                      { name = "bindActionKey"
                      },
+                     { name = "findInFiles"
+                     },
+                     { name = "getMemoryStatistics"
+                     },
+                     { name = "saveSession"
+                     },
+                     { name = "restoreSession"
+                     },
+                     
+                     -- functions for asynchronous actions, these are implemented in Lua
+                     -- because they yield the running coroutine
+                     
+                     { name        = "yield",
+                       luaFunction = [[
+                           function()
+                               if coroutine.running() then
+                                   coroutine.yield("yield")
+                               end
+                           end
+                       ]]
+                     },
+                     { name        = "sleep",
+                       luaFunction = [[
+                           function(seconds)
+                               if not coroutine.running() then
+                                   error("luced.sleep is only usable in asynchronous actions", 2)
+                               end
+                               coroutine.yield("sleep", seconds)
+                           end
+                       ]]
+                     },
+                     { name        = "execute",
+                       luaFunction = [[
+                           function(script, input)
+                               if not coroutine.running() then
+                                   error("luced.execute is only usable in asynchronous actions", 2)
+                               end
+                               return coroutine.yield("execute", script, input)
+                           end
+                       ]]
+                     },
+                     { name        = "readFile",
+                       luaFunction = [[
+                           function(fileName)
+                               if not coroutine.running() then
+                                   error("luced.readFile is only usable in asynchronous actions", 2)
+                               end
+                               return coroutine.yield("readFile", fileName)
+                           end
+                       ]]
+                     },
                    }
     },
     {
@@ -63,12 +114,41 @@ return
                      },
                      { name = "getMatchedBytes"
                      },
+                     { name = "getMatchedRange"
+                     },
                      { name = "remove"
                      },
                      { name = "replace"
                      },
                    }
     },
+    {
+        name     = "TextRange",
+        class    = "TextRangeLuaInterface",
+
+        ptrType  = "OwningPtr",
+        
+        methods  = {
+                     { name = "getBeginPos"
+                     },
+                     { name = "getEndPos"
+                     },
+                     { name = "getLength"
+                     },
+                     { name = "getBytes"
+                     },
+                     { name = "getSubRange"
+                     },
+                     { name = "lines"
+                     },
+                     { name = "chunks"
+                     },
+                     { name = "findMatch"
+                     },
+                     { name = "match"
+                     },
+                   }
+    },
     {
         name     = "View",
         class    = "ViewLuaInterface",
@@ -100,6 +180,8 @@ return
                      },
                      { name = "getBytes"
                      },
+                     { name = "getRange"
+                     },
                      { name = "insertAtCursor"
                      },
                      { name = "insert"
@@ -118,6 +200,8 @@ return
                      },
                      { name = "getSelection"
                      },
+                     { name = "getSelectionRange"
+                     },
                      { name = "replaceSelection"
                      },
                      { name = "releaseSelection"
@@ -126,10 +210,30 @@ return
                      },
                      { name = "remove"
                      },
+                     { name = "applyEdits"
+                     },
+                     { name = "transaction"
+                     },
+                     { name = "sortLines"
+                     },
+                     { name = "uniqueLines"
+                     },
+                     { name = "reverseLines"
+                     },
+                     { name = "filterLines"
+                     },
+                     { name = "findDefinitions"
+                     },
+                     { name = "findSymbolNames"
+                     },
                      { name = "assureCursorVisible"
                      },
                      { name = "setCurrentActionCategory"
                      },
+                     { name = "replayMacro"
+                     },
+                     { name = "findWords"
+                     },
                    }
     },
     {
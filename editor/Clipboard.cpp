@@ -100,9 +100,9 @@ Clipboard::Clipboard()
     guiWidget = GuiWidget::create(Null, this, Position(0,0,1,1));
     
     guiWidget->addToXEventMask(PropertyChangeMask);
-    x11AtomForClipboard = XInternAtom(GuiWidget::getDisplay(), "CLIPBOARD", False);
-    x11AtomForTargets   = XInternAtom(GuiWidget::getDisplay(), "TARGETS", False);
-    x11AtomForIncr      = XInternAtom(GuiWidget::getDisplay(), "INCR", False);
+    x11AtomForClipboard = GuiRoot::getInstance()->getX11Atom("CLIPBOARD");
+    x11AtomForTargets   = GuiRoot::getInstance()->getX11Atom("TARGETS");
+    x11AtomForIncr      = GuiRoot::getInstance()->getX11Atom("INCR");
     
     selectionOwner = SelectionOwner::create(guiWidget, 
                                             SelectionOwner::TYPE_CLIPBOARD, 
@@ -42,6 +42,7 @@ public:
           hasCloneDefaultConfigFlag(false),
           noServerFlag(false),
           hasQuitServerFlag(false),
+          hasRestoreSessionFlag(false),
           fileParameterList(HeapObjectArray<FileOpener::FileParameter>::create())
     {}
 
@@ -111,6 +112,10 @@ public:
                 {
                     hasQuitServerFlag = true;
                 }
+                else if (commandline->get(i) == "-rs" || commandline->get(i) == "--restore-session")
+                {
+                    hasRestoreSessionFlag = true;
+                }
                 else if (commandline->get(i) == "-ns" || commandline->get(i) == "--no-server")
                 {
                     noServerFlag = true;
@@ -152,6 +157,9 @@ public:
     bool hasQuitServer() const {
         return hasQuitServerFlag;
     }
+    bool hasRestoreSession() const {
+        return hasRestoreSessionFlag;
+    }
     
     bool hasNoServerFlag() const {
         return noServerFlag;
@@ -166,6 +174,7 @@ private:
     bool hasCloneDefaultConfigFlag;
     bool noServerFlag;
     bool hasQuitServerFlag;
+    bool hasRestoreSessionFlag;
     HeapObjectArray<FileOpener::FileParameter>::Ptr fileParameterList;
 };
 
@@ -77,6 +77,14 @@ return
                     type    = "String",
                     default = "rgb:f1/f1/f1",
                 },
+                {   name    = "matchHighlightColor",
+                    type    = "String",
+                    default = "rgb:ff/f0/b0",
+                },
+                {   name    = "additionalCursorColor",
+                    type    = "String",
+                    default = "rgb:a0/c0/ff",
+                },
                 {   name    = "initialWindowWidth",
                     type    = "int",
                     default = 100,
@@ -109,6 +117,14 @@ return
                     type    = "int",
                     default = 3000,
                 },
+                {   name    = "languageModeDetectionLength",
+                    type    = "long",
+                    default = 65536,
+                },
+                {   name    = "useEditJournal",
+                    type    = "bool",
+                    default = true,
+                },
                 {   name    = "boundCursor",
                     type    = "bool",
                     default = true,
@@ -276,6 +292,35 @@ return
                                 type    = "Nullable<bool>",
                                 default = nil,
                             },
+                            {   name    = "blockBeginWords",
+                                type    = "String",
+                                default = "",
+                            },
+                            {   name    = "blockMiddleWords",
+                                type    = "String",
+                                default = "",
+                            },
+                            {   name    = "blockEndWords",
+                                type    = "String",
+                                default = "",
+                            },
+                            {   name    = "definitionPatterns",
+                                type    = "list",
+                                member  =
+                                {
+                                    name    = "definitionPattern",
+                                    type    = "map",
+                                    entries =
+                                    {
+                                        {   name    = "kind",
+                                            type    = "String"
+                                        },
+                                        {   name    = "regex",
+                                            type    = "BasicRegex"
+                                        },
+                                    }
+                                }
+                            },
                         }
                     },
                     {   name    = "referer",
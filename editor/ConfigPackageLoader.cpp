@@ -19,10 +19,16 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////
 
+#include <stdio.h>
+#include <unistd.h>
+
 #include "ConfigPackageLoader.hpp"
 #include "DefaultConfig.hpp"
 #include "GlobalConfig.hpp"
 #include "File.hpp"
+#include "FileException.hpp"
+#include "LuaException.hpp"
+#include "ByteBuffer.hpp"
 
 using namespace LucED;
 
@@ -37,6 +43,85 @@ void ConfigPackageLoader::setConfigDir(const String& configDir)
 }
 
 
+/**
+ * Loads a Lua file from the config directory. The precompiled chunk is kept
+ * in the subdirectory ".bytecode" and is used as long as path, size and
+ * modification time of the source file are unchanged.
+ */
+LuaVar ConfigPackageLoader::loadConfigFile(LuaAccess     luaAccess,
+                                           const String& relativeFileName) const
+{
+    File   sourceFile(configDir, relativeFileName);
+    String cacheKey;
+    try
+    {
+        File::Info sourceInfo = sourceFile.getInfo();
+
+        if (!sourceInfo.exists() || !sourceInfo.isFile()) {
+            return LuaVar(luaAccess);
+        }
+        TimeStamp modifiedTime = sourceInfo.getLastModifiedTime();
+
+        cacheKey << "LucED bytecode\n"
+                 << sourceFile.getAbsoluteName()          << "\n"
+                 << sourceInfo.getFileSize()              << " "
+                 << (long) modifiedTime.getSeconds()      << " "
+                 << (long) modifiedTime.getMicroSeconds() << "\n";
+    }
+    catch (FileException& ex) {
+        return LuaVar(luaAccess);
+    }
+    File       cacheFile(String() << configDir << "/.bytecode", 
+                         String() << relativeFileName.toSubstitutedString('/', '%') << "c");
+    ByteBuffer buffer;
+    try
+    {
+        cacheFile.loadInto(&buffer);
+    }
+    catch (FileException& ex) {
+        buffer.clear();
+    }
+    if (   buffer.getLength() > cacheKey.getLength()
+        && memcmp(buffer.getPtr(0), cacheKey.toCString(), cacheKey.getLength()) == 0)
+    {
+        try
+        {
+            return luaAccess.loadBuffer((const char*) buffer.getPtr(cacheKey.getLength()),
+                                        buffer.getLength() - cacheKey.getLength(),
+                                        String() << "@" << sourceFile);
+        }
+        catch (LuaException& ex) {
+            // truncated or corrupt cache file: compile the source and write the cache again
+        }
+    }
+
+    LuaVar rslt = luaAccess.loadFile(sourceFile);
+    
+    if (rslt.isFunction())
+    {
+        buffer.clear();
+        buffer.appendString(cacheKey);
+        rslt.dumpFunction(&buffer);
+        // the cache file is replaced atomically, so that it is never read partially written
+
+        File tempFile(String() << cacheFile << ".tmp");
+        try
+        {
+            tempFile.getDir().createDirectory();
+            tempFile.storeData(&buffer);
+            
+            if (rename(tempFile.toString().toCString(), cacheFile.toString().toCString()) != 0) {
+                ::unlink(tempFile.toString().toCString());
+            }
+        }
+        catch (FileException& ex) {
+            // config directory is not writable: work without cache
+        }
+    }
+    return rslt;
+}
+
+
 LuaVar ConfigPackageLoader::loadPackageModule(LuaAccess     luaAccess,
                                               const String& moduleName) const
 {
@@ -46,10 +131,10 @@ LuaVar ConfigPackageLoader::loadPackageModule(LuaAccess     luaAccess,
     
     if (mode == MODE_NORMAL)
     {
-        rslt = luaAccess.loadFile(String() << configDir << "/" << moduleFileNamePart << ".lua");
+        rslt = loadConfigFile(luaAccess, String() << moduleFileNamePart << ".lua");
         
         if (rslt.isNil()) {
-            rslt = luaAccess.loadFile(String() << configDir << "/" << moduleFileNamePart << "/init.lua");
+            rslt = loadConfigFile(luaAccess, String() << moduleFileNamePart << "/init.lua");
         }
     }
     if (rslt.isNil())
@@ -77,9 +162,7 @@ LuaVar ConfigPackageLoader::loadGeneralConfigModule(LuaAccess     luaAccess,
 
     if (mode == MODE_NORMAL)
     {
-        File fileName(configDir, String() << moduleName << ".lua");
-        
-        rslt = luaAccess.loadFile(fileName);
+        rslt = loadConfigFile(luaAccess, String() << moduleName << ".lua");
     }
     else {
         String pseudoFileName = String() << moduleName << ".lua";
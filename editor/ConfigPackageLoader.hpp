@@ -41,6 +41,9 @@ public:
     void setMode(Mode mode) {
         this->mode = mode;
     }
+    Mode getMode() const {
+        return mode;
+    }
     
     void setConfigDir(const String& configDir);
     
@@ -51,6 +54,9 @@ public:
                                    const String& moduleName) const;
 
 private:
+    LuaVar loadConfigFile(LuaAccess     luaAccess,
+                          const String& relativeFileName) const;
+
     Mode mode;
     Nullable<String> configDir;
 };
@@ -0,0 +1,411 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <string.h>
+
+#include "DirectoryWalker.hpp"
+#include "EventDispatcher.hpp"
+#include "Seconds.hpp"
+#include "util.hpp"
+
+using namespace LucED;
+
+namespace // anonymous namespace
+{
+
+const long BINARY_CHECK_LENGTH        = 8 * 1024;
+
+const char* const IGNORED_DIRECTORIES[] = { ".git", ".svn", ".hg", ".bzr", "CVS", NULL };
+
+bool isIgnoredDirectory(const char* name)
+{
+    for (int i = 0; IGNORED_DIRECTORIES[i] != NULL; ++i) {
+        if (strcmp(name, IGNORED_DIRECTORIES[i]) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+
+#if LUCED_USE_MULTI_THREAD
+class DirectoryWalker::Worker : public Thread
+{
+public:
+    typedef LucED::OwningPtr<Worker> Ptr;
+    
+    static Ptr create(RawPtr<DirectoryWalker> walker) {
+        return Ptr(new Worker(walker));
+    }
+protected:
+    virtual void main() {
+        walker->workerMain();
+    }
+private:
+    Worker(RawPtr<DirectoryWalker> walker)
+        : walker(walker)
+    {}
+    RawPtr<DirectoryWalker> walker;
+};
+#endif // LUCED_USE_MULTI_THREAD
+
+
+DirectoryWalker::MappedFile::MappedFile(const String& fileName, long maxLength)
+    : buffer(NULL),
+      length(0),
+      modificationTime(0)
+{
+    int fd = open(fileName.toCString(), O_RDONLY);
+    
+    if (fd < 0) {
+        return;
+    }
+    struct stat statInfo;
+    
+    if (fstat(fd, &statInfo) == 0 && S_ISREG(statInfo.st_mode) 
+                                  && statInfo.st_size > 0 && statInfo.st_size <= maxLength)
+    {
+        void* mapped = mmap(NULL, statInfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        
+        if (mapped != MAP_FAILED) {
+            buffer           = (const char*) mapped;
+            length           = statInfo.st_size;
+            modificationTime = statInfo.st_mtime;
+        }
+    }
+    close(fd);
+}
+
+
+DirectoryWalker::MappedFile::~MappedFile()
+{
+    if (buffer != NULL) {
+        munmap((void*) buffer, length);
+    }
+}
+
+
+bool DirectoryWalker::MappedFile::isBinary() const
+{
+    return memchr(buffer, '\0', util::minimum(length, BINARY_CHECK_LENGTH)) != NULL;
+}
+
+
+bool DirectoryWalker::isInDirectory(const String& fileName, const String& directory)
+{
+    return    fileName.getLength() > directory.getLength()
+           && fileName.startsWith(directory)
+           && (   fileName[directory.getLength()] == '/'
+               || directory.getLength() == 0
+               || directory[directory.getLength() - 1] == '/');
+}
+
+
+DirectoryWalker::DirectoryWalker(int maxWorkers, MicroSeconds updateInterval)
+    : mutex(Mutex::create()),
+      maxWorkers(maxWorkers),
+      updateInterval(updateInterval),
+      walkingFlag(false),
+      numberOfBusyWorkers(0),
+      numberOfFinishedWorkers(0),
+      cancelledFlag(false)
+{}
+
+
+DirectoryWalker::~DirectoryWalker()
+{
+    stopWalk();
+}
+
+
+void DirectoryWalker::startWalk(const ObjectArray<String>& directories)
+{
+    ASSERT(!walkingFlag);
+
+    entries.clear();
+
+    for (int i = 0; i < directories.getLength(); ++i) {
+        entries.append(Entry(directories[i], true));
+    }
+    numberOfBusyWorkers     = 0;
+    numberOfFinishedWorkers = 0;
+    cancelledFlag           = false;
+    walkingFlag             = true;
+    
+    startWorkers();
+}
+
+
+void DirectoryWalker::startWorkers()
+{
+#if LUCED_USE_MULTI_THREAD
+    workers.clear();
+
+    long numberOfWorkers = 2;
+#  ifdef _SC_NPROCESSORS_ONLN
+    numberOfWorkers = util::maximum(1L, util::minimum((long) sysconf(_SC_NPROCESSORS_ONLN), 
+                                                      (long) maxWorkers));
+#  endif
+    for (int i = 0; i < numberOfWorkers; ++i)
+    {
+        Worker::Ptr worker = Worker::create(this);
+        try {
+            Thread::start(worker);
+            workers.append(worker);
+        }
+        catch (SystemException&) {
+            break;
+        }
+    }
+    if (workers.getLength() > 0) {
+        EventDispatcher::getInstance()->registerTimerCallback(Seconds(0), updateInterval,
+                                                              newCallback(this, &DirectoryWalker::handleTimer));
+        return;
+    }
+#endif
+    processHandler = ProcessHandler::create(this, &DirectoryWalker::process,
+                                                  &DirectoryWalker::needsProcessing);
+    EventDispatcher::getInstance()->registerProcess(processHandler);
+}
+
+
+void DirectoryWalker::cancelWalk()
+{
+    if (walkingFlag)
+    {
+        {
+            Mutex::Lock lock(mutex);
+            cancelledFlag = true;
+            lock.notifyAll();
+        }
+    #if LUCED_USE_MULTI_THREAD
+        if (workers.getLength() > 0) {
+            return;
+        }
+    #endif
+        finishWalk();
+    }
+}
+
+
+void DirectoryWalker::stopWalk()
+{
+    {
+        Mutex::Lock lock(mutex);
+        cancelledFlag = true;
+        lock.notifyAll();
+    }
+    joinWorkers();
+}
+
+
+void DirectoryWalker::joinWorkers()
+{
+#if LUCED_USE_MULTI_THREAD
+    for (int i = 0; i < workers.getLength(); ++i) {
+        workers[i]->waitForFinished();
+    }
+    workers.clear();
+#endif
+    walkingFlag = false;
+
+    if (processHandler.isValid()) {
+        processHandler->disable();
+    }
+}
+
+
+bool DirectoryWalker::isWalkCancelled()
+{
+    Mutex::Lock lock(mutex);
+    return cancelledFlag;
+}
+
+
+bool DirectoryWalker::takeEntry(Entry* entry, bool waitForEntry)
+{
+    Mutex::Lock lock(mutex);
+    
+    while (waitForEntry && !cancelledFlag && entries.getLength() == 0 && numberOfBusyWorkers > 0) {
+        lock.waitForNotify();
+    }
+    if (cancelledFlag || entries.getLength() == 0) {
+        lock.notifyAll();
+        return false;
+    }
+    *entry = entries.getLast();
+    entries.removeLast();
+    ++numberOfBusyWorkers;
+    
+    return true;
+}
+
+
+void DirectoryWalker::processEntry(const Entry& entry)
+{
+    if (entry.isDirectory) {
+        processDirectory(entry.path);
+    } else {
+        processFile(entry.path, entry.modificationTime, entry.fileSize);
+    }
+    Mutex::Lock lock(mutex);
+    
+    --numberOfBusyWorkers;
+    
+    if (numberOfBusyWorkers == 0 && entries.getLength() == 0) {
+        lock.notifyAll();
+    }
+}
+
+
+void DirectoryWalker::workerMain()
+{
+    Entry entry;
+    
+    while (takeEntry(&entry, true)) {
+        processEntry(entry);
+    }
+    Mutex::Lock lock(mutex);
+    ++numberOfFinishedWorkers;
+}
+
+
+void DirectoryWalker::processDirectory(const String& path)
+{
+    DIR* dir = opendir(path.toCString());
+    
+    if (dir == NULL) {
+        return;
+    }
+    ObjectArray<Entry> newEntries;
+    struct dirent*     dirent;
+    
+    while ((dirent = readdir(dir)) != NULL)
+    {
+        const char* name = dirent->d_name;
+        
+        if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) {
+            continue;
+        }
+        String      fileName = String() << path << "/" << name;
+        struct stat statInfo;
+
+        // lstat: symbolic links are not followed to avoid cycles
+
+        if (lstat(fileName.toCString(), &statInfo) != 0) {
+            continue;
+        }
+        if (S_ISDIR(statInfo.st_mode)) {
+            if (!isIgnoredDirectory(name)) {
+                newEntries.append(Entry(fileName, true));
+            }
+        }
+        else if (S_ISREG(statInfo.st_mode) && shouldProcessFile(fileName, statInfo.st_size)) {
+            newEntries.append(Entry(fileName, false, statInfo.st_mtime, statInfo.st_size));
+        }
+    }
+    closedir(dir);
+    
+    if (newEntries.getLength() > 0)
+    {
+        Mutex::Lock lock(mutex);
+        
+        for (int i = 0; i < newEntries.getLength(); ++i) {
+            entries.append(newEntries[i]);
+        }
+        lock.notifyAll();
+    }
+}
+
+
+bool DirectoryWalker::needsProcessing()
+{
+    return walkingFlag;
+}
+
+
+int DirectoryWalker::process(TimeStamp endTime)
+{
+    Entry entry;
+    
+    if (!processInMainThread(endTime)) {
+        handleWalkProgress();
+        return 0;
+    }
+    do
+    {
+        if (!takeEntry(&entry, false)) {
+            finishWalk();
+            return 0;
+        }
+        processEntry(entry);
+    }
+    while (TimeStamp::now() < endTime);
+
+    handleWalkProgress();
+
+    return 0;
+}
+
+
+void DirectoryWalker::handleTimer()
+{
+    if (!walkingFlag) {
+        return;
+    }
+    bool allProcessed = processInMainThread(TimeStamp::now() + MicroSeconds(updateInterval / 2));
+    bool allWorkersFinished;
+    {
+        Mutex::Lock lock(mutex);
+    #if LUCED_USE_MULTI_THREAD
+        allWorkersFinished = (numberOfFinishedWorkers == workers.getLength());
+    #else
+        allWorkersFinished = true;
+    #endif
+    }
+    if (allProcessed && allWorkersFinished) {
+        finishWalk();
+    }
+    else {
+        handleWalkProgress();
+        
+        EventDispatcher::getInstance()->registerTimerCallback(Seconds(0), updateInterval,
+                                                              newCallback(this, &DirectoryWalker::handleTimer));
+    }
+}
+
+
+void DirectoryWalker::finishWalk()
+{
+    if (!walkingFlag) {
+        return;
+    }
+    joinWorkers();
+    handleWalkFinished();
+}
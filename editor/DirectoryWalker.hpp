@@ -0,0 +1,192 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DIRECTORY_WALKER_HPP
+#define DIRECTORY_WALKER_HPP
+
+#include "config.h"
+
+#include "RunningComponent.hpp"
+#include "OwningPtr.hpp"
+#include "RawPtr.hpp"
+#include "ObjectArray.hpp"
+#include "String.hpp"
+#include "Mutex.hpp"
+#include "Thread.hpp"
+#include "TimeStamp.hpp"
+#include "MicroSeconds.hpp"
+#include "ProcessHandler.hpp"
+
+namespace LucED
+{
+
+/**
+ * Walks all files below some directories. 
+ *
+ * The directories are read and the files are processed by a pool of
+ * worker threads, without LUCED_USE_MULTI_THREAD in process slices of 
+ * the EventDispatcher. Symbolic links are not followed and version 
+ * control directories are skipped. 
+ *
+ * Derived classes decide which files are processed and collect their
+ * results under the protected mutex. The results are taken over in 
+ * the main thread by handleWalkProgress() in regular intervals.
+ * Derived destructors must call stopWalk() before their members are
+ * destroyed, because the workers call the virtual methods.
+ */
+class DirectoryWalker : public RunningComponent
+{
+public:
+    /**
+     * Maps a file read only into memory. The length is taken from
+     * the open file, so that a file changed after it was found 
+     * in the directory cannot be mapped beyond its end.
+     */
+    class MappedFile
+    {
+    public:
+        MappedFile(const String& fileName, long maxLength);
+        ~MappedFile();
+        
+        bool isValid() const {
+            return buffer != NULL;
+        }
+        const char* getBuffer() const {
+            return buffer;
+        }
+        long getLength() const {
+            return length;
+        }
+        long getModificationTime() const {
+            return modificationTime;
+        }
+        /**
+         * Like grep files with null bytes at the beginning are treated as binary.
+         */
+        bool isBinary() const;
+        
+    private:
+        MappedFile(const MappedFile& src);
+        MappedFile& operator=(const MappedFile& src);
+
+        const char* buffer;
+        long        length;
+        long        modificationTime;
+    };
+    
+    static bool isInDirectory(const String& fileName, const String& directory);
+
+    ~DirectoryWalker();
+    
+    bool isWalking() const {
+        return walkingFlag;
+    }
+    
+protected:
+    DirectoryWalker(int maxWorkers, MicroSeconds updateInterval);
+    
+    void startWalk(const ObjectArray<String>& directories);
+    
+    /**
+     * Does not wait for the workers: they stop after their current
+     * file and handleWalkFinished() is called afterwards.
+     */
+    void cancelWalk();
+    
+    /**
+     * Cancels the walk and waits for the workers.
+     */
+    void stopWalk();
+    
+    /**
+     * May be called concurrently.
+     */
+    bool isWalkCancelled();
+    
+    /**
+     * Called in the worker threads for each regular file found in
+     * the directories.
+     */
+    virtual bool shouldProcessFile(const String& fileName, long fileSize) = 0;
+    virtual void processFile(const String& fileName, long modificationTime, long fileSize) = 0;
+    
+    /**
+     * Called in the main thread between the result updates for work 
+     * that cannot be done in the workers. Returns true if nothing 
+     * is left to do.
+     */
+    virtual bool processInMainThread(TimeStamp endTime) {
+        return true;
+    }
+    virtual void handleWalkProgress() = 0;
+    virtual void handleWalkFinished() = 0;
+
+    Mutex::Ptr                       mutex;
+    
+private:
+    class Entry
+    {
+    public:
+        Entry()
+        {}
+        Entry(const String& path, bool isDirectory, long modificationTime = 0, long fileSize = 0)
+            : path(path), isDirectory(isDirectory), modificationTime(modificationTime), fileSize(fileSize)
+        {}
+        String path;
+        bool   isDirectory;
+        long   modificationTime;
+        long   fileSize;
+    };
+    
+    class Worker;
+    
+    void startWorkers();
+    bool takeEntry(Entry* entry, bool waitForEntry);
+    void processEntry(const Entry& entry);
+    void processDirectory(const String& path);
+    void workerMain();
+    void joinWorkers();
+    
+    bool needsProcessing();
+    int  process(TimeStamp endTime);
+    void handleTimer();
+    void finishWalk();
+
+    int                              maxWorkers;
+    MicroSeconds                     updateInterval;
+    bool                             walkingFlag;
+    ProcessHandler::Ptr              processHandler;
+    
+    // following members are protected by mutex
+    
+    ObjectArray<Entry>               entries;
+    int                              numberOfBusyWorkers;
+    int                              numberOfFinishedWorkers;
+    bool                             cancelledFlag;
+
+#if LUCED_USE_MULTI_THREAD
+    ObjectArray< LucED::OwningPtr<Worker> > workers;
+#endif
+};
+
+} // namespace LucED
+
+#endif // DIRECTORY_WALKER_HPP
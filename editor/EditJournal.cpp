@@ -0,0 +1,395 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "EditJournal.hpp"
+#include "EventDispatcher.hpp"
+#include "GlobalConfig.hpp"
+#include "FileException.hpp"
+#include "Seconds.hpp"
+#include "MicroSeconds.hpp"
+#include "util.hpp"
+
+using namespace LucED;
+
+
+namespace // anonymous namespace
+{
+
+/**
+ * Records are collected for this time before they are written and
+ * synced, so that typing does not cause an fsync per keystroke.
+ */
+const long SYNC_DELAY_MICRO_SECS = 1000 * 1000;
+
+/**
+ * Pending records beyond this size are written immediately, they are
+ * synced with the next timer.
+ */
+const long MAX_PENDING_BYTES     = 1024 * 1024;
+
+const char* const JOURNAL_FILE_HEADER = "LucED edit journal 1\n";
+
+/**
+ * The base name of the file is shortened to this length in the
+ * name of the journal file.
+ */
+const long MAX_BASE_NAME_LENGTH  = 64;
+
+// 64 bit FNV-1a hash of the absolute file name
+
+const unsigned long long FNV_OFFSET_BASIS = 14695981039346656037ULL;
+const unsigned long long FNV_PRIME        = 1099511628211ULL;
+
+} // anonymous namespace
+
+
+bool EditJournal::isEnabled()
+{
+    return GlobalConfig::getConfigData()->getGeneralConfig()->getUseEditJournal();
+}
+
+
+/**
+ * The journal file is named by the base name of the file and a hash of 
+ * the absolute name, so that its length does not depend on the length 
+ * of the path. The header of the journal contains the absolute name.
+ */
+String EditJournal::getJournalFileName(const String& fileName)
+{
+    String             absoluteName = File(fileName).getAbsoluteName();
+    String             baseName     = File(absoluteName).getBaseName();
+    unsigned long long hash         = FNV_OFFSET_BASIS;
+    
+    for (long i = 0; i < absoluteName.getLength(); ++i) {
+        hash = (hash ^ (unsigned char) absoluteName[i]) * FNV_PRIME;
+    }
+    long baseLength = util::minimum((long) baseName.getLength(), MAX_BASE_NAME_LENGTH);
+    
+    while (baseLength < baseName.getLength() && ((unsigned char) baseName[baseLength] & 0xC0) == 0x80) {
+        --baseLength; // do not cut UTF-8 sequences
+    }
+    char hashString[20];
+    sprintf(hashString, "%016llx", hash);
+    
+    return File(String() << GlobalConfig::getInstance()->getConfigDirectory() << "/.journal",
+                String() << baseName.getHead(baseLength) << "-" << hashString);
+}
+
+
+/**
+ * Format: header line, file name line and a line "B <seconds> 
+ * <microSeconds> <fileSize> <bufferLength>" describing the unmodified
+ * file. The records follow as "I <pos> <length>" with the inserted
+ * bytes directly after the newline or as "R <pos> <length>".
+ */
+String EditJournal::getHeader(const String& fileName, const File::Info& fileInfo, long bufferLength)
+{
+    String rslt = String() << JOURNAL_FILE_HEADER << File(fileName).getAbsoluteName() << "\n";
+    
+    if (fileInfo.exists()) {
+        TimeStamp t = fileInfo.getLastModifiedTime();
+        rslt << "B " << (long) t.getSeconds() 
+             << " "  << (long) t.getMicroSeconds() 
+             << " "  << fileInfo.getFileSize()
+             << " "  << bufferLength << "\n";
+    } else {
+        rslt << "B -1 0 0 " << bufferLength << "\n";
+    }
+    return rslt;
+}
+
+
+EditJournal::EditJournal(const String& journalFileName)
+    : journalFileName(journalFileName),
+      fd(-1),
+      failedFlag(false),
+      isSyncTimerRegistered(false),
+      needsSyncFlag(false),
+      syncTimerCallback(newCallback(this, &EditJournal::handleSyncTimer)),
+      isRecoveringFlag(false),
+      recoveryPos(0),
+      recoveryTextLength(0)
+{}
+
+
+EditJournal::~EditJournal()
+{
+    // the journal file is kept: the editor could be terminating 
+    // without the user having saved or discarded the changes
+    flush();
+    if (fd != -1) {
+        close(fd);
+    }
+}
+
+
+EditJournal::Ptr EditJournal::create(const String& fileName, const File::Info& fileInfo, long bufferLength)
+{
+    Ptr rslt(new EditJournal(getJournalFileName(fileName)));
+    
+    rslt->open(O_CREAT|O_WRONLY|O_TRUNC);
+    rslt->pendingData.appendString(getHeader(fileName, fileInfo, bufferLength));
+    
+    return rslt;
+}
+
+
+EditJournal::Ptr EditJournal::createForRecovery(const String& fileName, const File::Info& fileInfo, long bufferLength)
+{
+    Ptr rslt(new EditJournal(getJournalFileName(fileName)));
+    
+    if (!File(rslt->journalFileName).exists()) {
+        return Ptr();
+    }
+    try
+    {
+        File(rslt->journalFileName).loadInto(&rslt->recoveryData);
+    }
+    catch (FileException& ex) {
+        return Ptr();
+    }
+    String header = getHeader(fileName, fileInfo, bufferLength);
+    
+    if (   rslt->recoveryData.getLength() <= header.getLength()
+        || memcmp(rslt->recoveryData.getPtr(0), header.toCString(), header.getLength()) != 0)
+    {
+        return Ptr(); // journal belongs to another state of the file
+    }
+    rslt->isRecoveringFlag   = true;
+    rslt->recoveryPos        = header.getLength();
+    rslt->recoveryTextLength = bufferLength;
+    
+    return rslt;
+}
+
+
+/**
+ * Returns false at the end of the journal or at the first incomplete
+ * or inconsistent record, e.g. if the editor died while writing it.
+ */
+bool EditJournal::getNextRecoveredRecord(Record* record)
+{
+    ASSERT(isRecoveringFlag);
+
+    const char* data   = (const char*) recoveryData.getPtr(0);
+    long        length = recoveryData.getLength();
+    
+    if (recoveryPos >= length) {
+        return false;
+    }
+    const char* nl = (const char*) memchr(data + recoveryPos, '\n', length - recoveryPos);
+    
+    if (nl == NULL || nl - data < recoveryPos + 2 || data[recoveryPos + 1] != ' ') {
+        return false;
+    }
+    char  type = data[recoveryPos];
+    char* p;
+    long  pos  = strtol(data + recoveryPos + 2, &p, 10);
+    long  len  = strtol(p, &p, 10);
+    
+    if (p != nl || pos < 0 || len <= 0 || pos > recoveryTextLength) {
+        return false;
+    }
+    long dataPos = (nl - data) + 1;
+    
+    if (type == 'I' && dataPos + len <= length)
+    {
+        record->type        = INSERT_RECORD;
+        record->data        = (const byte*) data + dataPos;
+        recoveryPos         = dataPos + len;
+        recoveryTextLength += len;
+    }
+    else if (type == 'R' && pos + len <= recoveryTextLength)
+    {
+        record->type        = REMOVE_RECORD;
+        record->data        = NULL;
+        recoveryPos         = dataPos;
+        recoveryTextLength -= len;
+    }
+    else {
+        return false;
+    }
+    record->pos    = pos;
+    record->length = len;
+    
+    return true;
+}
+
+
+void EditJournal::finishRecovery()
+{
+    ASSERT(isRecoveringFlag);
+    
+    isRecoveringFlag = false;
+
+    open(O_WRONLY);
+    
+    if (!failedFlag)
+    {
+        // cut off an incomplete record, new records are appended
+        // to the recovered ones
+        if (ftruncate(fd, recoveryPos) == -1 || lseek(fd, 0, SEEK_END) == -1) {
+            handleWriteError();
+        }
+    }
+    recoveryData.clear();
+    recoveryData.compact(true);
+}
+
+
+void EditJournal::open(int flags)
+{
+    try
+    {
+        File(journalFileName).getDir().createDirectory();
+    }
+    catch (FileException& ex) {
+        failedFlag = true; // config directory is not writable: no journal
+        return;
+    }
+    fd = ::open(journalFileName.toCString(), flags, S_IRUSR|S_IWUSR);
+
+    if (fd == -1) {
+        failedFlag = true;
+    }
+}
+
+
+void EditJournal::appendRecordHeader(char type, long pos, long length)
+{
+    pendingData.appendString(String() << type << " " << pos << " " << length << "\n");
+}
+
+
+void EditJournal::rememberInsert(long pos, const byte* data, long length)
+{
+    if (isRecoveringFlag || failedFlag) {
+        return;
+    }
+    appendRecordHeader('I', pos, length);
+    pendingData.append(data, length);
+
+    if (pendingData.getLength() >= MAX_PENDING_BYTES) {
+        writePendingData();
+    }
+    if (!isSyncTimerRegistered) {
+        EventDispatcher::getInstance()->registerTimerCallback(Seconds(0), MicroSeconds(SYNC_DELAY_MICRO_SECS),
+                                                              syncTimerCallback);
+        isSyncTimerRegistered = true;
+    }
+}
+
+
+void EditJournal::rememberRemove(long pos, long length)
+{
+    if (isRecoveringFlag || failedFlag) {
+        return;
+    }
+    appendRecordHeader('R', pos, length);
+
+    if (!isSyncTimerRegistered) {
+        EventDispatcher::getInstance()->registerTimerCallback(Seconds(0), MicroSeconds(SYNC_DELAY_MICRO_SECS),
+                                                              syncTimerCallback);
+        isSyncTimerRegistered = true;
+    }
+}
+
+
+void EditJournal::handleSyncTimer()
+{
+    isSyncTimerRegistered = false;
+    flush();
+}
+
+
+void EditJournal::writePendingData()
+{
+    long length = pendingData.getLength();
+    
+    if (length == 0) {
+        return;
+    }
+    const byte* data = pendingData.getPtr(0);
+    long        pos  = 0;
+    
+    while (!failedFlag && pos < length)
+    {
+        ssize_t written = ::write(fd, data + pos, length - pos);
+        
+        if (written > 0) {
+            pos += written;
+        } 
+        else if (written == -1 && errno != EINTR) {
+            handleWriteError();
+        }
+    }
+    needsSyncFlag = true;
+    pendingData.clear();
+    pendingData.compact();
+}
+
+
+void EditJournal::flush()
+{
+    writePendingData();
+    
+    if (needsSyncFlag && !failedFlag)
+    {
+        if (fsync(fd) == -1) {
+            handleWriteError();
+        }
+    }
+    needsSyncFlag = false;
+}
+
+
+/**
+ * An incomplete journal would give a wrong recovery result, 
+ * so it is removed and no further records are written.
+ */
+void EditJournal::handleWriteError()
+{
+    discard();
+}
+
+
+void EditJournal::discard()
+{
+    if (fd != -1) {
+        close(fd);
+        fd = -1;
+    }
+    unlink(journalFileName.toCString());
+
+    failedFlag    = true;
+    needsSyncFlag = false;
+    pendingData.clear();
+}
+
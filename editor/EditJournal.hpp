@@ -0,0 +1,121 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef EDIT_JOURNAL_HPP
+#define EDIT_JOURNAL_HPP
+
+#include "String.hpp"
+#include "HeapObject.hpp"
+#include "OwningPtr.hpp"
+#include "ByteBuffer.hpp"
+#include "Callback.hpp"
+#include "File.hpp"
+
+namespace LucED
+{
+
+/**
+ * Append-only log of the changes of a modified TextData. The records
+ * are written to a file below the config directory and synced to disk
+ * in batches. If the editor dies before the buffer is saved, the
+ * changes can be replayed onto the unchanged file on disk.
+ */
+class EditJournal : public HeapObject
+{
+public:
+    typedef OwningPtr<EditJournal> Ptr;
+    
+    enum RecordType {
+        INSERT_RECORD,
+        REMOVE_RECORD
+    };
+    
+    class Record
+    {
+    public:
+        RecordType  type;
+        long        pos;
+        long        length;
+        const byte* data;
+    };
+
+    static bool isEnabled();
+    
+    /**
+     * Starts a new journal for the given file. fileInfo and bufferLength
+     * describe the unmodified state the records are based on.
+     */
+    static Ptr create(const String& fileName, const File::Info& fileInfo, long bufferLength);
+    
+    /**
+     * Opens an existing journal, if it matches the given state of the
+     * file. Records are then fetched with getNextRecoveredRecord(),
+     * until finishRecovery() continues the journal for new records.
+     */
+    static Ptr createForRecovery(const String& fileName, const File::Info& fileInfo, long bufferLength);
+
+    ~EditJournal();
+
+    bool getNextRecoveredRecord(Record* record);
+    void finishRecovery();
+    
+    void rememberInsert(long pos, const byte* data, long length);
+    void rememberRemove(long pos, long length);
+
+    /**
+     * Writes pending records and syncs them to disk.
+     */
+    void flush();
+    
+    /**
+     * Removes the journal file, e.g. because the buffer was saved.
+     */
+    void discard();
+
+private:
+    explicit EditJournal(const String& journalFileName);
+
+    static String getJournalFileName(const String& fileName);
+    static String getHeader(const String& fileName, const File::Info& fileInfo, long bufferLength);
+    
+    void open(int flags);
+    void writePendingData();
+    void appendRecordHeader(char type, long pos, long length);
+    void handleSyncTimer();
+    void handleWriteError();
+    
+    String          journalFileName;
+    int             fd;
+    bool            failedFlag;
+    bool            isSyncTimerRegistered;
+    bool            needsSyncFlag;
+    ByteBuffer      pendingData;
+    Callback<>::Ptr syncTimerCallback;
+
+    bool            isRecoveringFlag;
+    ByteBuffer      recoveryData;
+    long            recoveryPos;
+    long            recoveryTextLength;
+};
+
+} // namespace LucED
+
+#endif // EDIT_JOURNAL_HPP
@@ -375,6 +375,22 @@ public:
         }
         return sectionHolder;
     }
+    
+    long getNumberOfActions() const {
+        return actions.getLength();
+    }
+    long getHistoryDataLength() const {
+        return historyData.getLength();
+    }
+    long getAllocatedBytes() const {
+        return actions.getCapacityInBytes() + historyData.getCapacityInBytes();
+    }
+    bool needsCompaction() const {
+        return actions.needsCompaction() || historyData.needsCompaction();
+    }
+    long compact(bool releaseAll = false) {
+        return actions.compact(releaseAll) + historyData.compact(releaseAll);
+    }
 
 private:
 
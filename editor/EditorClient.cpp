@@ -23,6 +23,7 @@
 #include "GuiRootProperty.hpp"
 #include "ClientServerUtil.hpp"
 #include "CommandlineInterpreter.hpp"
+#include "SessionSnapshot.hpp"
 #include "EventDispatcher.hpp"
 #include "DefaultConfig.hpp"
 #include "ProgramName.hpp"
@@ -120,6 +121,9 @@ void EditorClient::startWithCommandline(Commandline::Ptr commandline)
         {
             GuiRoot::getInstance()->setInstanceName(instanceName);
             GlobalConfig::getInstance()->readConfig();
+            if (commandInterpreter.hasRestoreSession()) {
+                SessionSnapshot::restore();
+            }
             FileOpener::start(commandInterpreter.getFileParameterList());
             isServerStartupNeededFlag = false;
             wasFileOpenerStarted = true;
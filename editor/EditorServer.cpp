@@ -35,6 +35,7 @@
 #include "FileOpener.hpp"
 #include "ConfigErrorHandler.hpp"
 #include "WindowCloser.hpp"
+#include "SessionSnapshot.hpp"
 #include "LuaException.hpp"
 
 using namespace LucED;
@@ -188,6 +189,9 @@ void EditorServer::processCommandline(Commandline::Ptr commandline,
         else
         {
             try {
+                if (commandInterpreter.hasRestoreSession()) {
+                    SessionSnapshot::restore();
+                }
                 FileOpener::start(commandInterpreter.getFileParameterList());
             }
             catch (LuaException& ex) {
@@ -198,6 +202,12 @@ void EditorServer::processCommandline(Commandline::Ptr commandline,
             }
         }
         if (commandInterpreter.hasQuitServer()) {
+            try {
+                SessionSnapshot::save();
+            }
+            catch (FileException& ex) {
+                // config directory is not writable: quit without session
+            }
             WindowCloser::start();
         }
     }
@@ -52,6 +52,7 @@
 #include "EncodingConverter.hpp"
 #include "LuaErrorHandler.hpp"
 #include "UserDefinedActionMethods.hpp"
+#include "WordIndex.hpp"
 
 using namespace LucED;
 
@@ -168,6 +169,7 @@ public:
         String untitledFileName = File(String() << editorTopWin->textData->getFileName()).getDirName() << "/Untitled";
         TextData::Ptr     emptyTextData     = TextData::create();
                           emptyTextData->setPseudoFileName(untitledFileName);
+                          emptyTextData->enableJournal();
      
         HilitedText::Ptr  hilitedText  = HilitedText::create(emptyTextData, languageMode);
      
@@ -188,6 +190,15 @@ public:
         newWin->show();
     }
     
+    virtual void setStatusMessage(const String& message)
+    {
+        if (message.getLength() > 0) {
+            editorTopWin->statusLine->setMessage(message);
+        } else {
+            editorTopWin->statusLine->clearMessage();
+        }
+    }
+    
 private:
     ActionInterface(RawPtr<EditorTopWin> editorTopWin)
         : editorTopWin(editorTopWin)
@@ -250,7 +261,7 @@ EditorTopWin::EditorTopWin(HilitedText::Ptr hilitedText, int width, int height)
     int statusLineIndex = rootElement->addElement(statusLine);
     upperPanelIndex = statusLineIndex + 1;
     
-    textEditor = MultiLineEditorWidget::create(hilitedText);
+    textEditor = MultiLineEditorWidget::create(hilitedText, TextWidget::CreateOptions() | TextWidget::RECORD_KEYBOARD_MACRO);
 
     textEditor->setVerticalAdjustmentStrategy(TextWidget::STRICT_TOP_LINE_ANCHOR);
 
@@ -274,6 +285,8 @@ EditorTopWin::EditorTopWin(HilitedText::Ptr hilitedText, int width, int height)
 
     textEditor->registerCursorPositionDataListener(newCallback(statusLine, &StatusLine::setCursorPositionData));
     
+    WordIndex::getInstance()->registerTextData(textData);
+    
     textEditor->setDesiredMeasuresInChars(
             GlobalConfig::getConfigData()->getGeneralConfig()->getInitialWindowWidth(),
             GlobalConfig::getConfigData()->getGeneralConfig()->getInitialWindowHeight()
@@ -311,7 +324,8 @@ EditorTopWin::EditorTopWin(HilitedText::Ptr hilitedText, int width, int height)
                                               newCallback(this, &EditorTopWin::handleCatchedException))));
 
     UserDefinedActionMethods::Ptr userActions = UserDefinedActionMethods::create(textEditor,
-                                                                                 ShellInvocationHandler::create(this));
+                                                                                 ShellInvocationHandler::create(this),
+                                                                                 newCallback(this, &EditorTopWin::handleCatchedException));
     textEditor->getKeyActionHandler()->addActionMethods(userActions);
 }
 
@@ -324,6 +338,18 @@ void EditorTopWin::processGuiWidgetCreatedEvent()
 }
 
 
+void EditorTopWin::notifyAboutBeingMapped()
+{
+    if (firstMappedCallback.isValid())
+    {
+        Callback<>::Ptr callback = firstMappedCallback;
+        firstMappedCallback.invalidate();
+        
+        callback->call();
+    }
+}
+
+
 EditorTopWin::~EditorTopWin()
 {
     ViewCounterTextDataAccess::decViewCounter(textData);
@@ -865,12 +891,16 @@ void EditorTopWin::requestCloseWindow(TopWin::CloseReason reason)
     }
     else
     {
+        if (ViewCounterTextDataAccess::getViewCounter(textData) == 1) {
+            textData->discardJournal();
+        }
         TopWin::requestCloseWindow(reason);
     }
 }
 
 void EditorTopWin::requestCloseWindowAndDiscardChanges()
 {
+    textData->discardJournal();
     TopWin::requestCloseWindow(TopWin::CLOSED_SILENTLY);
 }
 
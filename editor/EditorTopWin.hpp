@@ -107,10 +107,19 @@ public:
         textEditor->displayCursorInSelectedLine(lineNumber);
     }
     
+    /**
+     * The callback is invoked once, when the window is mapped for 
+     * the first time, e.g. to load the file of a restored session.
+     */
+    void setFirstMappedCallback(Callback<>::Ptr callback) {
+        firstMappedCallback = callback;
+    }
+    
     void handleCatchedException();
 
 protected:
     virtual void processGuiWidgetCreatedEvent();
+    virtual void notifyAboutBeingMapped();
 
 protected: // GuiWidget::EventListener interface implementation
     virtual GuiWidget::ProcessingResult processGuiWidgetEvent(const XEvent* event);
@@ -180,6 +189,8 @@ private:
     
     ActionMethodContainer::Ptr          actionMethodContainer;
     ActionKeySequenceHandler            actionKeySequenceHandler;
+    
+    Callback<>::Ptr                     firstMappedCallback;
 };
 
 } // namespace LucED
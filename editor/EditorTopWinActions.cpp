@@ -22,6 +22,17 @@
 #include "EditorTopWinActions.hpp"
 #include "GlobalLuaInterpreter.hpp"
 #include "LuaErrorHandler.hpp"
+#include "MultiFileSearch.hpp"
+#include "SymbolIndex.hpp"
+#include "EditorTopWin.hpp"
+#include "GlobalConfig.hpp"
+#include "RegexException.hpp"
+#include "FileOpener.hpp"
+#include "File.hpp"
+#include "MemoryStatistics.hpp"
+#include "MemoryCompactor.hpp"
+#include "KeyboardMacro.hpp"
+#include "WordIndex.hpp"
 
 using namespace LucED;
 
@@ -172,3 +183,394 @@ void EditorTopWinActions::resetLuaModules()
 }
 
 
+
+
+/**
+ * Returns the selected text or the word at the cursor position.
+ */
+String EditorTopWinActions::getSelectionOrWordAtCursor()
+{
+    RawPtr<TextData> textData = editorWidget->getTextData();
+    
+    long spos;
+    long epos;
+    
+    if (editorWidget->hasSelection())
+    {
+        spos = editorWidget->getBeginSelectionPos();
+        epos = editorWidget->getEndSelectionPos();
+    }
+    else
+    {
+        spos = editorWidget->getCursorTextPosition();
+        epos = spos;
+        
+        while (spos > 0 && editorWidget->isWordCharacter(textData->getWCharBefore(spos))) {
+            --spos;
+        }
+        while (epos < textData->getLength() && editorWidget->isWordCharacter(textData->getWChar(epos))) {
+            ++epos;
+        }
+    }
+    return textData->getSubstring(Pos(spos), Pos(epos));
+}
+
+
+/**
+ * Searches the selection or the word at the cursor in the
+ * files below the directory of the current file.
+ */
+void EditorTopWinActions::findSelectionInFiles()
+{
+    RawPtr<TextData> textData = editorWidget->getTextData();
+    
+    String searchString = getSelectionOrWordAtCursor();
+    
+    if (searchString.getLength() == 0 || searchString.contains('\n')) {
+        return;
+    }
+    SearchParameter p;
+                    p.setIgnoreCaseFlag(false);
+                    p.setFindString(searchString);
+    
+    ObjectArray<String> directories;
+                        directories.append(File(textData->getFileName()).getDirName());
+    try
+    {
+        MultiFileSearch::start(p, directories);
+    }
+    catch (RegexException& ex)
+    {
+        messageBoxInvoker->call(MessageBoxParameter().setTitle("Error")
+                                                     .setMessage(ex.getMessage()));
+    }
+}
+
+
+/**
+ * Toggles the highlighting of all occurrences of the selected text
+ * or of the word at the cursor.
+ */
+void EditorTopWinActions::highlightAllMatches()
+{
+    RawPtr<MatchBackliteBuffer> matchBackliteBuffer = editorWidget->getMatchBackliteBuffer();
+    
+    String searchString = getSelectionOrWordAtCursor();
+    
+    if (searchString.getLength() == 0 || searchString.contains('\n')) {
+        matchBackliteBuffer->clear();
+        return;
+    }
+    SearchParameter p;
+                    p.setIgnoreCaseFlag(false);
+                    p.setWholeWordFlag(!editorWidget->hasSelection());
+                    p.setFindString(searchString);
+
+    if (matchBackliteBuffer->isActive() && matchBackliteBuffer->getSearchParameter().findsSameThan(p)) {
+        matchBackliteBuffer->clear();
+    } else {
+        matchBackliteBuffer->setSearchParameter(p);
+    }
+}
+
+
+/**
+ * Opens a window listing the memory allocated per buffer.
+ */
+void EditorTopWinActions::showMemoryStatistics()
+{
+    LuaAccess        luaAccess  = GlobalLuaInterpreter::getInstance()->getCurrentLuaAccess();
+    MemoryStatistics statistics = MemoryStatistics::collect(luaAccess);
+
+    TextData::Ptr      resultTextData = TextData::create();
+                       resultTextData->setPseudoFileName("Memory Statistics");
+    TextData::TextMark mark           = resultTextData->createNewMark();
+                       resultTextData->insertAtMark(mark, statistics.toReport());
+                       resultTextData->setModifiedFlag(false);
+
+    EditorTopWin::Ptr win = EditorTopWin::create(HilitedText::create(resultTextData, 
+                                                                     GlobalConfig::getInstance()->getDefaultLanguageMode()));
+                      win->show();
+}
+
+
+/**
+ * Shrinks all buffers to their used size and returns free memory
+ * to the operating system, e.g. after pasting and removing large blocks.
+ */
+void EditorTopWinActions::releaseMemory()
+{
+    long released = MemoryCompactor::getInstance()->releaseMemory();
+    
+    topWinActionInterface->setStatusMessage(String() << "Released " << (released / 1024) << " KB");
+}
+
+
+void EditorTopWinActions::toggleMacroRecording()
+{
+    RawPtr<KeyboardMacro> macro = KeyboardMacro::getInstance();
+    
+    if (macro->isRecording()) {
+        macro->stopRecording();
+        topWinActionInterface->setStatusMessage(String() << "Recorded macro with " << macro->getNumberOfSteps() << " steps");
+    } else {
+        macro->startRecording();
+        topWinActionInterface->setStatusMessage("Recording macro...");
+    }
+}
+
+
+void EditorTopWinActions::replayMacro()
+{
+    editorWidget->replayKeyboardMacro(1);
+}
+
+
+/**
+ * Repeats the macro until the cursor reaches the end of the file or 
+ * the macro does not move the cursor closer to the end of the file.
+ */
+void EditorTopWinActions::replayMacroToEndOfFile()
+{
+    long count = editorWidget->replayKeyboardMacro();
+    
+    topWinActionInterface->setStatusMessage(String() << "Replayed macro " << count << " times");
+}
+
+
+/**
+ * Completes the word before the cursor with words of all open files.
+ * Invoking it again directly afterwards replaces the completion by the 
+ * next candidate and finally restores the typed prefix.
+ */
+void EditorTopWinActions::completeWord()
+{
+    RawPtr<TextData> textData = editorWidget->getTextData();
+
+    if (editorWidget->isReadOnly() || editorWidget->areCursorChangesDisabled()) {
+        return;
+    }
+    long cursorPos  = editorWidget->getCursorTextPosition();
+    bool isCycling  =    wordCompletions.getLength() > 0
+                      && cursorPos == wordCompletionEndPos
+                      && textData->getSubstring(Pos(wordCompletionBeginPos), 
+                                                Pos(wordCompletionEndPos)) == wordCompletions[wordCompletionIndex];
+    if (!isCycling)
+    {
+        if (wordCompletions.getLength() > 0 && wordCompletionIndex > 0) {
+            WordIndex::getInstance()->notifyAboutCompletedWord(wordCompletions[wordCompletionIndex]);
+        }
+        wordCompletions.clear();
+
+        long spos = cursorPos;
+        
+        while (spos > 0 && editorWidget->isWordCharacter(textData->getWCharBefore(spos))) {
+            --spos;
+        }
+        if (spos == cursorPos) {
+            return;
+        }
+        String prefix = textData->getSubstring(Pos(spos), Pos(cursorPos));
+        
+        ObjectArray<String> words = WordIndex::getInstance()->findWords(prefix, 100, textData);
+
+        wordCompletions.append(prefix);
+        wordCompletions.append(words, 0, words.getLength());
+
+        if (wordCompletions.getLength() == 1) {
+            wordCompletions.clear();
+            topWinActionInterface->setStatusMessage("No completion");
+            return;
+        }
+        wordCompletionIndex    = 0;
+        wordCompletionBeginPos = spos;
+    }
+    wordCompletionIndex = (wordCompletionIndex + 1) % wordCompletions.getLength();
+    
+    {
+        TextData::HistorySection::Ptr historySection = textData->createHistorySection();
+
+        TextData::TextMark m = editorWidget->createNewMarkFromCursor();
+        m.moveToPos(wordCompletionBeginPos);
+        textData->removeAtMark(m, cursorPos - wordCompletionBeginPos);
+        long len = textData->insertAtMark(m, wordCompletions[wordCompletionIndex]);
+        
+        wordCompletionEndPos = wordCompletionBeginPos + len;
+        m.moveToPos(wordCompletionEndPos);
+        editorWidget->moveCursorToTextMark(m);
+        editorWidget->assureCursorVisible();
+    }
+    if (wordCompletionIndex > 0) {
+        topWinActionInterface->setStatusMessage(String() << "Completion " << wordCompletionIndex 
+                                                         << " of " << (wordCompletions.getLength() - 1));
+    } else {
+        topWinActionInterface->setStatusMessage("Original word");
+    }
+}
+
+
+bool EditorTopWinActions::cancelFindInFiles()
+{
+    return MultiFileSearch::cancelSearchesFor(editorWidget->getTextData());
+}
+
+
+/**
+ * Opens the file of a "fileName:lineNumber:" location at the beginning 
+ * of the cursor line, e.g. from find in files or compiler output.
+ * Relative file names are resolved against the directory of the current file.
+ */
+void EditorTopWinActions::gotoLocationAtCursor()
+{
+    RawPtr<TextData> textData  = editorWidget->getTextData();
+    long             lineBegin = textData->getThisLineBegin(editorWidget->getCursorTextPosition());
+    long             lineEnd   = textData->getThisLineEnding(lineBegin);
+    String           line      = textData->getSubstring(Pos(lineBegin), Pos(lineEnd));
+    
+    for (int i = 1, n = line.getLength(); i < n; ++i)
+    {
+        if (line[i] != ':' || i + 1 >= n || !isdigit(line[i + 1])) {
+            continue;
+        }
+        int j = i + 1;
+        while (j < n && isdigit(line[j])) {
+            ++j;
+        }
+        if (j < n && line[j] != ':') {
+            continue;
+        }
+        String fileName   = line.getSubstring(Pos(0), Pos(i));
+        int    lineNumber = atoi(line.getSubstring(Pos(i + 1), Pos(j)).toCString());
+        
+        if (fileName[0] != '/') {
+            fileName = String() << File(textData->getFileName()).getDirName() << "/" << fileName;
+        }
+        if (File(fileName).exists()) {
+            FileOpener::start(fileName, util::maximum(0, lineNumber - 1));
+        }
+        return;
+    }
+}
+
+
+/**
+ * Jumps to the definition of the word at the cursor. If there are several
+ * definitions, they are listed as "fileName:lineNumber:" locations in a new 
+ * window.
+ */
+void EditorTopWinActions::gotoDefinition()
+{
+    RawPtr<TextData> textData = editorWidget->getTextData();
+    
+    if (textData->isFileNamePseudo()) {
+        return;
+    }
+    long spos = editorWidget->getCursorTextPosition();
+    long epos = spos;
+    
+    while (spos > 0 && editorWidget->isWordCharacter(textData->getWCharBefore(spos))) {
+        --spos;
+    }
+    while (epos < textData->getLength() && editorWidget->isWordCharacter(textData->getWChar(epos))) {
+        ++epos;
+    }
+    String name = textData->getSubstring(Pos(spos), Pos(epos));
+    
+    if (name.getLength() == 0) {
+        return;
+    }
+    SymbolIndex::WeakPtr                 index       = SymbolIndex::getInstanceForFile(textData->getFileName());
+    ObjectArray<SymbolIndex::Definition> definitions = index->findDefinitions(name);
+    
+    if (definitions.getLength() == 0)
+    {
+        messageBoxInvoker->call(MessageBoxParameter().setTitle("Goto Definition")
+                                                     .setMessage(String() << "No definition found for '" << name << "'"
+                                                                          << (index->isUpdating() ? ", symbol index is being updated." 
+                                                                                                  : ".")));
+    }
+    else if (definitions.getLength() == 1)
+    {
+        FileOpener::start(definitions[0].fileName, util::maximum(0L, definitions[0].lineNumber - 1));
+    }
+    else
+    {
+        String content;
+        
+        for (int i = 0; i < definitions.getLength(); ++i) {
+            content << definitions[i].fileName << ":" << definitions[i].lineNumber << ": " 
+                    << definitions[i].kind     << " " << definitions[i].name       << "\n";
+        }
+        TextData::Ptr    resultTextData = TextData::create();
+                         resultTextData->setPseudoFileName(String() << index->getRootDirectory() << "/Definitions");
+        TextData::TextMark mark         = resultTextData->createNewMark();
+                           resultTextData->insertAtMark(mark, content);
+                           resultTextData->setModifiedFlag(false);
+
+        EditorTopWin::Ptr win = EditorTopWin::create(HilitedText::create(resultTextData, 
+                                                                         GlobalConfig::getInstance()->getDefaultLanguageMode()));
+                          win->show();
+    }
+}
+
+
+/**
+ * Completes the word before the cursor to the longest common prefix 
+ * of the matching symbol names.
+ */
+void EditorTopWinActions::completeSymbol()
+{
+    RawPtr<TextData> textData = editorWidget->getTextData();
+
+    if (textData->isFileNamePseudo() || editorWidget->isReadOnly() || editorWidget->areCursorChangesDisabled()) {
+        return;
+    }
+    long cursorPos = editorWidget->getCursorTextPosition();
+    long spos      = cursorPos;
+    
+    while (spos > 0 && editorWidget->isWordCharacter(textData->getWCharBefore(spos))) {
+        --spos;
+    }
+    if (spos == cursorPos) {
+        return;
+    }
+    String              prefix = textData->getSubstring(Pos(spos), Pos(cursorPos));
+    ObjectArray<String> names  = SymbolIndex::getInstanceForFile(textData->getFileName())->findSymbolNames(prefix, 1000);
+    
+    if (names.getLength() == 0) {
+        return;
+    }
+    long commonLength = names[0].getLength();
+    
+    for (int i = 1; i < names.getLength(); ++i)
+    {
+        long j = prefix.getLength();
+        while (j < commonLength && j < names[i].getLength() && names[i][j] == names[0][j]) {
+            ++j;
+        }
+        commonLength = j;
+    }
+    if (commonLength > prefix.getLength())
+    {
+        TextData::HistorySection::Ptr historySection = textData->createHistorySection();
+
+        TextData::TextMark m    = editorWidget->createNewMarkFromCursor();
+        long               len  = textData->insertAtMark(m, names[0].getSubstring(Pos(prefix.getLength()), 
+                                                                                   Pos(commonLength)));
+        m.moveToPos(cursorPos + len);
+        editorWidget->moveCursorToTextMark(m);
+        editorWidget->assureCursorVisible();
+    }
+    else if (names.getLength() > 1)
+    {
+        String message;
+        for (int i = 0; i < names.getLength() && i < 20; ++i) {
+            message << names[i] << "\n";
+        }
+        if (names.getLength() > 20) {
+            message << "...\n";
+        }
+        messageBoxInvoker->call(MessageBoxParameter().setTitle("Symbols")
+                                                     .setMessage(message));
+    }
+}
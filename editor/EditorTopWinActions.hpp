@@ -144,11 +144,13 @@ public:
         WindowCloser::start();
     }
 
-    void closePanel()
+    bool closePanel()
     {
         if (panelInvoker->hasInvokedPanel()) {
             panelInvoker->closeInvokedPanel();
+            return true;
         }
+        return false;
     }
     
     void requestCloseWindow()
@@ -169,18 +171,48 @@ public:
     void executeLuaScript();
     
     void resetLuaModules();
+    
+    void findSelectionInFiles();
+    
+    bool cancelFindInFiles();
+    
+    void gotoLocationAtCursor();
+    
+    void gotoDefinition();
+    
+    void completeSymbol();
+    
+    void highlightAllMatches();
+    
+    void showMemoryStatistics();
+    
+    void releaseMemory();
+    
+    void toggleMacroRecording();
+    
+    void replayMacro();
+    
+    void replayMacroToEndOfFile();
+    
+    void completeWord();
         
 private:
+
+    String getSelectionOrWordAtCursor();
  
     EditorTopWinActions(const TopWinActionsParameter& parameter)
  
         : ActionMethodBinding<EditorTopWinActions>(this),
-          TopWinActionsParameter(parameter)
+          TopWinActionsParameter(parameter),
+          wordCompletionIndex(0),
+          wordCompletionBeginPos(0),
+          wordCompletionEndPos(-1)
     {
         findPanel = FindPanel::create(editorWidget, 
                                       messageBoxInvoker,
                                       newCallback(this, &EditorTopWinActions::invokeFindPanel),
-                                      newCallback(this, &EditorTopWinActions::closeFindPanel));
+                                      newCallback(this, &EditorTopWinActions::closeFindPanel),
+                                      newCallback(topWinActionInterface, &TopWinActionInterface::setStatusMessage));
 
         replacePanel = ReplacePanel::create(editorWidget, findPanel,
                                             messageBoxInvoker,
@@ -211,6 +243,11 @@ private:
     ReplacePanel::Ptr                        replacePanel;
     GotoLinePanel::Ptr                       gotoLinePanel;
     ExecutePanel::Ptr                        executePanel;
+    
+    ObjectArray<String>                      wordCompletions;
+    int                                      wordCompletionIndex;
+    long                                     wordCompletionBeginPos;
+    long                                     wordCompletionEndPos;
 };
 
 
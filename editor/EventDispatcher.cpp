@@ -19,6 +19,8 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////
 
+#include "config.h"
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
@@ -30,6 +32,13 @@
 #include <signal.h>
 #include <X11/Xatom.h>
 
+#if LUCED_USE_EPOLL
+#  include <stdint.h>
+#  include <sys/epoll.h>
+#  include <sys/timerfd.h>
+#  include <sys/signalfd.h>
+#endif
+
 #include "util.hpp"
 #include "EventDispatcher.hpp"
 #include "GuiRoot.hpp"
@@ -52,14 +61,17 @@ EventDispatcher* EventDispatcher::getInstance()
 }
 
 static bool hasSignalHandlers = false;
+#if !LUCED_USE_EPOLL
 static int sigChildPipeIn     = -1;
 static int sigChildPipeOut    = -1;
+#endif
 static int taskNotifyPipeIn   = -1;
 static int taskNotifyPipeOut  = -1;
 static sigset_t enabledSignalBlockMask;
 static sigset_t disabledSignalBlockMask;
 
 
+#if !LUCED_USE_EPOLL
 static void sigchildHandler(int signal)
 {
     switch (signal)
@@ -73,6 +85,7 @@ static void sigchildHandler(int signal)
         }
     }
 }
+#endif
 
 static inline void enableSignals()
 {
@@ -143,6 +156,7 @@ EventDispatcher::EventDispatcher()
 
     if (!hasSignalHandlers)
     {
+    #if !LUCED_USE_EPOLL
         int sigChildPipe[2];
     
         if (::pipe(sigChildPipe) != 0) {
@@ -154,6 +168,7 @@ EventDispatcher::EventDispatcher()
     
         System::setCloseOnExecFlag(sigChildPipeIn);
         System::setCloseOnExecFlag(sigChildPipeOut);
+    #endif
         
         int taskNotifyPipe[2];
         if (::pipe(taskNotifyPipe) != 0) {
@@ -166,6 +181,7 @@ EventDispatcher::EventDispatcher()
         System::setCloseOnExecFlag(taskNotifyPipeOut);
         
         {
+        #if !LUCED_USE_EPOLL
             struct sigaction handler;
        
             handler.sa_handler = sigchildHandler;
@@ -181,11 +197,14 @@ EventDispatcher::EventDispatcher()
             if (::sigaction(SIGCHLD, &handler, NULL) != 0) {
                 throw SystemException(String() << "Could not call sigaction: " << strerror(errno));
             }
+        #endif
             
             sigfillset(&enabledSignalBlockMask);
             sigfillset(&disabledSignalBlockMask);
             
-            sigdelset(&enabledSignalBlockMask, SIGCHLD); // Child process terminated
+        #if !LUCED_USE_EPOLL
+            sigdelset(&enabledSignalBlockMask, SIGCHLD); // Child process terminated, with epoll
+        #endif                                           // SIGCHLD stays blocked and is read via signalfd
             sigdelset(&enabledSignalBlockMask, SIGTSTP); // Terminal stop signal.
             sigdelset(&enabledSignalBlockMask, SIGCONT); // Continue executing, if stopped.
             
@@ -193,8 +212,48 @@ EventDispatcher::EventDispatcher()
         hasSignalHandlers = true;
     }
     disableSignals();
+
+#if LUCED_USE_EPOLL
+    fileDescriptorListenersCounter      = 0;
+    fileDescriptorListenersCleanupLimit = 64;
+    readyEventsCounter                  = 0;
+    readyEvents.increaseTo(64);
+
+    epollFileDescriptor = ::epoll_create1(EPOLL_CLOEXEC);
+    if (epollFileDescriptor == -1) {
+        throw SystemException(String() << "Could not create epoll file descriptor: " << strerror(errno));
+    }
+    
+    timerFileDescriptor = ::timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK|TFD_CLOEXEC);
+    if (timerFileDescriptor == -1) {
+        throw SystemException(String() << "Could not create timer file descriptor: " << strerror(errno));
+    }
+    
+    sigset_t sigChildMask;
+    sigemptyset(&sigChildMask);
+    sigaddset(&sigChildMask, SIGCHLD);
+
+    signalFileDescriptor = ::signalfd(-1, &sigChildMask, SFD_NONBLOCK|SFD_CLOEXEC);
+    if (signalFileDescriptor == -1) {
+        throw SystemException(String() << "Could not create signal file descriptor: " << strerror(errno));
+    }
+    
+    addToEpoll(x11FileDescriptor,    EPOLLIN);
+    addToEpoll(taskNotifyPipeIn,     EPOLLIN);
+    addToEpoll(timerFileDescriptor,  EPOLLIN);
+    addToEpoll(signalFileDescriptor, EPOLLIN);
+#endif
 }
 
+#if LUCED_USE_EPOLL
+EventDispatcher::~EventDispatcher()
+{
+    ::close(signalFileDescriptor);
+    ::close(timerFileDescriptor);
+    ::close(epollFileDescriptor);
+}
+#endif
+
 void EventDispatcher::registerEventReceiver(const GuiWidget::EventRegistration& registration)
 {
     widgetMap.set(registration.wid, registration.guiWidget);
@@ -225,11 +284,11 @@ EventDispatcher::TimerRegistration EventDispatcher::getNextTimer()
         if (timers.empty()) {
             return TimerRegistration();
         } else {
-            EventDispatcher::TimerRegistration rslt = timers.top();
-                                                      timers.pop();
+            const EventDispatcher::TimerRegistration& rslt = timers.top();
             if (rslt.isValid()) {
-                return rslt;
+                return rslt; // stays in queue until it is invoked
             }
+            timers.pop();
         }
     }
 }
@@ -394,12 +453,7 @@ bool EventDispatcher::processEvent(XEvent* event)
 
 void EventDispatcher::doEventLoop()
 {
-    fd_set             readfds;
-    fd_set             writefds;
-    fd_set             exceptfds;
-
     XEvent             event;
-    TimePeriod         remainingTime;
     Display*           display = GuiRoot::getInstance()->getDisplay();
     
     bool hasSomethingDone = true;
@@ -419,42 +473,6 @@ void EventDispatcher::doEventLoop()
         {
             TimerRegistration nextTimer = getNextTimer();
             
-            FD_ZERO(&readfds);
-            FD_ZERO(&writefds);
-            FD_ZERO(&exceptfds);
-            FD_SET(x11FileDescriptor, &readfds);
-            FD_SET(x11FileDescriptor, &exceptfds);
-            int maxFileDescriptor = x11FileDescriptor;
-            
-            util::maximize(&maxFileDescriptor, sigChildPipeIn);
-            FD_SET(sigChildPipeIn, &readfds);
-
-            util::maximize(&maxFileDescriptor, taskNotifyPipeIn);
-            FD_SET(taskNotifyPipeIn, &readfds);
-            
-            for (int i = 0; i < fileDescriptorListeners.getLength();)
-            {
-                FileDescriptorListener::Ptr listener = fileDescriptorListeners[i]; 
-                if (listener->isWaitingForRead())
-                {
-                    util::maximize(&maxFileDescriptor, listener->getFileDescriptor());
-                    FD_SET(listener->getFileDescriptor(), &readfds);
-                    if (listener->isWaitingForWrite()) {
-                        FD_SET(listener->getFileDescriptor(), &writefds);
-                    }
-                    ++i;
-                }
-                else if (listener->isWaitingForWrite())
-                {
-                    util::maximize(&maxFileDescriptor, listener->getFileDescriptor());
-                    FD_SET(listener->getFileDescriptor(), &writefds);
-                    ++i;
-                }
-                else {
-                    fileDescriptorListeners.remove(i);
-                }
-            }
-
             int p = 0;
             bool hasWaitingProcess = false;
             for (; p < processes.getLength();) {
@@ -469,9 +487,8 @@ void EventDispatcher::doEventLoop()
                 }
             }
             
-            int selectResult;
-            bool wasSelectInvoked = false;
-            bool wasTimerInvoked = false;
+            int waitResult;
+            bool wasWaitInvoked = false;
             
             {
                 if (nextTimer.isValid()) {
@@ -496,23 +513,16 @@ void EventDispatcher::doEventLoop()
                             now = TimeStamp::now();
                             
                             if (nextTimer.getTimeStamp() < now + MilliSeconds(20)) {
-                                remainingTime = nextTimer.getTimeStamp() - now;
-                                selectResult = internalSelect(maxFileDescriptor + 1, &readfds, &writefds, NULL, remainingTime);
-                                wasSelectInvoked = true;
+                                waitResult = waitForEvents(nextTimer.getTimeStamp());
+                                wasWaitInvoked = true;
                             }
                         } else {
-                            remainingTime = nextTimer.getTimeStamp() - now;
-                            selectResult = internalSelect(maxFileDescriptor + 1, &readfds, &writefds, NULL, remainingTime);
-                            wasSelectInvoked = true;
+                            waitResult = waitForEvents(nextTimer.getTimeStamp());
+                            wasWaitInvoked = true;
                         }
                     } else {
-                        TimeStamp now = TimeStamp::now();
-                        
-                        remainingTime = nextTimer.getTimeStamp() - now;
-                            
-                        selectResult = internalSelect(maxFileDescriptor + 1, &readfds, &writefds, NULL, remainingTime);
-                        
-                        wasSelectInvoked = true;
+                        waitResult = waitForEvents(nextTimer.getTimeStamp());
+                        wasWaitInvoked = true;
                     }
                 } else {
                     if (hasWaitingProcess) {
@@ -522,90 +532,28 @@ void EventDispatcher::doEventLoop()
                         h->process(TimeStamp::now() + MilliSeconds(20));
                         hasSomethingDone = true;
                     } else {
-                    
-                        selectResult = internalSelect(maxFileDescriptor + 1, &readfds, &writefds, NULL, Null);
-                        wasSelectInvoked = true;
+                        waitResult = waitForEvents(Null);
+                        wasWaitInvoked = true;
                     }
                 }
             }
             
-            if (wasSelectInvoked) {
-                if (selectResult > 0) {
-                    if (FD_ISSET(x11FileDescriptor, &readfds)) {
-                        XNextEvent(display, &event);
-                        hasSomethingDone = processEvent(&event);
-                    }
-                    for (int i = 0; i < fileDescriptorListeners.getLength(); ++i)
-                    {
-                        FileDescriptorListener::Ptr listener = fileDescriptorListeners[i];
-                        int                         fd       = listener->getFileDescriptor();
-                    
-                        if (FD_ISSET(fd, &readfds)) {
-                            listener->handleReading();
-                            hasSomethingDone = true;
-                        }
-                        if (FD_ISSET(fd, &writefds)) {
-                            listener->handleWriting();
-                            hasSomethingDone = true;
-                        }
-                    }
-                    if (FD_ISSET(sigChildPipeIn, &readfds)) {
-                        char buffer[40];
-                        int readCounter = ::read(sigChildPipeIn, buffer, sizeof(buffer));
-
-                        int status;
-                        pid_t pid = 0;
-
-                        do {
-                            pid = waitpid(-1, &status, WNOHANG);
-                            if (pid == -1) {
-                                if (errno != ECHILD) {
-                                    throw SystemException(String() << "Error while calling waitpid: " << strerror(errno));
-                                }
-                                pid = 0;
-                            }
-                            if (pid != 0)
-                            {
-                                ProcessListenerMap::Value foundListener = childProcessListeners.get(pid);
-                                if (foundListener.isValid())
-                                {
-                                    int returnCode = -1;
-                                    if (WIFEXITED(status)) {
-                                        returnCode = WEXITSTATUS(status);
-                                    }
-                                    foundListener.get()->call(returnCode);
-                                    childProcessListeners.remove(pid);
-                                    hasSomethingDone = true;
-                                }
-                            }
-                        } while (pid != 0);
-                    }
-                    if (FD_ISSET(taskNotifyPipeIn, &readfds))
-                    {
-                        Mutex::Lock lock(mutex);
-                        {
-                            char buffer[40];
-                            int readCounter = ::read(taskNotifyPipeIn, buffer, sizeof(buffer));
-
-                            for (int i = 0; i < tasks.getLength(); ++i) {
-                                tasks[i]->call();
-                            }
-                            tasks.clear();
-                        }
+            if (wasWaitInvoked) {
+                if (waitResult > 0) {
+                    if (processReadyEvents(&event)) {
+                        hasSomethingDone = true;
                     }
                 } else {
-                    if (nextTimer.isValid()) {
-                        if (nextTimer.getTimeStamp() < TimeStamp::now()) {
-                            nextTimer.getCallback()->call();
+                    if (nextTimer.isValid() && !timers.empty()) {
+                        if (timers.top().getTimeStamp() < TimeStamp::now()) {
+                            TimerRegistration dueTimer = timers.top();
+                                                         timers.pop();
+                            dueTimer.getCallback()->call();
                             hasSomethingDone = true;
-                            wasTimerInvoked = true;
                         }
                     }
                 }
             }
-            if (nextTimer.isValid() && !wasTimerInvoked) {
-                timers.push(nextTimer); // nextTimer was not executed -> queue it again
-            }
         }
         
         if (stoppingComponents.getLength() > 0)
@@ -637,6 +585,319 @@ void EventDispatcher::doEventLoop()
     doQuit = false;
 }
 
+#if LUCED_USE_EPOLL
+
+void EventDispatcher::addToEpoll(int fileDescriptor, uint32_t events)
+{
+    struct epoll_event e;
+    memset(&e, 0, sizeof(e));
+    e.events  = events;
+    e.data.fd = fileDescriptor;
+    
+    if (::epoll_ctl(epollFileDescriptor, EPOLL_CTL_ADD, fileDescriptor, &e) != 0) {
+        throw SystemException(String() << "Could not call epoll_ctl: " << strerror(errno));
+    }
+}
+
+
+void EventDispatcher::updateFileDescriptorListener(int fileDescriptor, FileDescriptorListener* listener)
+{
+    struct epoll_event e;
+    memset(&e, 0, sizeof(e));
+    e.data.fd = fileDescriptor;
+    
+    if (listener->isWaitingForRead()) {
+        e.events |= EPOLLIN;
+    }
+    if (listener->isWaitingForWrite()) {
+        e.events |= EPOLLOUT;
+    }
+    if (e.events != 0) {
+        if (::epoll_ctl(epollFileDescriptor, EPOLL_CTL_MOD, fileDescriptor, &e) != 0) {
+            throw SystemException(String() << "Could not call epoll_ctl: " << strerror(errno));
+        }
+    } else {
+        ::epoll_ctl(epollFileDescriptor, EPOLL_CTL_DEL, fileDescriptor, &e);
+        fileDescriptorListeners.remove(fileDescriptor);
+        --fileDescriptorListenersCounter;
+    }
+}
+
+
+void EventDispatcher::handleClosingFileDescriptor(int fileDescriptor)
+{
+    if (fileDescriptorListeners.hasKey(fileDescriptor))
+    {
+        struct epoll_event e;
+        memset(&e, 0, sizeof(e));
+        ::epoll_ctl(epollFileDescriptor, EPOLL_CTL_DEL, fileDescriptor, &e);
+        fileDescriptorListeners.remove(fileDescriptor);
+        --fileDescriptorListenersCounter;
+    }
+}
+
+
+void EventDispatcher::removeInactiveFileDescriptorListeners()
+{
+    MemArray<int> inactiveFileDescriptors;
+    
+    for (FileDescriptorListenerMap::Iterator i = fileDescriptorListeners.getIterator();
+         !i.isAtEnd(); i.gotoNext())
+    {
+        if (!i.getValue()->isActive()) {
+            inactiveFileDescriptors.append(i.getKey());
+        }
+    }
+    for (int i = 0; i < inactiveFileDescriptors.getLength(); ++i)
+    {
+        FileDescriptorListener::Ptr listener = fileDescriptorListeners.get(inactiveFileDescriptors[i]).get();
+        updateFileDescriptorListener(inactiveFileDescriptors[i], listener);
+    }
+}
+
+#endif // LUCED_USE_EPOLL
+
+
+int EventDispatcher::waitForEvents(const Nullable<TimeStamp>& wakeupTime)
+{
+#if LUCED_USE_EPOLL
+
+    int timeout = -1;
+
+    if (wakeupTime.isValid())
+    {
+        if (wakeupTime.get() > TimeStamp::now())
+        {
+            if (!armedTimerTime.isValid() || armedTimerTime.get() != wakeupTime.get())
+            {
+                struct itimerspec timerSpec;
+                memset(&timerSpec, 0, sizeof(timerSpec));
+                timerSpec.it_value.tv_sec  = wakeupTime.get().getSeconds();
+                timerSpec.it_value.tv_nsec = wakeupTime.get().getMicroSeconds() * 1000;
+                
+                if (::timerfd_settime(timerFileDescriptor, TFD_TIMER_ABSTIME, &timerSpec, NULL) != 0) {
+                    throw SystemException(String() << "Could not call timerfd_settime: " << strerror(errno));
+                }
+                armedTimerTime = wakeupTime;
+            }
+        } else {
+            timeout = 0;
+        }
+    }
+    
+    int rslt = ::epoll_pwait(epollFileDescriptor, readyEvents.getPtr(), readyEvents.getLength(), 
+                             timeout, &enabledSignalBlockMask);
+    
+    if (rslt > 0)
+    {
+        for (int i = 0; i < rslt;)
+        {
+            if (readyEvents[i].data.fd == timerFileDescriptor)
+            {
+                uint64_t expirations;
+                if (::read(timerFileDescriptor, &expirations, sizeof(expirations)) > 0) {
+                    armedTimerTime = Null;
+                }
+                readyEvents[i] = readyEvents[rslt - 1];
+                rslt -= 1;
+            } else {
+                ++i;
+            }
+        }
+    }
+    readyEventsCounter = (rslt > 0) ? rslt : 0;
+    
+    return rslt;
+
+#else // !LUCED_USE_EPOLL
+
+    FD_ZERO(&readfds);
+    FD_ZERO(&writefds);
+    FD_SET(x11FileDescriptor, &readfds);
+    int maxFileDescriptor = x11FileDescriptor;
+    
+    util::maximize(&maxFileDescriptor, sigChildPipeIn);
+    FD_SET(sigChildPipeIn, &readfds);
+
+    util::maximize(&maxFileDescriptor, taskNotifyPipeIn);
+    FD_SET(taskNotifyPipeIn, &readfds);
+    
+    for (int i = 0; i < fileDescriptorListeners.getLength();)
+    {
+        FileDescriptorListener::Ptr listener = fileDescriptorListeners[i]; 
+        if (listener->isWaitingForRead())
+        {
+            util::maximize(&maxFileDescriptor, listener->getFileDescriptor());
+            FD_SET(listener->getFileDescriptor(), &readfds);
+            if (listener->isWaitingForWrite()) {
+                FD_SET(listener->getFileDescriptor(), &writefds);
+            }
+            ++i;
+        }
+        else if (listener->isWaitingForWrite())
+        {
+            util::maximize(&maxFileDescriptor, listener->getFileDescriptor());
+            FD_SET(listener->getFileDescriptor(), &writefds);
+            ++i;
+        }
+        else {
+            fileDescriptorListeners.remove(i);
+        }
+    }
+
+    Nullable<TimePeriod> remainingTime;
+    if (wakeupTime.isValid()) {
+        remainingTime = wakeupTime.get() - TimeStamp::now();
+    }
+    return internalSelect(maxFileDescriptor + 1, &readfds, &writefds, NULL, remainingTime);
+
+#endif // !LUCED_USE_EPOLL
+}
+
+
+bool EventDispatcher::processReadyEvents(XEvent* event)
+{
+    bool hasSomethingDone = false;
+
+#if LUCED_USE_EPOLL
+
+    for (int i = 0; i < readyEventsCounter; ++i)
+    {
+        int      fd     = readyEvents[i].data.fd;
+        uint32_t events = readyEvents[i].events;
+        
+        if (fd == x11FileDescriptor) {
+            XNextEvent(GuiRoot::getInstance()->getDisplay(), event);
+            if (processEvent(event)) {
+                hasSomethingDone = true;
+            }
+        }
+        else if (fd == signalFileDescriptor)
+        {
+            struct signalfd_siginfo info;
+            while (::read(signalFileDescriptor, &info, sizeof(info)) > 0)
+            {}
+            if (handleTerminatedChildProcesses()) {
+                hasSomethingDone = true;
+            }
+        }
+        else if (fd == taskNotifyPipeIn) {
+            executeTasks();
+        }
+        else
+        {
+            FileDescriptorListenerMap::Value foundListener = fileDescriptorListeners.get(fd);
+            if (foundListener.isValid())
+            {
+                FileDescriptorListener::Ptr listener = foundListener.get();
+
+                if ((events & (EPOLLIN|EPOLLHUP|EPOLLERR)) && listener->isWaitingForRead()) {
+                    listener->handleReading();
+                    hasSomethingDone = true;
+                }
+                if ((events & (EPOLLOUT|EPOLLHUP|EPOLLERR)) && listener->isWaitingForWrite()
+                                                            && listener->getFileDescriptor() == fd) {
+                    listener->handleWriting();
+                    hasSomethingDone = true;
+                }
+                if (listener->getFileDescriptor() == fd) {
+                    updateFileDescriptorListener(fd, listener);
+                }
+            }
+        }
+    }
+    if (readyEventsCounter == readyEvents.getLength()) {
+        readyEvents.increaseTo(2 * readyEvents.getLength());
+    }
+    readyEventsCounter = 0;
+
+#else // !LUCED_USE_EPOLL
+
+    if (FD_ISSET(x11FileDescriptor, &readfds)) {
+        XNextEvent(GuiRoot::getInstance()->getDisplay(), event);
+        hasSomethingDone = processEvent(event);
+    }
+    for (int i = 0; i < fileDescriptorListeners.getLength(); ++i)
+    {
+        FileDescriptorListener::Ptr listener = fileDescriptorListeners[i];
+        int                         fd       = listener->getFileDescriptor();
+    
+        if (FD_ISSET(fd, &readfds)) {
+            listener->handleReading();
+            hasSomethingDone = true;
+        }
+        if (FD_ISSET(fd, &writefds)) {
+            listener->handleWriting();
+            hasSomethingDone = true;
+        }
+    }
+    if (FD_ISSET(sigChildPipeIn, &readfds)) {
+        char buffer[40];
+        int readCounter = ::read(sigChildPipeIn, buffer, sizeof(buffer));
+
+        if (handleTerminatedChildProcesses()) {
+            hasSomethingDone = true;
+        }
+    }
+    if (FD_ISSET(taskNotifyPipeIn, &readfds)) {
+        executeTasks();
+    }
+
+#endif // !LUCED_USE_EPOLL
+
+    return hasSomethingDone;
+}
+
+
+bool EventDispatcher::handleTerminatedChildProcesses()
+{
+    bool hasSomethingDone = false;
+    int status;
+    pid_t pid = 0;
+
+    do {
+        pid = waitpid(-1, &status, WNOHANG);
+        if (pid == -1) {
+            if (errno != ECHILD) {
+                throw SystemException(String() << "Error while calling waitpid: " << strerror(errno));
+            }
+            pid = 0;
+        }
+        if (pid != 0)
+        {
+            ProcessListenerMap::Value foundListener = childProcessListeners.get(pid);
+            if (foundListener.isValid())
+            {
+                int returnCode = -1;
+                if (WIFEXITED(status)) {
+                    returnCode = WEXITSTATUS(status);
+                }
+                foundListener.get()->call(returnCode);
+                childProcessListeners.remove(pid);
+                hasSomethingDone = true;
+            }
+        }
+    } while (pid != 0);
+
+    return hasSomethingDone;
+}
+
+
+void EventDispatcher::executeTasks()
+{
+    Mutex::Lock lock(mutex);
+    {
+        char buffer[40];
+        int readCounter = ::read(taskNotifyPipeIn, buffer, sizeof(buffer));
+
+        for (int i = 0; i < tasks.getLength(); ++i) {
+            tasks[i]->call();
+        }
+        tasks.clear();
+    }
+}
+
+
 void EventDispatcher::registerUpdateSource(Callback<>::Ptr updateCallback)
 {
     updateCallbacks.registerCallback(updateCallback);
@@ -701,7 +962,28 @@ void EventDispatcher::deregisterRunningComponent(RunningComponent* runningCompon
 
 void EventDispatcher::registerFileDescriptorListener(FileDescriptorListener::Ptr fileDescriptorListener)
 {
+#if LUCED_USE_EPOLL
+    int fd = fileDescriptorListener->getFileDescriptor();
+    
+    if (fd != -1 && fileDescriptorListener->isActive())
+    {
+        if (fileDescriptorListenersCounter >= fileDescriptorListenersCleanupLimit) {
+            removeInactiveFileDescriptorListeners();
+            fileDescriptorListenersCleanupLimit = util::maximum(64, 2 * fileDescriptorListenersCounter);
+        }
+        handleClosingFileDescriptor(fd); // forget previous listener for this descriptor
+        
+        addToEpoll(fd, (fileDescriptorListener->isWaitingForRead()  ? EPOLLIN  : 0)
+                     | (fileDescriptorListener->isWaitingForWrite() ? EPOLLOUT : 0));
+        
+        fileDescriptorListeners.set(fd, fileDescriptorListener);
+        ++fileDescriptorListenersCounter;
+
+        fileDescriptorListener->setClosingCallback(newCallback(this, &EventDispatcher::handleClosingFileDescriptor));
+    }
+#else
     fileDescriptorListeners.append(fileDescriptorListener);
+#endif
 }
 
 void EventDispatcher::registerForTerminatingChildProcess(pid_t childPid, Callback<int>::Ptr callback)
@@ -22,8 +22,16 @@
 #ifndef EVENT_DISPATCHER_HPP
 #define EVENT_DISPATCHER_HPP
 
+#include "config.h"
+
 #include <queue>
 
+#if LUCED_USE_EPOLL
+#  include <sys/epoll.h>
+#else
+#  include <sys/select.h>
+#endif
+
 #include "headers.hpp"
 #include "HeapObject.hpp"
 #include "GuiWidget.hpp"
@@ -119,7 +127,7 @@ private:
                 return false;
             }
         }
-        bool isValid() {
+        bool isValid() const {
             return callback->isEnabled();
         }
         const TimeStamp& getTimeStamp() const {
@@ -135,10 +143,26 @@ private:
     
     EventDispatcher();
     
+#if LUCED_USE_EPOLL
+    ~EventDispatcher();
+#endif
+
     TimerRegistration getNextTimer();
     
     void invokeAllUpdateCallbacks();
     
+    int  waitForEvents(const Nullable<TimeStamp>& wakeupTime);
+    bool processReadyEvents(XEvent* event);
+    bool handleTerminatedChildProcesses();
+    void executeTasks();
+
+#if LUCED_USE_EPOLL
+    void addToEpoll(int fileDescriptor, uint32_t events);
+    void updateFileDescriptorListener(int fileDescriptor, FileDescriptorListener* listener);
+    void handleClosingFileDescriptor(int fileDescriptor);
+    void removeInactiveFileDescriptorListeners();
+#endif
+    
     ProcessHandler::Ptr getNextWaitingProcess();
     
     typedef HashMap< WidgetId, RawPtr<GuiWidget> > WidgetMap;
@@ -163,7 +187,26 @@ private:
     ObjectArray< OwningPtr<RunningComponent> > runningComponents;
     ObjectArray< WeakPtr  <RunningComponent> >   stoppingComponents;
 
+#if LUCED_USE_EPOLL
+    int epollFileDescriptor;
+    int timerFileDescriptor;
+    int signalFileDescriptor;
+    
+    Nullable<TimeStamp> armedTimerTime;
+
+    typedef HashMap< int, FileDescriptorListener::Ptr > FileDescriptorListenerMap;
+    FileDescriptorListenerMap fileDescriptorListeners;
+    int                       fileDescriptorListenersCounter;
+    int                       fileDescriptorListenersCleanupLimit;
+    
+    MemArray<struct epoll_event> readyEvents;
+    int                          readyEventsCounter;
+#else
     ObjectArray<FileDescriptorListener::Ptr> fileDescriptorListeners;
+
+    fd_set readfds;
+    fd_set writefds;
+#endif
     
     typedef HashMap< pid_t, Callback<int>::Ptr > ProcessListenerMap;
     ProcessListenerMap childProcessListeners;
@@ -277,6 +277,7 @@ File::Info File::getInfo() const
         Info rslt;
         rslt.isFileFlag                  = S_ISREG(statData.st_mode);
         rslt.isDirectoryFlag             = S_ISDIR(statData.st_mode);
+        rslt.fileSize                    = statData.st_size;
 
         TimePeriod timePeriodSincePosixEpoch;
         {
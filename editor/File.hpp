@@ -45,7 +45,8 @@ public:
             : isFileFlag(false),
               isDirectoryFlag(false),
               isWritableFlag(false),
-              existsFlag(false)
+              existsFlag(false),
+              fileSize(0)
         {}
         bool isFile() const {
             ASSERT(existsFlag);
@@ -63,6 +64,10 @@ public:
             ASSERT(existsFlag);
             return lastModifiedTime.get();
         }
+        long getFileSize() const {
+            ASSERT(existsFlag);
+            return fileSize;
+        }
         bool exists() const {
             return existsFlag;
         }
@@ -72,6 +77,7 @@ public:
         bool                isDirectoryFlag;
         bool                isWritableFlag;
         bool                existsFlag;
+        long                fileSize;
         Nullable<TimeStamp> lastModifiedTime;
     };
     
@@ -82,6 +82,9 @@ public:
     
     void close() {
         if (fileDescriptor != -1) {
+            if (closingCallback.isValid()) {
+                closingCallback->call(fileDescriptor);
+            }
             ::close(fileDescriptor);
             fileDescriptor = -1;
         }
@@ -89,6 +92,14 @@ public:
         writeCallback.invalidate();
     }
     
+    /**
+     * The closingCallback is invoked with the file descriptor
+     * before it is closed by close().
+     */
+    void setClosingCallback(Callback<int>::Ptr closingCallback) {
+        this->closingCallback = closingCallback;
+    }
+    
 private:
     FileDescriptorListener()
         : fileDescriptor(-1)
@@ -97,6 +108,7 @@ private:
     int fileDescriptor;
     Callback<int>::Ptr readCallback;
     Callback<int>::Ptr writeCallback;
+    Callback<int>::Ptr closingCallback;
 };
 
 } // namespace LucED
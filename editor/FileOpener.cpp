@@ -85,6 +85,7 @@ void FileOpener::openFiles()
         int    numberOfWindows  = fileParameterList->get(0).numberOfWindows;
         String fileName         = fileParameterList->get(0).fileName;
         String encoding         = fileParameterList->get(0).encoding;
+        int    lineNumber       = fileParameterList->get(0).lineNumber;
         String resolvedFileName = File(fileName).getAbsoluteNameWithResolvedLinks();
 
         if (numberOfWindows <= 0)
@@ -115,13 +116,22 @@ void FileOpener::openFiles()
                 LanguageMode::Ptr languageMode;
                 HilitedText::Ptr  hilitedText;
                 
+                textData->enableJournal();
+                
                 Nullable<String> errorMessage;
 
                 try
                 {
                     ByteBuffer buffer; 
-                    File(fileName).loadInto(&buffer);
+                    File       file(fileName);
+                    File::Info fileInfo = file.getInfo();
+                    
+                    file.loadInto(&buffer);
                     
+                    Nullable<TimeStamp> lastModifiedTime;
+                    if (fileInfo.exists()) {
+                        lastModifiedTime = fileInfo.getLastModifiedTime();
+                    }
                     Nullable<GlobalConfig::LanguageModeAndEncoding> result;
                     try
                     {
@@ -129,7 +139,8 @@ void FileOpener::openFiles()
                                  ->getLanguageModeAndEncodingForFileNameAndContent
                                  (
                                    fileName, 
-                                   &buffer
+                                   &buffer,
+                                   lastModifiedTime
                                  );
                         languageMode = result.get().languageMode;
                         hilitedText  = HilitedText::create(textData, languageMode);
@@ -222,6 +233,9 @@ void FileOpener::openFiles()
                     return;
                 }
                 lastTopWin = EditorTopWin::create(hilitedText);
+                
+                long numberOfRecoveredChanges = textData->recoverFromJournal();
+                
                 if (errorMessage.isValid()) {
                     MessageBoxParameter p;
                                         p.setTitle("Error opening file")
@@ -229,6 +243,15 @@ void FileOpener::openFiles()
                                          .setCancelButton("O]K");
                     lastTopWin->setModalMessageBox(p);
                 }
+                else if (numberOfRecoveredChanges > 0) {
+                    MessageBoxParameter p;
+                                        p.setTitle("Recovered changes")
+                                         .setMessage(String() << "Unsaved changes of file '" << File(fileName).getBaseName()
+                                                              << "' were recovered from the edit journal "
+                                                              << "(" << numberOfRecoveredChanges << " changes).")
+                                         .setCancelButton("O]K");
+                    lastTopWin->setModalMessageBox(p);
+                }
                 lastTopWin->show();
                 lastTopWin->raise();
 
@@ -241,6 +264,9 @@ void FileOpener::openFiles()
             EditorTopWin::Ptr win = EditorTopWin::create(lastTopWin->getHilitedText());
             win->show();
         }
+        if (lineNumber >= 0) {
+            lastTopWin->gotoLineNumber(lineNumber);
+        }
         fileParameterList->remove(0);
         lastTopWin = NULL;
     }
@@ -289,6 +315,7 @@ void FileOpener::openConfigFiles()
                 TextData::Ptr     textData     = TextData::create();
                 HilitedText::Ptr  hilitedText  = HilitedText::create(textData, languageMode);
 
+                textData->enableJournal();
                 try
                 {
                     textData->loadFile(fileName);
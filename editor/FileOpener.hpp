@@ -42,12 +42,13 @@ public:
 
     struct FileParameter
     {
-        FileParameter(int numberOfWindows, const String& fileName, const String& encoding = "")
-            : numberOfWindows(numberOfWindows), fileName(fileName), encoding(encoding)
+        FileParameter(int numberOfWindows, const String& fileName, const String& encoding = "", int lineNumber = -1)
+            : numberOfWindows(numberOfWindows), fileName(fileName), encoding(encoding), lineNumber(lineNumber)
         {}
         int    numberOfWindows;
         String fileName;
         String encoding;
+        int    lineNumber;
     };
 
     typedef HeapObjectArray<FileParameter> ParameterList;
@@ -61,10 +62,10 @@ public:
         return ptr;
     }
 
-    static WeakPtr start(String fileName)
+    static WeakPtr start(String fileName, int lineNumber = -1)
     {
         ParameterList::Ptr pars = ParameterList::create();
-        pars->append(FileParameter(1, fileName));
+        pars->append(FileParameter(1, fileName, "", lineNumber));
         return start(pars);
     }
 
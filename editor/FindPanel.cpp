@@ -35,12 +35,14 @@ using namespace LucED;
 
 FindPanel::FindPanel(RawPtr<TextEditorWidget> editorWidget, Callback<const MessageBoxParameter&>::Ptr messageBoxInvoker,
                                                             Callback<>::Ptr                           panelInvoker,
-                                                            Callback<>::Ptr                           panelCloser)
+                                                            Callback<>::Ptr                           panelCloser,
+                                                            Callback<const String&>::Ptr              statusMessageCallback)
     : BaseClass(panelCloser),
 
       e(editorWidget),
       messageBoxInvoker(messageBoxInvoker),
       panelInvoker(panelInvoker),
+      statusMessageCallback(statusMessageCallback),
       defaultDirection(Direction::DOWN),
       historyIndex(-1),
 
@@ -48,8 +50,11 @@ FindPanel::FindPanel(RawPtr<TextEditorWidget> editorWidget, Callback<const Messa
                            SearchHistory::getInstance()->getMessageBoxQueue(),
                            newCallback(this, &FindPanel::requestCloseFromInteraction),
                            newCallback(this, &FindPanel::handleException),
-                           this)
+                           this),
       
+      incrementalStartPos(0),
+      incrementalMatchBegin(-1),
+      incrementalMatchEnd(-1)
 {
     GuiLayoutColumn::Ptr  c0 = GuiLayoutColumn::create();
     GuiLayoutColumn::Ptr  c1 = GuiLayoutColumn::create();
@@ -76,12 +81,14 @@ FindPanel::FindPanel(RawPtr<TextEditorWidget> editorWidget, Callback<const Messa
     caseSensitiveCheckBox   = CheckBox::create   ("C]ase Sensitive");
     wholeWordCheckBox       = CheckBox::create   ("Wh]ole Word");
     regularExprCheckBox     = CheckBox::create   ("R]egular Expression");
+    incrementalCheckBox     = CheckBox::create   ("I]ncremental");
     
     Callback<CheckBox*>::Ptr checkBoxCallback = newCallback(this, &FindPanel::handleCheckBoxPressed);
     
     caseSensitiveCheckBox->setButtonPressedCallback(checkBoxCallback);
     wholeWordCheckBox    ->setButtonPressedCallback(checkBoxCallback);
     regularExprCheckBox  ->setButtonPressedCallback(checkBoxCallback);
+    incrementalCheckBox  ->setButtonPressedCallback(checkBoxCallback);
     
     label0   ->setLayoutHeight(findPrevButton->getStandardHeight(), VerticalAdjustment::CENTER);
     editField->setLayoutHeight(findPrevButton->getStandardHeight(), VerticalAdjustment::CENTER);
@@ -100,7 +107,8 @@ FindPanel::FindPanel(RawPtr<TextEditorWidget> editorWidget, Callback<const Messa
 
     caseSensitiveCheckBox->setNextFocusWidget(wholeWordCheckBox);
     wholeWordCheckBox->setNextFocusWidget(regularExprCheckBox);
-    regularExprCheckBox->setNextFocusWidget(cancelButton);
+    regularExprCheckBox->setNextFocusWidget(incrementalCheckBox);
+    incrementalCheckBox->setNextFocusWidget(cancelButton);
 
     //goBackButton->setNextFocusWidget(cancelButton);
     cancelButton->setNextFocusWidget(editField);
@@ -126,6 +134,7 @@ FindPanel::FindPanel(RawPtr<TextEditorWidget> editorWidget, Callback<const Messa
     r3->addElement(caseSensitiveCheckBox);
     r3->addElement(wholeWordCheckBox);
     r3->addElement(regularExprCheckBox);
+    r3->addElement(incrementalCheckBox);
     r3->addSpacer();
     r3->addElement(cancelButton);
     //r0->addElement(c2);
@@ -151,11 +160,17 @@ FindPanel::FindPanel(RawPtr<TextEditorWidget> editorWidget, Callback<const Messa
     caseSensitiveCheckBox->show();
     regularExprCheckBox->show();
     wholeWordCheckBox->show();
+    incrementalCheckBox->show();
     
     editField->getTextData()->registerModifiedFlagListener(newCallback(this, &FindPanel::handleModifiedEditField,
                                                                              &FindPanel::handleException));
+    editField->getTextData()->registerUpdateListener(newCallback(this, &FindPanel::handleEditFieldUpdate));
     editField->getKeyActionHandler()->addActionMethods(EditFieldActions::create(this));
     
+    incrementalSearch = IncrementalSearch::create(e->getTextData(),
+                                                  newCallback(this, &FindPanel::handleIncrementalSearchResult),
+                                                  newCallback(this, &FindPanel::handleIncrementalSearchProgress));
+    
     label0->setMiddleMouseButtonCallback(newCallback(editField, &SingleLineEditField::replaceTextWithPrimarySelection));
 }
 
@@ -208,6 +223,16 @@ void FindPanel::handleButtonPressed(Button* button, Button::ActivationVariant va
             SearchHistory::getInstance()->getMessageBoxQueue()->closeQueued();
 
             historyIndex = -1;
+            
+            if (incrementalMatchBegin >= 0 && incrementalParameter.findsSameThan(p))
+            {
+                // the search should find the match shown by the incremental search
+
+                TextData::TextMark m = e->createNewMarkFromCursor();
+                                   m.moveToPos(p.hasSearchForwardFlag() ? incrementalMatchBegin : incrementalMatchEnd);
+                e->moveCursorToTextMark(m);
+            }
+            cancelIncrementalSearch();
     
             editField->getTextData()->setModifiedFlag(false);
     
@@ -233,6 +258,13 @@ void FindPanel::invalidateOutdatedInteraction()
 void FindPanel::handleCheckBoxPressed(CheckBox* checkBox)
 {
     invalidateOutdatedInteraction();
+    
+    if (incrementalCheckBox->isChecked()) {
+        startIncrementalSearch();
+    } else if (checkBox == incrementalCheckBox) {
+        e->getMatchBackliteBuffer()->clear();
+        cancelIncrementalSearch();
+    }
 }
 
 
@@ -422,6 +454,10 @@ void FindPanel::executeHistoryForwardAction()
 
 void FindPanel::show()
 {
+    incrementalStartPos   = e->getCursorTextPosition();
+    incrementalMatchBegin = -1;
+    incrementalMatchEnd   = -1;
+
     setFocus(editField);
     BaseClass::show();
     if (editField->getTextData()->getModifiedFlag() == false) {
@@ -434,6 +470,15 @@ void FindPanel::show()
     }
 }
 
+void FindPanel::hide()
+{
+    if (incrementalCheckBox->isChecked()) {
+        e->getMatchBackliteBuffer()->clear();
+    }
+    cancelIncrementalSearch();
+    BaseClass::hide();
+}
+
 void FindPanel::handleModifiedEditField(bool modifiedFlag)
 {
     if (modifiedFlag == true)
@@ -445,6 +490,109 @@ void FindPanel::handleModifiedEditField(bool modifiedFlag)
 
 
 
+void FindPanel::handleEditFieldUpdate(TextData::UpdateInfo update)
+{
+    if (incrementalCheckBox->isChecked()) {
+        startIncrementalSearch();
+    }
+}
+
+
+/**
+ * Every change of the find string supersedes the running incremental
+ * search. The search starts from the cursor position the panel was
+ * opened at.
+ */
+void FindPanel::startIncrementalSearch()
+{
+    if (!isMapped()) {
+        return;
+    }
+    incrementalParameter = getSearchParameterFromGuiControls()
+                           .setSearchForwardFlag(defaultDirection == Direction::DOWN);
+
+    incrementalSearch->start(incrementalParameter, incrementalStartPos);
+
+    e->getMatchBackliteBuffer()->setSearchParameter(incrementalParameter);
+}
+
+
+void FindPanel::cancelIncrementalSearch()
+{
+    if (incrementalSearch->isRunning()) {
+        incrementalSearch->cancel();
+        statusMessageCallback->call("");
+    }
+}
+
+
+void FindPanel::handleIncrementalSearchResult(const IncrementalSearch::Result& result)
+{
+    if (result.generation != incrementalSearch->getGeneration() || !isMapped()) {
+        return;
+    }
+    if (result.wasFound())
+    {
+        incrementalMatchBegin = result.beginPos;
+        incrementalMatchEnd   = result.endPos;
+        
+        selectMatch(result.beginPos, result.endPos, incrementalParameter.hasSearchForwardFlag());
+        statusMessageCallback->call("");
+    }
+    else
+    {
+        if (incrementalMatchBegin >= 0)
+        {
+            // back to the position the panel was opened at
+            
+            incrementalMatchBegin = -1;
+            incrementalMatchEnd   = -1;
+            
+            e->releaseSelection();
+            e->moveCursorToTextPositionAndAdjustVisibility(incrementalStartPos);
+        }
+        if (result.hasError()) {
+            statusMessageCallback->call(result.errorMessage);
+        }
+        else if (incrementalParameter.getFindString().getLength() > 0) {
+            statusMessageCallback->call(String() << "Not found: " << incrementalParameter.getFindString());
+        }
+        else {
+            statusMessageCallback->call("");
+        }
+    }
+}
+
+
+void FindPanel::handleIncrementalSearchProgress(long generation, int percent)
+{
+    if (generation == incrementalSearch->getGeneration() && isMapped())
+    {
+        statusMessageCallback->call(String() << "Searching: " << incrementalParameter.getFindString()
+                                             << " (" << percent << "%)");
+    }
+}
+
+
+void FindPanel::selectMatch(long beginPos, long endPos, bool forwardFlag)
+{
+    TextData::TextMark m = e->createNewMarkFromCursor();
+    
+    m.moveToPos(forwardFlag ? beginPos : endPos);
+    e->moveCursorToTextMarkAndAdjustVisibility(m);
+    
+    m.moveToPos(forwardFlag ? endPos : beginPos);
+    e->moveCursorToTextMarkAndAdjustVisibility(m);
+    e->rememberCursorPixX();
+    
+    if (beginPos < endPos) {
+        e->setPrimarySelection(beginPos, endPos);
+    } else {
+        e->releaseSelection();
+    }
+}
+
+
 void FindPanel::handleException()
 {
     try
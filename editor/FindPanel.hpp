@@ -37,6 +37,7 @@
 #include "SearchInteraction.hpp"
 #include "PasteDataCollector.hpp"
 #include "ActionMethodBinding.hpp"
+#include "IncrementalSearch.hpp"
 
 namespace LucED
 {
@@ -49,9 +50,10 @@ public:
 
     static Ptr create(RawPtr<TextEditorWidget> editorWidget, Callback<const MessageBoxParameter&>::Ptr messageBoxInvoker,
                                                              Callback<>::Ptr                           panelInvoker,
-                                                             Callback<>::Ptr                           panelCloser)
+                                                             Callback<>::Ptr                           panelCloser,
+                                                             Callback<const String&>::Ptr              statusMessageCallback)
     {
-        return Ptr(new FindPanel(editorWidget, messageBoxInvoker, panelInvoker, panelCloser));
+        return Ptr(new FindPanel(editorWidget, messageBoxInvoker, panelInvoker, panelCloser, statusMessageCallback));
     }
     
     void setDefaultDirection(Direction::Type direction) {
@@ -68,6 +70,7 @@ public:
     void findSelectionBackward();
 
     virtual void show();
+    virtual void hide();
     
 private:
     class EditFieldActions : public ActionMethodBinding<EditFieldActions>
@@ -97,7 +100,8 @@ private:
     
     FindPanel(RawPtr<TextEditorWidget> editorWidget, Callback<const MessageBoxParameter&>::Ptr messageBoxInvoker,
                                                      Callback<>::Ptr                           panelInvoker,
-                                                     Callback<>::Ptr                           panelCloser);
+                                                     Callback<>::Ptr                           panelCloser,
+                                                     Callback<const String&>::Ptr              statusMessageCallback);
     void executeHistoryBackwardAction();
     void executeHistoryForwardAction();
 
@@ -113,6 +117,13 @@ private:
     
     
     void handleModifiedEditField(bool modifiedFlag);
+    
+    void handleEditFieldUpdate(TextData::UpdateInfo update);
+    void startIncrementalSearch();
+    void cancelIncrementalSearch();
+    void handleIncrementalSearchResult(const IncrementalSearch::Result& result);
+    void handleIncrementalSearchProgress(long generation, int percent);
+    void selectMatch(long beginPos, long endPos, bool forwardFlag);
 
     void requestCloseFromInteraction(SearchInteraction* interaction);
 
@@ -133,8 +144,10 @@ private:
     CheckBox::Ptr caseSensitiveCheckBox;
     CheckBox::Ptr wholeWordCheckBox;
     CheckBox::Ptr regularExprCheckBox;
+    CheckBox::Ptr incrementalCheckBox;
     Callback<const MessageBoxParameter&>::Ptr messageBoxInvoker;
     Callback<>::Ptr                           panelInvoker;
+    Callback<const String&>::Ptr              statusMessageCallback;
     BasicRegex regex;
     Direction::Type defaultDirection;
     int historyIndex;
@@ -143,6 +156,12 @@ private:
 
     SearchInteraction::Ptr         currentInteraction;
     SearchInteraction::Callbacks   interactionCallbacks;
+    
+    IncrementalSearch::Ptr         incrementalSearch;
+    SearchParameter                incrementalParameter;
+    long                           incrementalStartPos;
+    long                           incrementalMatchBegin;
+    long                           incrementalMatchEnd;
 };
 
 class FindPanelAccess
@@ -26,10 +26,23 @@
 
 using namespace LucED;
 
-FontInfo::FontInfo(const String& fontName)
+/**
+ * A preloaded font was requested with XLoadFont before, so that only 
+ * the query has to wait for the server. An invalid font name shows up
+ * as error of the query, which is expected and therefore not reported.
+ */
+FontInfo::FontInfo(const String& fontName, Nullable<Font> preloadedFont)
     : fontName(fontName)
 {
-    this->font = XLoadQueryFont(GuiRoot::getInstance()->getDisplay(), fontName.toCString());
+    Display* display = GuiRoot::getInstance()->getDisplay();
+
+    if (preloadedFont.isValid()) {
+        unsigned long serial = NextRequest(display);
+        GuiRoot::getInstance()->ignoreX11ErrorsForRequests(serial, serial);
+        this->font = XQueryFont(display, preloadedFont.get());
+    } else {
+        this->font = XLoadQueryFont(display, fontName.toCString());
+    }
     if (font == NULL) {
         throw ConfigException(String() << "invalid font name: " << fontName);
     }
@@ -229,3 +242,13 @@ short FontInfo::internalGetCharRBearing(Char2b c) const {
         return unknownRBearing;
     }
 }
+
+
+long FontInfo::getAllocatedBytes() const
+{
+    return charWidths    .getCapacityInBytes() + charWidths8    .getCapacityInBytes()
+         + charAscents   .getCapacityInBytes() + charAscents8   .getCapacityInBytes()
+         + charDescents  .getCapacityInBytes() + charDescents8  .getCapacityInBytes()
+         + charLBearings .getCapacityInBytes() + charLBearings8 .getCapacityInBytes()
+         + charRBearings .getCapacityInBytes() + charRBearings8 .getCapacityInBytes();
+}
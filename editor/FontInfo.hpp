@@ -33,6 +33,7 @@
 #include "FontHandle.hpp"
 #include "Char2b.hpp"
 #include "Char2bArray.hpp"
+#include "Nullable.hpp"
 
 namespace LucED
 {
@@ -47,7 +48,10 @@ public:
         friend class TextStyleCache;
         
         static Ptr create(const String& fontname) {
-            return Ptr(new FontInfo(fontname));
+            return Ptr(new FontInfo(fontname, Null));
+        }
+        static Ptr create(const String& fontname, Font preloadedFont) {
+            return Ptr(new FontInfo(fontname, preloadedFont));
         }
     };
     
@@ -141,9 +145,10 @@ public:
     Char2b getDefaultChar() const {
         return defaultChar;
     }
+    long getAllocatedBytes() const;
 
 private:
-    explicit FontInfo(const String& fontname);
+    FontInfo(const String& fontname, Nullable<Font> preloadedFont);
 
     long getCharInfoIndex(Char2b c) const {
         return (c.byte1 - minByte1) * numberBytes2 + (c.byte2 - minByte2);
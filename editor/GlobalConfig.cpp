@@ -32,6 +32,7 @@
 #include "ActionIdRegistry.hpp"
 #include "QualifiedName.hpp"
 #include "DefaultConfig.hpp"
+#include "StartupTiming.hpp"
                             
 using namespace LucED;
 
@@ -78,9 +79,11 @@ LanguageMode::Ptr GlobalConfig::getLanguageModeForFileName(const String& fileNam
 }
 
 GlobalConfig::LanguageModeAndEncoding GlobalConfig::getLanguageModeAndEncodingForFileNameAndContent(const String& fileName, 
-                                                                                                    RawPtr<const ByteBuffer> fileContent) const
+                                                                                                    RawPtr<const ByteBuffer> fileContent,
+                                                                                                    Nullable<TimeStamp> lastModifiedTime) const
 {
-    LanguageModeSelectors::Result result = languageModeSelectors->getResultForFileNameAndContent(fileName, fileContent);
+    LanguageModeSelectors::Result result = languageModeSelectors->getResultForFileNameAndContent(fileName, fileContent,
+                                                                                                 lastModifiedTime);
 
     LanguageMode::Ptr languageMode = languageModes->getLanguageMode(result.languageModeName);
     if (!languageMode.isValid()) {
@@ -302,6 +305,18 @@ ActionKeyConfig::Ptr GlobalConfig::buildActionKeyConfig()
 }
 
 void GlobalConfig::readConfig()
+{
+    readConfigWithChangedPackages(Null);
+}
+
+
+/**
+ * Modules of config packages that are already loaded are not evaluated 
+ * again, i.e. after GlobalLuaInterpreter::resetPackageWithDependents only 
+ * the changed packages are evaluated. If changedPackageNames is given, 
+ * only the syntax patterns of these packages are rebuilt.
+ */
+void GlobalConfig::readConfigWithChangedPackages(Nullable< ObjectArray<String> > changedPackageNames)
 {
     packagesMap.clear();
     
@@ -314,6 +329,10 @@ void GlobalConfig::readConfig()
 
     
     luaInterpreter->setConfigDir(configDirectory);
+
+    if (luaInterpreter->getMode() != ConfigPackageLoader::MODE_NORMAL) {
+        changedPackageNames = Null;
+    }
     luaInterpreter->setMode(ConfigPackageLoader::MODE_NORMAL);
 
     bool tryItAgain = false;
@@ -390,10 +409,23 @@ void GlobalConfig::readConfig()
     
             this->textStyleDefinitions = TextStyleDefinitions::create(fontList,
                                                                       textStyleList);
+            
+            // the fonts are loaded by the server while the remaining config is processed
+            {
+                ObjectArray<String> fontNames;
+                fontNames.append(configData->getGeneralConfig()->getGuiFont());
+
+                for (int i = 0; i < textStyleDefinitions->getLength(); ++i) {
+                    fontNames.append(textStyleDefinitions->get(i).getFontName());
+                }
+                TextStyleCache::getInstance()->removeUnusedEntries();
+                TextStyleCache::getInstance()->preloadFonts(fontNames);
+            }
 
             // LanguageModeSelectors
     
-            LanguageModeSelectors::Ptr newLanguageModeSelectors = LanguageModeSelectors::create();
+            LanguageModeSelectors::Ptr newLanguageModeSelectors = LanguageModeSelectors::create(configData->getGeneralConfig()
+                                                                                                           ->getLanguageModeDetectionLength());
             {
                 ConfigData::LanguageModeSelectors::Ptr languageModeSelectors = configData->getLanguageModeSelectors();
                 for (int i = 0; i < languageModeSelectors->getLength(); ++i)
@@ -473,6 +505,7 @@ void GlobalConfig::readConfig()
         {
             tryItAgain = true;
             luaInterpreter->setMode(ConfigPackageLoader::MODE_FALLBACK);
+            changedPackageNames = Null;
         }
         else {
             tryItAgain = false;
@@ -494,7 +527,7 @@ void GlobalConfig::readConfig()
 
     // SyntaxPatterns
     
-    this->syntaxPatternsConfig->refresh(textStyleDefinitions);
+    this->syntaxPatternsConfig->refresh(textStyleDefinitions, changedPackageNames);
     
     if (errorList->getLength() > 0)
     {
@@ -502,6 +535,8 @@ void GlobalConfig::readConfig()
     }
 
     configChangedCallbackContainer.invokeAllCallbacks();
+    
+    StartupTiming::reportPhase("config read");
 }
 
 bool GlobalConfig::isConfigFile(String fileName) const
@@ -511,13 +546,68 @@ bool GlobalConfig::isConfigFile(String fileName) const
 }
 
 
+/**
+ * Returns the name of the config package the file belongs to or Null
+ * for the general config file and for lua modules.
+ */
+Nullable<String> GlobalConfig::getConfigPackageNameForFile(const String& fileName) const
+{
+    String realName = File(fileName).getAbsoluteNameWithResolvedLinks();
+    
+    if (!realName.startsWith(String() << configDirectory << "/") || !realName.endsWith(luaFileExtension)) {
+        return Null;
+    }
+    String relativeName = realName.getTail(configDirectory.getLength() + 1);
+    long   slashPos     = relativeName.findFirstOf('/');
+    String packageName;
+    
+    if (slashPos >= 0) {
+        packageName = relativeName.getHead(slashPos);
+    } else {
+        packageName = relativeName.getHead(relativeName.getLength() - strlen(luaFileExtension));
+    }
+    if (packageName == "config" || packageName == "modules" || packageName.getLength() == 0) {
+        return Null;
+    }
+    return packageName;
+}
+
+
+/**
+ * A saved file of a config package only causes this package and the 
+ * packages that depend on it to be evaluated again and only if the 
+ * current config or a syntax in use depends on one of them, so that 
+ * buffers of other language modes keep their syntax patterns and 
+ * highlighting. Other config files reset all modules, as does any
+ * package access whose dependents are not known.
+ */
 void GlobalConfig::notifyAboutNewFileContent(String fileName)
 {
     if (isConfigFile(fileName))
     {
-        GlobalLuaInterpreter::getInstance()->resetModules();
-    
-        readConfig();
+        RawPtr<GlobalLuaInterpreter> luaInterpreter = GlobalLuaInterpreter::getInstance();
+        Nullable<String>             packageName    = getConfigPackageNameForFile(fileName);
+        
+        if (packageName.isValid() && !luaInterpreter->hasUntrackedPackageAccess())
+        {
+            ObjectArray<String> changedPackageNames = luaInterpreter->resetPackageWithDependents(packageName.get());
+            
+            for (int i = 0; i < changedPackageNames.getLength(); ++i)
+            {
+                if (   dependsOnPackage(changedPackageNames[i])
+                    || syntaxPatternsConfig->dependsOnPackage(changedPackageNames[i]))
+                {
+                    readConfigWithChangedPackages(changedPackageNames);
+                    break;
+                }
+            }
+        }
+        else
+        {
+            luaInterpreter->resetModules();
+        
+            readConfig();
+        }
     }
 }
 
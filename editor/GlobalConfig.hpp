@@ -77,7 +77,8 @@ public:
         String            encoding;
     };
 
-    LanguageModeAndEncoding getLanguageModeAndEncodingForFileNameAndContent(const String& fileName, RawPtr<const ByteBuffer> fileContent) const;
+    LanguageModeAndEncoding getLanguageModeAndEncodingForFileNameAndContent(const String& fileName, RawPtr<const ByteBuffer> fileContent,
+                                                                            Nullable<TimeStamp> lastModifiedTime = Null) const;
     LanguageMode::Ptr       getDefaultLanguageMode() const;
 
     void notifyAboutNewFileContent(String fileName);
@@ -88,6 +89,14 @@ public:
         configChangedCallbackContainer.registerCallback(callback);
     }
     
+    LanguageModeSelectors::Ptr getLanguageModeSelectors() const {
+        return languageModeSelectors;
+    }
+    
+    LanguageModes::Ptr getLanguageModes() const {
+        return languageModes;
+    }
+    
     String getConfigDirectory() const {
         return configDirectory;
     }
@@ -112,6 +121,10 @@ private:
     
     GlobalConfig();
 
+    void readConfigWithChangedPackages(Nullable< ObjectArray<String> > changedPackageNames);
+    
+    Nullable<String> getConfigPackageNameForFile(const String& fileName) const;
+
     typedef ConfigData::Fonts            ::Element::Font             ConfigDataFont;
     typedef ConfigData::TextStyles       ::Element::TextStyle        ConfigDataTextStyle;
     typedef ConfigData::ActionKeyBindings::Element::ActionKeyBinding ConfigDataActionKeyBinding;
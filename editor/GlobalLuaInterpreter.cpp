@@ -31,7 +31,32 @@ using namespace LucED;
 
 SingletonInstance<GlobalLuaInterpreter> GlobalLuaInterpreter::instance;;
 
+
+namespace // anonymous namespace
+{
+
+String getTopLevelPackageName(const String& moduleName)
+{
+    long dotPos = moduleName.findFirstOf('.');
+    
+    return (dotPos >= 0) ? moduleName.getHead(dotPos) : moduleName;
+}
+
+bool containsName(const ObjectArray<String>& names, const String& name)
+{
+    for (int i = 0; i < names.getLength(); ++i) {
+        if (names[i] == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+
 GlobalLuaInterpreter::GlobalLuaInterpreter()
+    : untrackedPackageAccessFlag(false)
 {
 #ifdef DEBUG
     luaPrintStackTraceFunction = &StackTrace::printStackTraceToStderr;
@@ -61,6 +86,102 @@ GlobalLuaInterpreter::GlobalLuaInterpreter()
     loadedPackagesStoreReference    = luaAccess.newTable().store();
 }
 
+
+void GlobalLuaInterpreter::resetPackage(const String& packageName)
+{
+    LuaAccess luaAccess = LuaInterpreter::getCurrentLuaAccess();
+
+    LuaVar loadedPackages = luaAccess.retrieve(loadedPackagesStoreReference);
+    String subModulePrefix = String() << packageName << ".";
+
+    for (LuaIterator i(luaAccess); i.in(loadedPackages);)
+    {
+        if (i.key().isString())
+        {
+            String moduleName = i.key().toString();
+            
+            if (moduleName == packageName || moduleName.startsWith(subModulePrefix)) {
+                loadedPackages[moduleName].setNil();
+            }
+        }
+    }
+}
+
+/**
+ * While a package module is evaluated, the package is on top of 
+ * loadingPackageNames and every access to another package is recorded
+ * as dependency.
+ */
+void GlobalLuaInterpreter::registerPackageAccess(const String& packageName)
+{
+    if (loadingPackageNames.getLength() == 0)
+    {
+        if (packageName.getLength() == 0) {
+            untrackedPackageAccessFlag = true;
+        }
+        return;
+    }
+    String dependentPackageName = loadingPackageNames.getLast();
+    
+    if (packageName == dependentPackageName) {
+        return;
+    }
+    for (int i = 0; i < packageDependencies.getLength(); ++i)
+    {
+        if (   packageDependencies[i].packageName          == packageName
+            && packageDependencies[i].dependentPackageName == dependentPackageName)
+        {
+            return;
+        }
+    }
+    packageDependencies.append(PackageDependency(packageName, dependentPackageName));
+}
+
+
+void GlobalLuaInterpreter::clearPackageDependencies()
+{
+    packageDependencies.clear();
+    untrackedPackageAccessFlag = false;
+}
+
+
+ObjectArray<String> GlobalLuaInterpreter::resetPackageWithDependents(const String& packageName)
+{
+    ObjectArray<String> rslt;
+    rslt.append(packageName);
+    
+    for (int i = 0; i < rslt.getLength(); ++i)
+    {
+        String changedPackageName = rslt[i];
+        
+        for (int j = 0; j < packageDependencies.getLength(); ++j)
+        {
+            const PackageDependency& d = packageDependencies[j];
+            
+            if (   (d.packageName == changedPackageName || d.packageName.getLength() == 0)
+                && !containsName(rslt, d.dependentPackageName))
+            {
+                rslt.append(d.dependentPackageName);
+            }
+        }
+    }
+    for (int i = 0; i < rslt.getLength(); ++i) {
+        resetPackage(rslt[i]);
+    }
+    // the reset packages record their dependencies again while they are loaded
+    
+    for (int j = 0; j < packageDependencies.getLength();)
+    {
+        if (containsName(rslt, packageDependencies[j].dependentPackageName)) {
+            packageDependencies.remove(j);
+        } else {
+            ++j;
+        }
+    }
+    return rslt;
+}
+
+
 void GlobalLuaInterpreter::setConfigDir(const String& configDir)
 {
     configPackageLoader.setConfigDir(configDir);
@@ -95,6 +216,8 @@ void GlobalLuaInterpreter::resetModules()
     }
 
     loadedPackagesStoreReference    = luaAccess.newTable().store();
+    
+    clearPackageDependencies();
 }
 
 
@@ -126,6 +249,7 @@ LuaCFunctionResult GlobalLuaInterpreter::packageLocalRequireFunction(const LuaCF
         throw LuaException(luaAccess,
                            String() << "Module name '" << requiredModuleName << "' not allowed");
     }
+    LoadingPackage loadingPackage(luaInterpreter, getTopLevelPackageName(currentPackageName));
 
     if (!requiredModuleName.startsWith(THIS_PREFIX))
     {
@@ -171,6 +295,7 @@ LuaVar GlobalLuaInterpreter::requireConfigPackage(const String& packageName)
     {
         throw ConfigException(String() << "Package name '" << packageName << "' not allowed");
     }
+    registerPackageAccess(getTopLevelPackageName(packageName));
     
     LuaVar loadedPackages = luaAccess.retrieve(loadedPackagesStoreReference);
     
@@ -199,6 +324,8 @@ LuaVar GlobalLuaInterpreter::requireConfigPackage(const String& packageName)
     
     startModule.setFunctionEnvironment(env);
     
+    LoadingPackage loadingPackage(this, getTopLevelPackageName(packageName));
+    
     LuaVar rslt = startModule.call(packageName);
 
     if (rslt.isNil()) {
@@ -221,10 +348,22 @@ LuaVar GlobalLuaInterpreter::getGeneralConfigModule(const String& moduleName)
     return startModule.call();
 }
 
-void GlobalLuaInterpreter::setMode(ConfigPackageLoader::Mode mode)
+LuaVar GlobalLuaInterpreter::getLoadedPackageModules()
 {
-    loadedPackagesStoreReference = LuaInterpreter::getCurrentLuaAccess()
-                                   .newTable().store();
+    // the caller can use the modules of every loaded package
+    
+    registerPackageAccess(String());
+    
+    return LuaInterpreter::getCurrentLuaAccess().retrieve(loadedPackagesStoreReference);
+}
 
+void GlobalLuaInterpreter::setMode(ConfigPackageLoader::Mode mode)
+{
+    if (mode != configPackageLoader.getMode())
+    {
+        loadedPackagesStoreReference = LuaInterpreter::getCurrentLuaAccess()
+                                       .newTable().store();
+        clearPackageDependencies();
+    }
     configPackageLoader.setMode(mode);
 }
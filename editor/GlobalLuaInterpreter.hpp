@@ -26,6 +26,8 @@
 #include "LuaInterpreter.hpp"
 #include "RawPtr.hpp"
 #include "ConfigPackageLoader.hpp"
+#include "ObjectArray.hpp"
+#include "String.hpp"
 
 namespace LucED
 {
@@ -39,17 +41,36 @@ public:
 
     void resetModules();
     
+    /**
+     * Forgets the loaded modules of the given config package and of all
+     * packages that depend on it directly or indirectly, so that only 
+     * these packages are evaluated again by the next config read. 
+     * Returns the names of the forgotten packages.
+     */
+    ObjectArray<String> resetPackageWithDependents(const String& packageName);
+    
+    /**
+     * True if loaded packages were accessed outside of a loading package,
+     * i.e. their dependents are unknown and only resetModules() is safe.
+     */
+    bool hasUntrackedPackageAccess() const {
+        return untrackedPackageAccessFlag;
+    }
+    
     void setConfigDir(const String& configDir);
 
     void setMode(ConfigPackageLoader::Mode mode);
     
+    ConfigPackageLoader::Mode getMode() const {
+        return configPackageLoader.getMode();
+    }
+    
     LuaVar requireConfigPackage(const String& packageName);
     
     LuaVar getGeneralConfigModule(const String& moduleName);
     
-    LuaVar getLoadedPackageModules() {
-        return LuaInterpreter::getCurrentLuaAccess().retrieve(loadedPackagesStoreReference);
-    }
+    LuaVar getLoadedPackageModules();
+
 private:
     friend class SingletonInstance<GlobalLuaInterpreter>;
     
@@ -57,6 +78,38 @@ private:
 
     GlobalLuaInterpreter();
     
+    class PackageDependency
+    {
+    public:
+        PackageDependency()
+        {}
+        PackageDependency(const String& packageName, const String& dependentPackageName)
+            : packageName(packageName),
+              dependentPackageName(dependentPackageName)
+        {}
+        String packageName; // empty for all packages
+        String dependentPackageName;
+    };
+    
+    class LoadingPackage
+    {
+    public:
+        LoadingPackage(RawPtr<GlobalLuaInterpreter> luaInterpreter, const String& packageName)
+            : luaInterpreter(luaInterpreter)
+        {
+            luaInterpreter->loadingPackageNames.append(packageName);
+        }
+        ~LoadingPackage() {
+            luaInterpreter->loadingPackageNames.removeLast();
+        }
+    private:
+        RawPtr<GlobalLuaInterpreter> luaInterpreter;
+    };
+    
+    void resetPackage(const String& packageName);
+    void registerPackageAccess(const String& packageName);
+    void clearPackageDependencies();
+    
     String modulesDir;
     
     static LuaCFunctionResult packageLocalRequireFunction(const LuaCFunctionArguments& args, 
@@ -72,6 +125,10 @@ private:
     LuaStoredObjectReference loadedPackagesStoreReference;
     
     ConfigPackageLoader configPackageLoader;
+    
+    ObjectArray<String>            loadingPackageNames;
+    ObjectArray<PackageDependency> packageDependencies;
+    bool                           untrackedPackageAccessFlag;
 };
 
 } // namespace LucED
@@ -28,6 +28,8 @@
 #include "SystemException.hpp"
 #include "GuiRootProperty.hpp"
 #include "System.hpp"
+#include "MemArray.hpp"
+#include "StartupTiming.hpp"
 
 #if LUCED_USE_XKBLIB
 #  include <X11/XKBlib.h>
@@ -41,8 +43,23 @@ SingletonInstance<GuiRoot> GuiRoot::instance;
 
 static char buffer[4000];
 
+struct GuiRoot_SerialRange
+{
+    unsigned long first;
+    unsigned long last;
+};
+
+static MemArray<GuiRoot_SerialRange> GuiRoot_ignoredRequests;
+
 static int myX11ErrorHandler(Display* display, XErrorEvent* errorEvent)
 {
+    for (int i = 0; i < GuiRoot_ignoredRequests.getLength(); ++i) {
+        if (   GuiRoot_ignoredRequests[i].first <= errorEvent->serial 
+            && errorEvent->serial <= GuiRoot_ignoredRequests[i].last)
+        {
+            return 0;
+        }
+    }
     XGetErrorText(display, errorEvent->error_code, buffer, sizeof(buffer));
     buffer[sizeof(buffer) - 1] = '\0';
     fprintf(stderr, "LucED: xlib error: %s\n", buffer);
@@ -54,6 +71,18 @@ static int myX11ErrorHandler(Display* display, XErrorEvent* errorEvent)
 
 static const char* KEYBOARD_WAS_AUTOREPEAT_PROPERTY_NAME = "LUCED_KEYBOARD_WAS_AUTOREPEAT";
 
+static const char* const GuiRoot_startupAtomNames[] =
+{
+    "UTF8_STRING",
+    "CLIPBOARD",
+    "TARGETS",
+    "INCR",
+    "WM_DELETE_WINDOW",
+    "_NET_ACTIVE_WINDOW",
+    "_NET_WM_NAME",
+    KEYBOARD_WAS_AUTOREPEAT_PROPERTY_NAME
+};
+
 static bool GuiRoot_knowsOriginalKeyboardMode = false;
 static bool GuiRoot_originalKeyboardModeWasAutoRepeat = true;
 static bool GuiRoot_wasKeyboardModeModified           = false;
@@ -111,6 +140,7 @@ GuiRoot::GuiRoot()
       hadDetecableAutorepeatFlag(false),
       detecableAutorepeatFlag(false),
       x11InputMethod(NULL),
+      isTrueColorFlag(false),
       hasInstanceNameFlag(false)
 {
     XSetErrorHandler(myX11ErrorHandler);
@@ -142,11 +172,14 @@ GuiRoot::GuiRoot()
         x11InputMethod = XOpenIM(display, NULL, NULL, NULL);
     }
 
-    x11AtomForUtf8String = XInternAtom(display, "UTF8_STRING", False);
+    internStartupAtoms();
+    x11AtomForUtf8String = getX11Atom("UTF8_STRING");
 
     screenId = XDefaultScreen(display);
     screen = XScreenOfDisplay(display, screenId);
     rootWid = WidgetId(XRootWindow(display, screenId));
+    
+    isTrueColorFlag = (DefaultVisual(display, screenId)->c_class == TrueColor);
 
     x11ServerVendorString  = XServerVendor(display);
     x11ServerVendorRelease = XVendorRelease(display);
@@ -154,6 +187,53 @@ GuiRoot::GuiRoot()
     evaluateConfig();
 
     GlobalConfig::getInstance()->registerConfigChangedCallback(newCallback(this, &GuiRoot::evaluateConfig));
+    
+    StartupTiming::reportPhase("display opened");
+}
+
+
+void GuiRoot::internStartupAtoms()
+{
+    const int numberOfAtoms = sizeof(GuiRoot_startupAtomNames) / sizeof(GuiRoot_startupAtomNames[0]);
+
+    Atom atoms[numberOfAtoms];
+    
+    if (XInternAtoms(display, const_cast<char**>(GuiRoot_startupAtomNames), numberOfAtoms, False, atoms))
+    {
+        for (int i = 0; i < numberOfAtoms; ++i) {
+            x11Atoms.set(GuiRoot_startupAtomNames[i], atoms[i]);
+        }
+    }
+}
+
+
+Atom GuiRoot::getX11Atom(const String& atomName)
+{
+    HashMap<String,Atom>::Value cached = x11Atoms.get(atomName);
+    if (cached.isValid()) {
+        return cached.get();
+    }
+    Atom rslt = XInternAtom(display, atomName.toCString(), False);
+    x11Atoms.set(atomName, rslt);
+    return rslt;
+}
+
+
+void GuiRoot::ignoreX11ErrorsForRequests(unsigned long firstSerial, unsigned long lastSerial)
+{
+    unsigned long processed = LastKnownRequestProcessed(display);
+
+    for (int i = 0; i < GuiRoot_ignoredRequests.getLength();) {
+        if (GuiRoot_ignoredRequests[i].last <= processed) {
+            GuiRoot_ignoredRequests.remove(i);
+        } else {
+            ++i;
+        }
+    }
+    GuiRoot_SerialRange r;
+                        r.first = firstSerial;
+                        r.last  = lastSerial;
+    GuiRoot_ignoredRequests.append(r);
 }
 
 GuiRoot::~GuiRoot()
@@ -169,7 +249,7 @@ GuiRoot::~GuiRoot()
         {
             // Delete RootProperty
          
-            Atom atom = XInternAtom(display, KEYBOARD_WAS_AUTOREPEAT_PROPERTY_NAME, False);
+            Atom atom = getX11Atom(KEYBOARD_WAS_AUTOREPEAT_PROPERTY_NAME);
             XDeleteProperty(display, rootWid, atom);
         }            
     }
@@ -185,33 +265,14 @@ void GuiRoot::evaluateConfig()
     blackColor = GuiColor(BlackPixel(display, screenId));
     whiteColor = GuiColor(WhitePixel(display, screenId));
 
-    XColor xcolor1_st, xcolor2_st;
-    
     XGetWindowAttributes(display, rootWid, &rootWinAttr);
 
-    XAllocNamedColor(display, rootWinAttr.colormap, "grey",
-            &xcolor1_st, &xcolor2_st);
-    greyColor  = GuiColor(xcolor1_st.pixel);
-    
-    XAllocNamedColor(display, rootWinAttr.colormap, GlobalConfig::getConfigData()->getGeneralConfig()->getGuiColor01().toCString(),
-            &xcolor1_st, &xcolor2_st);
-    guiColor01 = GuiColor(xcolor1_st.pixel);
-    
-    XAllocNamedColor(display, rootWinAttr.colormap, GlobalConfig::getConfigData()->getGeneralConfig()->getGuiColor02().toCString(),
-            &xcolor1_st, &xcolor2_st);
-    guiColor02 = GuiColor(xcolor1_st.pixel);
-    
-    XAllocNamedColor(display, rootWinAttr.colormap, GlobalConfig::getConfigData()->getGeneralConfig()->getGuiColor03().toCString(),
-            &xcolor1_st, &xcolor2_st);
-    guiColor03 = GuiColor(xcolor1_st.pixel);
-    
-    XAllocNamedColor(display, rootWinAttr.colormap, GlobalConfig::getConfigData()->getGeneralConfig()->getGuiColor04().toCString(),
-            &xcolor1_st, &xcolor2_st);
-    guiColor04 = GuiColor(xcolor1_st.pixel);
-
-    XAllocNamedColor(display, rootWinAttr.colormap, GlobalConfig::getConfigData()->getGeneralConfig()->getGuiColor05().toCString(),
-            &xcolor1_st, &xcolor2_st);
-    guiColor05 = GuiColor(xcolor1_st.pixel);
+    greyColor  = getGuiColor("grey");
+    guiColor01 = getGuiColor(GlobalConfig::getConfigData()->getGeneralConfig()->getGuiColor01());
+    guiColor02 = getGuiColor(GlobalConfig::getConfigData()->getGeneralConfig()->getGuiColor02());
+    guiColor03 = getGuiColor(GlobalConfig::getConfigData()->getGeneralConfig()->getGuiColor03());
+    guiColor04 = getGuiColor(GlobalConfig::getConfigData()->getGeneralConfig()->getGuiColor04());
+    guiColor05 = getGuiColor(GlobalConfig::getConfigData()->getGeneralConfig()->getGuiColor05());
 
     xkbExtensionFlag = false;
 #if LUCED_USE_XKBLIB
@@ -267,11 +328,75 @@ bool GuiRoot::setDetectableAutorepeat(bool flag)
 
 GuiColor GuiRoot::getGuiColor(const String& colorName)
 {
-    XColor xcolor1_st, xcolor2_st;
+    HashMap<String,GuiColor>::Value cached = guiColors.get(colorName);
+    if (cached.isValid()) {
+        return cached.get();
+    }
+    unsigned long pixel;
+    
+    if (!calculateTrueColorPixel(colorName, &pixel))
+    {
+        XColor xcolor1_st, xcolor2_st;
+    
+        XAllocNamedColor(display, rootWinAttr.colormap, colorName.toCString(),
+                &xcolor1_st, &xcolor2_st);
+        pixel = xcolor1_st.pixel;
+    }
+    GuiColor rslt(pixel);
+    guiColors.set(colorName, rslt);
+    return rslt;
+}
+
+
+namespace // anonymous namespace
+{
 
-    XAllocNamedColor(display, rootWinAttr.colormap, colorName.toCString(),
-            &xcolor1_st, &xcolor2_st);
-    return GuiColor(xcolor1_st.pixel);
+inline unsigned long scaleToMask(unsigned short value, unsigned long mask)
+{
+    if (mask == 0) {
+        return 0;
+    }
+    int shift = 0;
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        ++shift;
+    }
+    int bits = 0;
+    while ((mask & 1) != 0) {
+        mask >>= 1;
+        ++bits;
+    }
+    if (bits > 16) {
+        bits = 16;
+    }
+    return ((unsigned long)(value >> (16 - bits))) << shift;
+}
+
+} // anonymous namespace
+
+/**
+ * Numeric color specifications are parsed by Xlib without server
+ * round trip and the pixel value of a TrueColor visual can be
+ * calculated from the color masks.
+ */
+bool GuiRoot::calculateTrueColorPixel(const String& colorName, unsigned long* pixel)
+{
+    if (   !isTrueColorFlag 
+        || rootWinAttr.colormap != DefaultColormap(display, screenId)
+        || !(colorName.startsWith("#") || colorName.startsWith("rgb:")))
+    {
+        return false;
+    }
+    XColor xcolor;
+    if (!XParseColor(display, rootWinAttr.colormap, colorName.toCString(), &xcolor)) {
+        return false;
+    }
+    Visual* visual = DefaultVisual(display, screenId);
+    
+    *pixel = scaleToMask(xcolor.red,   visual->red_mask)
+           | scaleToMask(xcolor.green, visual->green_mask)
+           | scaleToMask(xcolor.blue,  visual->blue_mask);
+    return true;
 }
 
 void GuiRoot::setKeyboardAutoRepeatOn()
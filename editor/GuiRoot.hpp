@@ -28,6 +28,7 @@
 #include "GuiColor.hpp"
 #include "SingletonInstance.hpp"
 #include "Position.hpp"
+#include "HashMap.hpp"
           
 namespace LucED
 {
@@ -39,6 +40,9 @@ public:
     static GuiRoot* getInstance() {
         return instance.getPtr();
     }
+    static bool isInstanceValid() {
+        return instance.isValid();
+    }
     
     ~GuiRoot();
     
@@ -79,6 +83,10 @@ public:
     GuiColor getGuiColor04() const {return guiColor04;}
     GuiColor getGuiColor05() const {return guiColor05;}
     
+    /**
+     * Resolved colors are cached, numeric color names are resolved without 
+     * server round trip on TrueColor displays.
+     */
     GuiColor getGuiColor(const String& colorName);
 
     bool hasXkbExtension() const {
@@ -104,6 +112,19 @@ public:
     Atom getX11Utf8StringAtom() const {
         return x11AtomForUtf8String;
     }
+    /**
+     * The atoms used by LucED itself are interned together at startup,
+     * other atoms are interned on first use.
+     */
+    Atom getX11Atom(const String& atomName);
+    
+    /**
+     * X11 errors caused by the requests with the given serial numbers are 
+     * expected by the caller and are not reported, e.g. for fonts that are
+     * loaded asynchronously.
+     */
+    void ignoreX11ErrorsForRequests(unsigned long firstSerial, unsigned long lastSerial);
+    
     bool hasInstanceName() const {
         return hasInstanceNameFlag;
     }
@@ -124,6 +145,8 @@ private:
     GuiRoot();
     
     void evaluateConfig();
+    void internStartupAtoms();
+    bool calculateTrueColorPixel(const String& colorName, unsigned long* pixel);
     
     Display* display;
     XWindowAttributes  rootWinAttr;
@@ -151,6 +174,10 @@ private:
     XIM x11InputMethod;
     Atom x11AtomForUtf8String;
     
+    HashMap<String,Atom>     x11Atoms;
+    HashMap<String,GuiColor> guiColors;
+    bool                     isTrueColorFlag;
+    
     bool   hasInstanceNameFlag;
     String instanceName;
 };
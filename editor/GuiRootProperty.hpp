@@ -43,8 +43,7 @@ public:
         
     explicit GuiRootProperty(String propertyName)
     {
-        GuiRoot* root = GuiRoot::getInstance();
-        atom = XInternAtom(root->getDisplay(), propertyName.toCString(), False);
+        atom = GuiRoot::getInstance()->getX11Atom(propertyName);
     }
     
     explicit GuiRootProperty(Atom atom)
@@ -58,3 +58,25 @@ void HeapMem::increase(long plusAmount, long blockSize)
     capacity = new_cap;
 }
 
+long HeapMem::decreaseTo(long newCapacity)
+{
+    ASSERT(0 <= newCapacity);
+
+    if (newCapacity >= capacity) {
+        return 0;
+    }
+    long released = capacity - newCapacity;
+
+    if (newCapacity == 0) {
+        free(buffer);
+        buffer = NULL;
+    } else {
+        byte* ptr = (byte*) realloc(buffer, newCapacity);
+        if (ptr == NULL) {
+            return 0; // keeping the bigger block is fine
+        }
+        buffer = ptr;
+    }
+    capacity = newCapacity;
+    return released;
+}
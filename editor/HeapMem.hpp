@@ -90,6 +90,37 @@ public:
         }
     }
     
+    /**
+     * Shrink policy with hysteresis: the capacity is only reduced if less
+     * than a quarter of it is used and at least MIN_SHRINK_BYTES would be 
+     * released. The reduced capacity leaves room for doubling the used size,
+     * so that growing again does not immediately reallocate. With releaseAll
+     * the capacity is reduced to usedBytes.
+     */
+    long getShrinkedCapacity(long usedBytes, bool releaseAll = false) const {
+        ASSERT(0 <= usedBytes && usedBytes <= capacity);
+        if (releaseAll) {
+            return usedBytes;
+        }
+        else if (usedBytes < capacity / 4 && capacity - 2 * usedBytes >= MIN_SHRINK_BYTES) {
+            return 2 * usedBytes;
+        }
+        else {
+            return capacity;
+        }
+    }
+    bool isWorthShrinking(long usedBytes) const {
+        return getShrinkedCapacity(usedBytes) < capacity;
+    }
+    /**
+     * Returns the number of released bytes. The first usedBytes
+     * are preserved.
+     */
+    long shrink(long usedBytes, bool releaseAll = false) {
+        return decreaseTo(getShrinkedCapacity(usedBytes, releaseAll));
+    }
+    long decreaseTo(long newCapacity);
+    
     void replace(long dstPos, const byte* src, long srcLen) {
         ASSERT(0 <= srcLen);
         ASSERT(0 <= dstPos && dstPos + srcLen <= capacity);
@@ -117,6 +148,8 @@ public:
     }
     
 private:
+    static const long MIN_SHRINK_BYTES = 64 * 1024;
+
     long  capacity;
     byte* buffer;
 };
@@ -37,6 +37,7 @@
 #include "RawPointable.hpp"
 #include "Nullable.hpp"
 #include "StackTrace.hpp"
+#include "HeapObjectAllocator.hpp"
 
 #undef HEAP_OBJECT_USES_DYNAMIC_CAST
 //#define PRINT_MALLOCS
@@ -70,6 +71,7 @@ private:
     friend class HeapObjectBase;
     friend class HeapObjectRefManipulator;
     HeapObjectCounters() : wasNeverOwned(true),
+                           sizeClass(0),
                            weakCounter(0), 
                            strongCounter(1)
 #ifdef DEBUG
@@ -84,7 +86,11 @@ private:
 #endif
         wasNeverOwned = false;
     }
+    static void deallocate(HeapObjectCounters* counters) {
+        HeapObjectAllocator::deallocate(counters, counters->sizeClass);
+    }
     bool wasNeverOwned;
+    unsigned char sizeClass;
     int weakCounter;
     int strongCounter;
 #ifdef DEBUG
@@ -141,9 +147,11 @@ public:
 protected:
     
     void* operator new(size_t size) {
+        unsigned char sizeClass;
         HeapObjectCounters* allocated = static_cast<HeapObjectCounters*>(
-                malloc(sizeof(HeapObjectCounters) + size));
+                HeapObjectAllocator::allocate(sizeof(HeapObjectCounters) + size, &sizeClass));
         new(allocated) HeapObjectCounters();
+        allocated->sizeClass = sizeClass;
     #ifdef PRINT_MALLOCS
         printf("----> HeapObjectBase %p : allocating %8.d bytes \n", allocated + 1, size);
         printf("***** HeapObjects allocated: %d \n", HeapObjectChecker::allocCounter - HeapObjectChecker::destructCounter);
@@ -174,10 +182,11 @@ protected:
         }
         else
         {
+            unsigned char sizeClass = counters->sizeClass;
         #ifdef DEBUG
             memset(counters, 'X', size + sizeof(HeapObjectCounters));
         #endif
-            free(counters);
+            HeapObjectAllocator::deallocate(counters, sizeClass);
         }
     #ifdef DEBUG
         HeapObjectChecker::allocCounter -= 1;
@@ -220,6 +229,9 @@ protected:
             ASSERT(heapObjectCounters->strongCounter >= 1); // normal == 1, >= 1 after resetInitialOwnership
 
             heapObjectCounters->wasNeverOwned = false;
+    #if LUCED_USE_HEAP_OBJECT_STATISTICS
+            HeapObjectAllocator::countInstance(typeid(*obj).name(), heapObjectCounters->sizeClass);
+    #endif
         }
     }
     static void resetInitialOwnership(const HeapObjectBase* obj) {
@@ -264,7 +276,7 @@ protected:
                     #ifdef PRINT_MALLOCS
                     printf("----> HeapObjectBase %p : deleting\n", counters + 1);
                     #endif
-                    free(counters);
+                    HeapObjectCounters::deallocate(counters);
                 } else {
                     counters->strongCounter -= 1;
                 }
@@ -299,7 +311,7 @@ protected:
                 printf("----> HeapObjectBase %p : deleting\n", counters + 1);
                 #endif
                 counters->clear();
-                free(counters);
+                HeapObjectCounters::deallocate(counters);
             }
         }
     }
@@ -0,0 +1,206 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <new>
+#include <map>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "HeapObjectAllocator.hpp"
+
+using namespace LucED;
+
+#if LUCED_USE_HEAP_OBJECT_POOL
+
+HeapObjectAllocator::FreeEntry* HeapObjectAllocator::freeLists[NUMBER_OF_SIZE_CLASSES + 1];
+long                            HeapObjectAllocator::pooledBytes = 0;
+
+#if LUCED_USE_MULTI_THREAD
+
+bool                            HeapObjectAllocator::mainThreadKnown = false;
+pthread_t                       HeapObjectAllocator::mainThread;
+
+pthread_mutex_t                 HeapObjectAllocator::foreignMutex = PTHREAD_MUTEX_INITIALIZER;
+HeapObjectAllocator::FreeEntry* HeapObjectAllocator::foreignFreeLists[NUMBER_OF_SIZE_CLASSES + 1];
+volatile bool                   HeapObjectAllocator::hasForeignFreeEntries = false;
+
+
+/**
+ * The first HeapObject is allocated during static initialization,
+ * i.e. before any other thread is started.
+ */
+bool HeapObjectAllocator::recordMainThread()
+{
+    mainThread      = pthread_self();
+    mainThreadKnown = true;
+    return true;
+}
+
+#endif // LUCED_USE_MULTI_THREAD
+
+
+void HeapObjectAllocator::deallocateForeign(FreeEntry* entry, unsigned char sizeClass)
+{
+#if LUCED_USE_MULTI_THREAD
+    pthread_mutex_lock(&foreignMutex);
+    {
+        entry->next = foreignFreeLists[sizeClass];
+        foreignFreeLists[sizeClass] = entry;
+        hasForeignFreeEntries = true;
+    }
+    pthread_mutex_unlock(&foreignMutex);
+#endif
+}
+
+
+HeapObjectAllocator::FreeEntry* HeapObjectAllocator::refill(size_t sizeClass)
+{
+#if LUCED_USE_MULTI_THREAD
+    if (hasForeignFreeEntries)
+    {
+        pthread_mutex_lock(&foreignMutex);
+        {
+            for (int c = 1; c <= NUMBER_OF_SIZE_CLASSES; ++c)
+            {
+                FreeEntry* e = foreignFreeLists[c];
+                while (e != NULL) {
+                    FreeEntry* next = e->next;
+                    e->next = freeLists[c];
+                    freeLists[c] = e;
+                    e = next;
+                }
+                foreignFreeLists[c] = NULL;
+            }
+            hasForeignFreeEntries = false;
+        }
+        pthread_mutex_unlock(&foreignMutex);
+        
+        if (freeLists[sizeClass] != NULL) {
+            return freeLists[sizeClass];
+        }
+    }
+#endif
+    // blocks are never given back, the entries are reused for
+    // objects of the same size class
+
+    const size_t entrySize = sizeClass * GRANULARITY;
+    const size_t count     = BLOCK_SIZE / entrySize;
+
+    char* block = static_cast<char*>(malloc(count * entrySize));
+    if (block == NULL) {
+        throw std::bad_alloc();
+    }
+    pooledBytes += count * entrySize;
+    FreeEntry* rslt = NULL;
+    
+    for (size_t i = count; i > 0; --i) {
+        FreeEntry* e = reinterpret_cast<FreeEntry*>(block + (i - 1) * entrySize);
+        e->next = rslt;
+        rslt = e;
+    }
+    freeLists[sizeClass] = rslt;
+    return rslt;
+}
+
+#endif // LUCED_USE_HEAP_OBJECT_POOL
+
+
+#if LUCED_USE_HEAP_OBJECT_STATISTICS
+
+namespace // anonymous namespace
+{
+
+struct InstanceCounter
+{
+    InstanceCounter()
+        : count(0), sizeClass(0)
+    {}
+    long count;
+    int  sizeClass;
+};
+
+typedef std::map<std::string, InstanceCounter> InstanceCounters;
+
+InstanceCounters* instanceCounters = NULL;
+
+#if LUCED_USE_MULTI_THREAD
+pthread_mutex_t statisticsMutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+bool isMoreFrequent(const InstanceCounters::value_type* lhs, const InstanceCounters::value_type* rhs)
+{
+    return lhs->second.count > rhs->second.count;
+}
+
+void printStatisticsAtExit()
+{
+    HeapObjectAllocator::printStatistics();
+}
+
+} // anonymous namespace
+
+
+void HeapObjectAllocator::countInstance(const char* className, unsigned char sizeClass)
+{
+#if LUCED_USE_MULTI_THREAD
+    pthread_mutex_lock(&statisticsMutex);
+#endif
+    if (instanceCounters == NULL) {
+        instanceCounters = new InstanceCounters();
+        atexit(&printStatisticsAtExit);
+    }
+    InstanceCounter& counter = (*instanceCounters)[className];
+    counter.count    += 1;
+    counter.sizeClass = sizeClass;
+#if LUCED_USE_MULTI_THREAD
+    pthread_mutex_unlock(&statisticsMutex);
+#endif
+}
+
+
+/**
+ * Prints the number of created instances per class to stderr,
+ * most frequently created classes first.
+ */
+void HeapObjectAllocator::printStatistics()
+{
+    if (instanceCounters == NULL) {
+        return;
+    }
+    std::vector<const InstanceCounters::value_type*> sorted;
+    
+    for (InstanceCounters::const_iterator i = instanceCounters->begin(); i != instanceCounters->end(); ++i) {
+        sorted.push_back(&*i);
+    }
+    std::sort(sorted.begin(), sorted.end(), &isMoreFrequent);
+    
+    fprintf(stderr, "HeapObject instances   size (0: malloc)   class\n");
+    
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        fprintf(stderr, "%20ld   %17d   %s\n", sorted[i]->second.count, 
+                                              sorted[i]->second.sizeClass * GRANULARITY,
+                                              sorted[i]->first.c_str());
+    }
+}
+
+#endif // LUCED_USE_HEAP_OBJECT_STATISTICS
@@ -0,0 +1,149 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HEAP_OBJECT_ALLOCATOR_HPP
+#define HEAP_OBJECT_ALLOCATOR_HPP
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "config.h"
+
+#if LUCED_USE_PTHREAD
+#  include <pthread.h>
+#endif
+
+namespace LucED
+{
+
+/**
+ * Size class pool for the storage of HeapObjects and their counters.
+ *
+ * Small objects are taken from free lists per size class that are
+ * refilled in larger blocks. The pool belongs to the main thread:
+ * other threads allocate with malloc and give pooled storage back
+ * through a locked list that is merged by the main thread.
+ *
+ * Size class 0 stands for storage obtained by malloc.
+ */
+class HeapObjectAllocator
+{
+public:
+    static void* allocate(size_t size, unsigned char* sizeClass)
+    {
+    #if LUCED_USE_HEAP_OBJECT_POOL
+        size_t c = (size + GRANULARITY - 1) / GRANULARITY;
+        
+        if (c <= NUMBER_OF_SIZE_CLASSES && isMainThread())
+        {
+            FreeEntry* rslt = freeLists[c];
+            if (rslt == NULL) {
+                rslt = refill(c);
+            }
+            freeLists[c] = rslt->next;
+            *sizeClass = (unsigned char) c;
+            return rslt;
+        }
+    #endif
+        *sizeClass = 0;
+        return malloc(size);
+    }
+    
+    static void deallocate(void* ptr, unsigned char sizeClass)
+    {
+    #if LUCED_USE_HEAP_OBJECT_POOL
+        if (sizeClass != 0)
+        {
+            FreeEntry* entry = static_cast<FreeEntry*>(ptr);
+            
+            if (isMainThread()) {
+                entry->next = freeLists[sizeClass];
+                freeLists[sizeClass] = entry;
+            } else {
+                deallocateForeign(entry, sizeClass);
+            }
+            return;
+        }
+    #endif
+        free(ptr);
+    }
+
+    static long getPooledBytes()
+    {
+    #if LUCED_USE_HEAP_OBJECT_POOL
+        return pooledBytes;
+    #else
+        return 0;
+    #endif
+    }
+
+#if LUCED_USE_HEAP_OBJECT_STATISTICS
+    static void countInstance(const char* className, unsigned char sizeClass);
+    static void printStatistics();
+#endif
+
+private:
+    enum 
+    {
+        GRANULARITY            = 16,
+        NUMBER_OF_SIZE_CLASSES = 16,
+        BLOCK_SIZE             = 64 * 1024
+    };
+    
+    struct FreeEntry
+    {
+        FreeEntry* next;
+    };
+    
+#if LUCED_USE_HEAP_OBJECT_POOL
+    static bool isMainThread()
+    {
+    #if LUCED_USE_MULTI_THREAD
+        if (!mainThreadKnown) {
+            return recordMainThread();
+        }
+        return pthread_equal(pthread_self(), mainThread) != 0;
+    #else
+        return true;
+    #endif
+    }
+    
+    static FreeEntry* refill(size_t sizeClass);
+    static void       deallocateForeign(FreeEntry* entry, unsigned char sizeClass);
+
+    static FreeEntry* freeLists[NUMBER_OF_SIZE_CLASSES + 1];
+    static long       pooledBytes;
+
+#if LUCED_USE_MULTI_THREAD
+    static bool      recordMainThread();
+    static bool      mainThreadKnown;
+    static pthread_t mainThread;
+    
+    static pthread_mutex_t foreignMutex;
+    static FreeEntry*      foreignFreeLists[NUMBER_OF_SIZE_CLASSES + 1];
+    static volatile bool   hasForeignFreeEntries;
+#endif
+#endif // LUCED_USE_HEAP_OBJECT_POOL
+};
+
+} // namespace LucED
+
+#endif // HEAP_OBJECT_ALLOCATOR_HPP
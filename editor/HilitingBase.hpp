@@ -229,6 +229,15 @@ public:
         I->breakIndex    += 1;
         ASSERT(getIteratorData(iterator)->textStartPos >= 0);
     }
+    long getNumberOfBreaks() const {
+        return breaks.getLength();
+    }
+    long getAllocatedBytes() const {
+        return breaks.getCapacityInBytes() + stack.getCapacityInBytes() + iterators.getCapacityInBytes();
+    }
+    long compactMemory(bool releaseAll = false) {
+        return breaks.compact(releaseAll) + stack.compact(releaseAll);
+    }
     bool isFirstBreak(IteratorHandle iterator) const {
         return getIteratorData(iterator)->breakIndex == 0;
     }
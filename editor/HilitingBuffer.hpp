@@ -86,6 +86,10 @@ public:
     HilitedText::Ptr getHilitedText() const {
         return hilitedText;
     }
+    
+    long getAllocatedBytes() const {
+        return styleBuffer.getCapacityInBytes() + ovector.getCapacityInBytes();
+    }
 
 private:
     
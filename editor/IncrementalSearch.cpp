@@ -0,0 +1,235 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "IncrementalSearch.hpp"
+#include "EventDispatcher.hpp"
+#include "RegexException.hpp"
+#include "LuaException.hpp"
+#include "util.hpp"
+
+using namespace LucED;
+
+namespace // anonymous namespace
+{
+
+/**
+ * Chunks are extended to line boundaries, matches spanning 
+ * several lines may be missed at the chunk borders.
+ */
+const long CHUNK_LENGTH = 64 * 1024;
+
+} // anonymous namespace
+
+
+IncrementalSearch::IncrementalSearch(RawPtr<TextData>              textData,
+                                     Callback<const Result&>::Ptr  resultCallback,
+                                     Callback<long,int>::Ptr       progressCallback)
+    : textData(textData),
+      resultCallback(resultCallback),
+      progressCallback(progressCallback),
+      processHandler(ProcessHandler::create(this, &IncrementalSearch::process,
+                                                  &IncrementalSearch::needsProcessing)),
+      findUtil(textData),
+      generation(0),
+      runningFlag(false),
+      forwardFlag(true),
+      wrappedFlag(false),
+      startPos(0),
+      pos(0),
+      searchedLength(0),
+      reportedPercent(-1)
+{
+    textData->registerUpdateListener(newCallback(this, &IncrementalSearch::treatTextDataUpdate));
+    EventDispatcher::getInstance()->registerProcess(processHandler);
+}
+
+
+IncrementalSearch::~IncrementalSearch()
+{
+    processHandler->disable();
+}
+
+
+long IncrementalSearch::start(const SearchParameter& p, long startPos)
+{
+    ++generation;
+    
+    SearchParameter forwardParameter = p;
+                    forwardParameter.setSearchForwardFlag(true);
+                    forwardParameter.setAllowMatchAtStartOfSearchFlag(true);
+
+    findUtil.setParameter(forwardParameter);
+
+    this->forwardFlag     = p.hasSearchForwardFlag();
+    this->startPos        = util::minimum(util::maximum(0L, startPos), textData->getLength());
+    this->pos             = this->startPos;
+    this->wrappedFlag     = false;
+    this->searchedLength  = 0;
+    this->reportedPercent = -1;
+    this->runningFlag     = (p.getFindString().getLength() > 0);
+
+    if (!runningFlag) {
+        resultCallback->call(Result(generation));
+    }
+    return generation;
+}
+
+
+void IncrementalSearch::cancel()
+{
+    if (runningFlag) {
+        runningFlag = false;
+        ++generation;
+    }
+}
+
+
+void IncrementalSearch::treatTextDataUpdate(TextData::UpdateInfo update)
+{
+    if (runningFlag)
+    {
+        startPos        = util::minimum(startPos, textData->getLength());
+        pos             = startPos;
+        wrappedFlag     = false;
+        searchedLength  = 0;
+    }
+}
+
+
+bool IncrementalSearch::needsProcessing()
+{
+    return runningFlag;
+}
+
+
+int IncrementalSearch::process(TimeStamp endTime)
+{
+    try
+    {
+        do
+        {
+            if (searchNextChunk()) {
+                return 0;
+            }
+        }
+        while (TimeStamp::now() < endTime);
+    }
+    catch (RegexException& ex) {
+        finish(Result(generation, String() << "Error within regular expression: " << ex.getMessage()));
+        return 0;
+    }
+    catch (LuaException& ex) {
+        finish(Result(generation, ex.getMessage()));
+        return 0;
+    }
+    long totalLength = textData->getLength();
+    int  percent     = (totalLength > 0) ? (int)((100.0 * searchedLength) / totalLength) : 100;
+    
+    if (percent != reportedPercent) {
+        reportedPercent = percent;
+        progressCallback->call(generation, percent);
+    }
+    return 0;
+}
+
+
+/**
+ * Returns true if the search is finished.
+ */
+bool IncrementalSearch::searchNextChunk()
+{
+    long length = textData->getLength();
+    
+    if (forwardFlag)
+    {
+        long limit = wrappedFlag ? startPos : length;
+
+        if (pos >= limit)
+        {
+            if (wrappedFlag || startPos == 0) {
+                finish(Result(generation));
+                return true;
+            }
+            wrappedFlag = true;
+            pos         = 0;
+            return false;
+        }
+        long chunkEnd = util::minimum(limit, textData->getThisLineEnding(util::minimum(length, pos + CHUNK_LENGTH)));
+        
+        findUtil.setTextPosition(pos);
+        findUtil.setMaximalEndOfMatchPosition(chunkEnd);
+        findUtil.findNext();
+        
+        if (findUtil.wasFound()) {
+            finish(Result(generation, findUtil.getMatchBeginPos(), findUtil.getMatchEndPos()));
+            return true;
+        }
+        searchedLength += chunkEnd - pos;
+        pos = chunkEnd;
+    }
+    else
+    {
+        long limit = wrappedFlag ? startPos : 0;
+        
+        if (pos <= limit)
+        {
+            if (wrappedFlag || startPos == length) {
+                finish(Result(generation));
+                return true;
+            }
+            wrappedFlag = true;
+            pos         = length;
+            return false;
+        }
+        long chunkBegin = util::maximum(limit, textData->getThisLineBegin(util::maximum(0L, pos - CHUNK_LENGTH)));
+        long matchBegin = -1;
+        long matchEnd   = -1;
+        
+        // backward: the last match within the chunk
+
+        findUtil.setMaximalEndOfMatchPosition(pos);
+        findUtil.setTextPosition(chunkBegin);
+        findUtil.findNext();
+
+        while (findUtil.wasFound() && findUtil.getMatchBeginPos() < pos)
+        {
+            matchBegin = findUtil.getMatchBeginPos();
+            matchEnd   = findUtil.getMatchEndPos();
+            
+            findUtil.setTextPosition(textData->getNextWCharPos(matchBegin));
+            findUtil.findNext();
+        }
+        if (matchBegin >= 0) {
+            finish(Result(generation, matchBegin, matchEnd));
+            return true;
+        }
+        searchedLength += pos - chunkBegin;
+        pos = chunkBegin;
+    }
+    return false;
+}
+
+
+void IncrementalSearch::finish(const Result& result)
+{
+    runningFlag = false;
+    resultCallback->call(result);
+}
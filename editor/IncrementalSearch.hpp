@@ -0,0 +1,143 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCREMENTAL_SEARCH_HPP
+#define INCREMENTAL_SEARCH_HPP
+
+#include "HeapObject.hpp"
+#include "OwningPtr.hpp"
+#include "RawPtr.hpp"
+#include "Callback.hpp"
+#include "String.hpp"
+#include "TimeStamp.hpp"
+#include "ProcessHandler.hpp"
+#include "TextData.hpp"
+#include "FindUtil.hpp"
+#include "SearchParameter.hpp"
+
+namespace LucED
+{
+
+/**
+ * Searches in time slices of the EventDispatcher, so that typing is not 
+ * blocked by an expensive search. 
+ *
+ * Each call of start() supersedes the running search and returns a new 
+ * generation number. Results and progress are reported with the 
+ * generation of the search they belong to. If the text is changed while 
+ * searching, the search is restarted.
+ */
+class IncrementalSearch : public HeapObject
+{
+public:
+    typedef OwningPtr<IncrementalSearch> Ptr;
+    
+    class Result
+    {
+    public:
+        explicit Result(long generation)
+            : generation(generation),
+              foundFlag(false),
+              beginPos(-1),
+              endPos(-1)
+        {}
+        Result(long generation, long beginPos, long endPos)
+            : generation(generation),
+              foundFlag(true),
+              beginPos(beginPos),
+              endPos(endPos)
+        {}
+        Result(long generation, const String& errorMessage)
+            : generation(generation),
+              foundFlag(false),
+              beginPos(-1),
+              endPos(-1),
+              errorMessage(errorMessage)
+        {}
+        bool wasFound() const {
+            return foundFlag;
+        }
+        bool hasError() const {
+            return errorMessage.getLength() > 0;
+        }
+        long   generation;
+        bool   foundFlag;
+        long   beginPos;
+        long   endPos;
+        String errorMessage;
+    };
+    
+    static Ptr create(RawPtr<TextData>              textData,
+                      Callback<const Result&>::Ptr  resultCallback,
+                      Callback<long,int>::Ptr       progressCallback)
+    {
+        return Ptr(new IncrementalSearch(textData, resultCallback, progressCallback));
+    }
+    
+    ~IncrementalSearch();
+    
+    /**
+     * Starts searching at startPos in the direction given by p,
+     * wrapping around at the end of the text.
+     */
+    long start(const SearchParameter& p, long startPos);
+
+    void cancel();
+    
+    bool isRunning() const {
+        return runningFlag;
+    }
+    long getGeneration() const {
+        return generation;
+    }
+    
+private:
+    IncrementalSearch(RawPtr<TextData>              textData,
+                      Callback<const Result&>::Ptr  resultCallback,
+                      Callback<long,int>::Ptr       progressCallback);
+    
+    bool needsProcessing();
+    int  process(TimeStamp endTime);
+    
+    bool searchNextChunk();
+    void finish(const Result& result);
+    
+    void treatTextDataUpdate(TextData::UpdateInfo update);
+
+    RawPtr<TextData>             textData;
+    Callback<const Result&>::Ptr resultCallback;
+    Callback<long,int>::Ptr      progressCallback;
+    ProcessHandler::Ptr          processHandler;
+    FindUtil                     findUtil;
+    
+    long generation;
+    bool runningFlag;
+    bool forwardFlag;
+    bool wrappedFlag;
+    long startPos;
+    long pos;
+    long searchedLength;
+    int  reportedPercent;
+};
+
+} // namespace LucED
+
+#endif // INCREMENTAL_SEARCH_HPP
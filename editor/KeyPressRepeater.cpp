@@ -23,6 +23,7 @@
 
 #include "KeyPressRepeater.hpp"
 #include "GlobalConfig.hpp"
+#include "util.hpp"
 
 using namespace LucED;
 
@@ -30,25 +31,71 @@ SingletonInstance<KeyPressRepeater> KeyPressRepeater::instance;
 
 
 
+namespace // anonymous namespace
+{
+
+/**
+ * A batch of overdue repeats should not block the event 
+ * processing for longer than this.
+ */
+const long MAX_BATCH_MICRO_SECS = 100 * 1000;
+
+inline long getMicroSecs(const TimePeriod& p)
+{
+    return p.getSeconds() * 1000L * 1000L + p.getMicroSeconds();
+}
+
+} // anonymous namespace
+
+
 KeyPressRepeater::KeyPressRepeater()
-    : eventRepeatingCallback(newCallback(this, &KeyPressRepeater::processRepeatingEvent))
+    : eventRepeatingCallback(newCallback(this, &KeyPressRepeater::processRepeatingEvent)),
+      averageRepeatMicroSecs(0)
 {
     isRepeatingFlag = false;
 }
 
+/**
+ * Repeats are scheduled at fixed intervals from the first repeat on, so
+ * that the number of repeats follows the time the key is held down. 
+ * Repeats that are overdue because the editor is slower than the repeat
+ * rate are processed in one batch. If even a batch cannot catch up, the
+ * backlog is dropped so that the editor stops as soon as the key is released.
+ */
 void KeyPressRepeater::processRepeatingEvent()
 {
     TimeStamp now = TimeStamp::now();
     
-    if (isRepeatingFlag && now > when.get())
+    if (isRepeatingFlag && now >= when.get())
     {
-        ++repeatCount;
+        long intervalMicroSecs = util::maximum(1L, (long)(1000 * GlobalConfig::getConfigData()->getGeneralConfig()
+                                                                                      ->getKeyPressRepeatNextMilliSecs()));
+
+        long overdueCount = 1 + getMicroSecs(now - when.get()) / intervalMicroSecs;
+        long maxCount     = 1;
+
+        if (averageRepeatMicroSecs > 0) {
+            maxCount = util::maximum(1L, MAX_BATCH_MICRO_SECS / averageRepeatMicroSecs);
+        } 
+        long count = util::minimum(overdueCount, maxCount);
         
-        TopWin::AccessForKeyPressRepeater::repeat(repeatingTopWin, triggeredKeyCode, &event);
-        //EventDispatcher::getInstance()->processEvent(&event);
+        TimeStamp nextWhen = (count < overdueCount) ? now : when.get();
+                  nextWhen += MicroSeconds(count * intervalMicroSecs);
+
+        this->when = nextWhen;
+        EventDispatcher::getInstance()->registerTimerCallback(nextWhen, eventRepeatingCallback);
         
-//        TimeStamp when = TimeStamp::now();
-//        EventDispatcher::getInstance()->registerTimerCallback();
+        repeatCount += count;
+
+        TopWin::AccessForKeyPressRepeater::repeat(repeatingTopWin, triggeredKeyCode, &event, count);
+        
+        long repeatMicroSecs = getMicroSecs(TimeStamp::now() - now) / count;
+        
+        if (averageRepeatMicroSecs == 0) {
+            averageRepeatMicroSecs = util::maximum(1L, repeatMicroSecs);
+        } else {
+            averageRepeatMicroSecs = util::maximum(1L, (3 * averageRepeatMicroSecs + repeatMicroSecs) / 4);
+        }
     }
 }
 
@@ -74,6 +74,7 @@ private:
     bool isRepeatingFlag;
     
     Nullable<TimeStamp> when;
+    long averageRepeatMicroSecs;
     
     RawPtr<TopWin> repeatingTopWin;
     unsigned int triggeredKeyCode;
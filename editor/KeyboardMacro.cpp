@@ -0,0 +1,78 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "KeyboardMacro.hpp"
+
+using namespace LucED;
+
+SingletonInstance<KeyboardMacro> KeyboardMacro::instance;
+
+
+KeyboardMacro* KeyboardMacro::getInstance()
+{
+    return instance.getPtr();
+}
+
+
+void KeyboardMacro::startRecording()
+{
+    recordedSteps.clear();
+    recordingFlag = true;
+}
+
+
+void KeyboardMacro::stopRecording()
+{
+    if (recordingFlag) {
+        recordingFlag = false;
+        steps = recordedSteps;
+        recordedSteps.clear();
+    }
+}
+
+
+bool KeyboardMacro::isMacroAction(ActionId actionId)
+{
+    return actionId == ActionId::TOGGLE_MACRO_RECORDING
+        || actionId == ActionId::REPLAY_MACRO
+        || actionId == ActionId::REPLAY_MACRO_TO_END_OF_FILE;
+}
+
+
+void KeyboardMacro::recordAction(ActionId actionId)
+{
+    if (recordingFlag && !replayingFlag && !isMacroAction(actionId)) {
+        recordedSteps.append(Step(actionId));
+    }
+}
+
+
+void KeyboardMacro::recordInsertedText(const String& text)
+{
+    if (recordingFlag && !replayingFlag && text.getLength() > 0)
+    {
+        if (recordedSteps.getLength() > 0 && !recordedSteps.getLast().isAction()) {
+            recordedSteps.getLast().insertedText << text;
+        } else {
+            recordedSteps.append(Step(text));
+        }
+    }
+}
@@ -0,0 +1,118 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef KEYBOARD_MACRO_HPP
+#define KEYBOARD_MACRO_HPP
+
+#include "HeapObject.hpp"
+#include "SingletonInstance.hpp"
+#include "ObjectArray.hpp"
+#include "ActionId.hpp"
+#include "String.hpp"
+
+namespace LucED
+{
+
+/**
+ * The keyboard macro that was recorded last. 
+ *
+ * A macro is a sequence of text editor action ids and of inserted
+ * keyboard input. Consecutive keyboard input is recorded as one step.
+ * The macro is shared by all editor windows.
+ */
+class KeyboardMacro : public HeapObject
+{
+public:
+    static KeyboardMacro* getInstance();
+
+    class Step
+    {
+    public:
+        Step()
+        {}
+        explicit Step(ActionId actionId)
+            : actionId(actionId)
+        {}
+        explicit Step(const String& insertedText)
+            : insertedText(insertedText)
+        {}
+        bool isAction() const {
+            return actionId.isValid();
+        }
+        ActionId getActionId() const {
+            return actionId;
+        }
+        const String& getInsertedText() const {
+            return insertedText;
+        }
+    private:
+        friend class KeyboardMacro;
+        ActionId actionId;
+        String   insertedText;
+    };
+
+    bool isRecording() const {
+        return recordingFlag;
+    }
+    void startRecording();
+    void stopRecording();
+    
+    static bool isMacroAction(ActionId actionId);
+    
+    /**
+     * Steps invoked while the macro is replayed are not recorded,
+     * e.g. if the last macro is replayed during a new recording.
+     */
+    void setReplaying(bool replayingFlag) {
+        this->replayingFlag = replayingFlag;
+    }
+    
+    void recordAction(ActionId actionId);
+    void recordInsertedText(const String& text);
+
+    bool hasSteps() const {
+        return steps.getLength() > 0;
+    }
+    int getNumberOfSteps() const {
+        return steps.getLength();
+    }
+    const Step& getStep(int i) const {
+        return steps[i];
+    }
+
+private:
+    friend class SingletonInstance<KeyboardMacro>;
+    static SingletonInstance<KeyboardMacro> instance;
+    
+    KeyboardMacro()
+        : recordingFlag(false),
+          replayingFlag(false)
+    {}
+    
+    bool              recordingFlag;
+    bool              replayingFlag;
+    ObjectArray<Step> steps;
+    ObjectArray<Step> recordedSteps;
+};
+
+} // namespace LucED
+
+#endif // KEYBOARD_MACRO_HPP
@@ -46,59 +46,139 @@ String LanguageModeSelectors::getLanguageModeNameForFileName(const String& fileN
     for (int i = 0; i < selectors.getLength(); ++i)
     {
         Nullable<BasicRegex> re = selectors[i]->getFileNameRegex();
-        if (re.isValid()) {
-            bool matched = re.get().findMatch(fileName.toCString(), fileName.getLength(), 0, BasicRegex::MatchOptions(), ovector);
-            if (matched && ovector[0] == 0 && ovector[1] == fileName.getLength()) {
-                return selectors[i]->getLanguageMode();
-            }
+        if (re.isValid() && matchesFileName(re.get(), fileName)) {
+            return selectors[i]->getLanguageMode();
         }
     }
     return "default";
 }
 
-LanguageModeSelectors::Result LanguageModeSelectors::getResultForFileNameAndContent(const String& fileName, RawPtr<const ByteBuffer> fileContent)
+bool LanguageModeSelectors::matchesFileName(const BasicRegex& regex, const String& fileName)
+{
+    bool matched = regex.findMatch(fileName.toCString(), fileName.getLength(), 0, BasicRegex::MatchOptions(), ovector);
+
+    return matched && ovector[0] == 0 && ovector[1] == fileName.getLength();
+}
+
+
+bool LanguageModeSelectors::matchesContentRange(const BasicRegex& regex, RawPtr<const ByteBuffer> fileContent, 
+                                                long beginPos, long endPos, BasicRegex::MatchOptions options, String* encoding)
+{
+    const char* subject = (const char*) fileContent->getAmount(beginPos, endPos - beginPos);
+    
+    bool matched = regex.findMatch(subject, endPos - beginPos, 0, options, ovector);
+    if (matched)
+    {
+        try
+        {
+            int i = regex.getCaptureNumberByName("ENCODING");
+            if (i > 0) {
+                int p1 = ovector[2*i];
+                int p2 = ovector[2*i + 1];
+                if (p1 >= 0 && p2 > p1) {
+                    *encoding = String(subject + p1, p2 - p1);
+                }
+            }
+        }
+        catch (RegexException& ex)
+        {}
+    }
+    return matched;
+}
+
+
+/**
+ * For big files only the head and the tail of the content are 
+ * matched, so that the detection time does not depend on the file size.
+ */
+bool LanguageModeSelectors::matchesContent(const BasicRegex& regex, RawPtr<const ByteBuffer> fileContent, String* encoding)
+{
+    long length = fileContent->getLength();
+    
+    if (contentDetectionLength <= 0 || length <= 2 * contentDetectionLength) {
+        return matchesContentRange(regex, fileContent, 0, length, BasicRegex::MatchOptions(), encoding);
+    }
+    long headEnd = contentDetectionLength;
+    
+    while (headEnd > 0 && ((*fileContent)[headEnd] & 0xC0) == 0x80) {
+        --headEnd; // keep UTF-8 sequences complete
+    }
+    BasicRegex::MatchOptions headOptions;
+                             headOptions |= BasicRegex::NOTEOL;
+
+    if (matchesContentRange(regex, fileContent, 0, headEnd, headOptions, encoding)) {
+        return true;
+    }
+    long tailBegin     = length - contentDetectionLength;
+    long p             = tailBegin;
+    bool isAtLineBegin = ((*fileContent)[p - 1] == '\n');
+    
+    while (!isAtLineBegin && p < length) {
+        if ((*fileContent)[p++] == '\n') {
+            tailBegin     = p;
+            isAtLineBegin = true;
+        }
+    }
+    while (tailBegin < length && ((*fileContent)[tailBegin] & 0xC0) == 0x80) {
+        ++tailBegin;
+    }
+    BasicRegex::MatchOptions tailOptions;
+    if (!isAtLineBegin) {
+        tailOptions |= BasicRegex::NOTBOL;
+    }
+    return matchesContentRange(regex, fileContent, tailBegin, length, tailOptions, encoding);
+}
+
+
+LanguageModeSelectors::Result LanguageModeSelectors::getResultForFileNameAndContent(const String& fileName, RawPtr<const ByteBuffer> fileContent,
+                                                                                    Nullable<TimeStamp> lastModifiedTime)
 {
+    if (lastModifiedTime.isValid())
+    {
+        Nullable<MemoizedResult> m = memoizedResults.get(fileName);
+        
+        if (   m.isValid() 
+            && m.get().lastModifiedTime.isValid() && m.get().lastModifiedTime.get() == lastModifiedTime.get()
+            && m.get().fileLength == fileContent->getLength())
+        {
+            return Result(m.get().languageModeName, m.get().encodingName);
+        }
+    }
+    Result rslt("default", "");
+    
     for (int i = 0; i < selectors.getLength(); ++i)
     {
         LanguageModeSelector::Ptr selector = selectors[i];
         
-        bool   fileNameMatched = false;
-        bool   contentMatched  = false;
         String encoding;
                 
         Nullable<BasicRegex> fileNameRegex = selector->getFileNameRegex();
         Nullable<BasicRegex> contentRegex  = selector->getFileContentRegex();
         
-        if (fileNameRegex.isValid()) {
-            bool matched = fileNameRegex.get().findMatch(fileName.toCString(), fileName.getLength(), 0, BasicRegex::MatchOptions(), ovector);
-            if (matched && ovector[0] == 0 && ovector[1] == fileName.getLength()) {
-                fileNameMatched = true;
-            }
+        if (fileNameRegex.isValid() && !matchesFileName(fileNameRegex.get(), fileName)) {
+            continue;
         }
-        if (contentRegex.isValid()) {
-            bool matched = contentRegex.get().findMatch((const char*)fileContent->getTotalAmount(), fileContent->getLength(), 0, BasicRegex::MatchOptions(), ovector);
-            if (matched) {
-                contentMatched = true;
-                try
-                {
-                    int i = contentRegex.get().getCaptureNumberByName("ENCODING");
-                    if (i > 0) {
-                        int p1 = ovector[2*i];
-                        int p2 = ovector[2*i + 1];
-                        if (p1 >= 0 && p2 > p1) {
-                            encoding = String((const char*)fileContent->getAmount(p1, p2 - p1), p2 - p1);
-                        }
-                    }
-                }
-                catch (RegexException& ex)
-                {}
-            }
+        if (contentRegex.isValid() && !matchesContent(contentRegex.get(), fileContent, &encoding)) {
+            continue;
         }
-        if (   (!fileNameRegex.isValid() || fileNameRegex.isValid() && fileNameMatched)
-            && ( !contentRegex.isValid() ||  contentRegex.isValid() && contentMatched))
-        {
-            return Result(selector->getLanguageMode(), encoding);
+        rslt = Result(selector->getLanguageMode(), encoding);
+        break;
+    }
+    if (lastModifiedTime.isValid())
+    {
+        if (numberOfMemoizedResults >= 1000) {
+            memoizedResults.clear();
+            numberOfMemoizedResults = 0;
+        }
+        MemoizedResult m;
+                       m.lastModifiedTime = lastModifiedTime;
+                       m.fileLength       = fileContent->getLength();
+                       m.languageModeName = rslt.languageModeName;
+                       m.encodingName     = rslt.encodingName;
+        if (!memoizedResults.hasKey(fileName)) {
+            ++numberOfMemoizedResults;
         }
+        memoizedResults.set(fileName, m);
     }
-    return Result("default", "");
+    return rslt;
 }
@@ -33,6 +33,8 @@
 #include "ConfigData.hpp"
 #include "RawPtr.hpp"
 #include "ByteBuffer.hpp"
+#include "Nullable.hpp"
+#include "TimeStamp.hpp"
 
 
 namespace LucED
@@ -45,8 +47,12 @@ class LanguageModeSelectors : public HeapObject
 public:
     typedef OwningPtr<LanguageModeSelectors> Ptr;
     
-    static Ptr create() {
-        return Ptr(new LanguageModeSelectors());
+    /**
+     * Content regexes are only matched against the first and the last
+     * contentDetectionLength bytes of a file, 0 means the whole file.
+     */
+    static Ptr create(long contentDetectionLength = 0) {
+        return Ptr(new LanguageModeSelectors(contentDetectionLength));
     }
     
     class Result
@@ -72,14 +78,39 @@ public:
     }
     
     String getLanguageModeNameForFileName(const String& fileName);
-    Result getResultForFileNameAndContent(const String& fileName, RawPtr<const ByteBuffer> fileContent);
+    
+    /**
+     * If lastModifiedTime is given, fileContent must be the content of the file
+     * on disk and the result is remembered for this file name and time.
+     */
+    Result getResultForFileNameAndContent(const String& fileName, RawPtr<const ByteBuffer> fileContent,
+                                          Nullable<TimeStamp> lastModifiedTime = Null);
 
 private:
-    LanguageModeSelectors()
+    LanguageModeSelectors(long contentDetectionLength)
+        : contentDetectionLength(contentDetectionLength),
+          numberOfMemoizedResults(0)
     {}
     
+    bool matchesFileName(const BasicRegex& regex, const String& fileName);
+    bool matchesContent(const BasicRegex& regex, RawPtr<const ByteBuffer> fileContent, String* encoding);
+    bool matchesContentRange(const BasicRegex& regex, RawPtr<const ByteBuffer> fileContent, 
+                             long beginPos, long endPos, BasicRegex::MatchOptions options, String* encoding);
+    
+    struct MemoizedResult
+    {
+        Nullable<TimeStamp> lastModifiedTime;
+        long                fileLength;
+        String              languageModeName;
+        String              encodingName;
+    };
+    
     ObjectArray<LanguageModeSelector::Ptr> selectors;
     MemArray<int> ovector;
+    long contentDetectionLength;
+
+    HashMap<String,MemoizedResult> memoizedResults;
+    int                            numberOfMemoizedResults;
 };
 
 } // namespace LucED
@@ -102,6 +102,15 @@ public:
     RawPtr<LineInfo> getPtr(long nr) {
         return &lineInfos[(first + nr) % lineInfos.getLength()];
     }
+    long getAllocatedBytes() const {
+        long rslt = lineInfos.getCapacityInBytes();
+        for (long i = 0; i < lineInfos.getLength(); ++i) {
+            rslt += lineInfos[i].fragments.getCapacityInBytes()
+                  + lineInfos[i].outBuf   .getCapacityInBytes()
+                  + lineInfos[i].styles   .getCapacityInBytes();
+        }
+        return rslt;
+    }
     void setAllInvalid() {
         for (long i = 0; i < lineInfos.getLength(); ++i) {
             lineInfos[i].valid = false;
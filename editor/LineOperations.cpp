@@ -0,0 +1,455 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <ctype.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "config.h"
+#include "LineOperations.hpp"
+#include "BasicRegex.hpp"
+#include "ObjectArray.hpp"
+#include "Thread.hpp"
+#include "SystemException.hpp"
+#include "util.hpp"
+
+using namespace LucED;
+
+namespace // anonymous namespace
+{
+
+const long MIN_LINES_PER_SORT_THREAD = 32 * 1024;
+const int  MAX_SORT_THREADS          = 8;
+const int  MAX_NUMBER_LENGTH         = 63;
+
+inline bool isBlank(byte c)
+{
+    return c == ' ' || c == '\t';
+}
+
+class LineComparator
+{
+public:
+    LineComparator(const byte* text, const LineOperations::SortOptions& options)
+        : text(text),
+          numeric(options.numeric),
+          reverse(options.reverse),
+          ignoreCase(options.ignoreCase)
+    {}
+    
+    bool operator()(const LineOperations::Line& a, const LineOperations::Line& b) const
+    {
+        int c = numeric ? compareNumbers(a, b) : compareKeys(a, b);
+        return reverse ? (c > 0) : (c < 0);
+    }
+    
+private:
+    int compareNumbers(const LineOperations::Line& a, const LineOperations::Line& b) const
+    {
+        if (a.number < b.number) {
+            return -1;
+        } else if (a.number > b.number) {
+            return 1;
+        } else {
+            return 0;
+        }
+    }
+    int compareKeys(const LineOperations::Line& a, const LineOperations::Line& b) const
+    {
+        const byte* p1 = text + a.keyBegin;
+        const byte* p2 = text + b.keyBegin;
+        long        n  = util::minimum(a.keyLength, b.keyLength);
+        
+        if (ignoreCase) {
+            for (long i = 0; i < n; ++i) {
+                int c1 = tolower(p1[i]);
+                int c2 = tolower(p2[i]);
+                if (c1 != c2) {
+                    return c1 - c2;
+                }
+            }
+        } else {
+            int c = memcmp(p1, p2, n);
+            if (c != 0) {
+                return c;
+            }
+        }
+        return (a.keyLength < b.keyLength) ? -1 : (a.keyLength > b.keyLength) ? 1 : 0;
+    }
+
+    const byte* text;
+    bool        numeric;
+    bool        reverse;
+    bool        ignoreCase;
+};
+
+inline bool isDigit(byte c)
+{
+    return '0' <= c && c <= '9';
+}
+
+/**
+ * Only [+-]digits[.digits] is accepted, so that words like "info" or 
+ * "nan" or hex numbers are not read as infinite, NaN or hex values.
+ * Like sort(1) lines without number are treated as zero.
+ */
+double parseNumber(const byte* p, long length)
+{
+    long i = 0;
+    while (i < length && isBlank(p[i])) {
+        ++i;
+    }
+    char buffer[MAX_NUMBER_LENGTH + 1];
+    int  n         = 0;
+    int  numDigits = 0;
+    
+    if (i < length && (p[i] == '+' || p[i] == '-')) {
+        buffer[n++] = p[i++];
+    }
+    while (i < length && n < MAX_NUMBER_LENGTH && isDigit(p[i])) {
+        buffer[n++] = p[i++];
+        ++numDigits;
+    }
+    if (i + 1 < length && n + 1 < MAX_NUMBER_LENGTH && p[i] == '.' && isDigit(p[i + 1]))
+    {
+        buffer[n++] = p[i++];
+        
+        while (i < length && n < MAX_NUMBER_LENGTH && isDigit(p[i])) {
+            buffer[n++] = p[i++];
+            ++numDigits;
+        }
+    }
+    if (numDigits == 0) {
+        return 0;
+    }
+    buffer[n] = '\0';
+    
+    return strtod(buffer, NULL);
+}
+
+} // anonymous namespace
+
+
+#if LUCED_USE_MULTI_THREAD
+class LineOperations::SortThread : public Thread
+{
+public:
+    typedef LucED::OwningPtr<SortThread> Ptr;
+    
+    static Ptr create(Line* begin, Line* end, const LineComparator& comparator) {
+        return Ptr(new SortThread(begin, end, comparator));
+    }
+protected:
+    virtual void main() {
+        std::stable_sort(begin, end, comparator);
+    }
+private:
+    SortThread(Line* begin, Line* end, const LineComparator& comparator)
+        : begin(begin),
+          end(end),
+          comparator(comparator)
+    {}
+    
+    Line*          begin;
+    Line*          end;
+    LineComparator comparator;
+};
+#endif // LUCED_USE_MULTI_THREAD
+
+
+LineOperations::LineOperations(RawPtr<TextData> textData, long beginPos, long endPos)
+    : textData(textData),
+      hasFinalNewline(false)
+{
+    const long length = textData->getLength();
+    
+    beginPos = util::maximum(0L, util::minimum(beginPos, length));
+    endPos   = util::maximum(0L, util::minimum(endPos,   length));
+
+    this->beginPos = textData->getThisLineBegin(beginPos);
+
+    if (endPos <= this->beginPos || textData->getThisLineBegin(endPos) != endPos) {
+        endPos = textData->getThisLineEnding(util::maximum(endPos, this->beginPos));
+    }
+    this->endPos = endPos;
+}
+
+
+const byte* LineOperations::indexLines()
+{
+    lines.clear();
+    
+    const long  length = endPos - beginPos;
+    const byte* text   = textData->getAmount(beginPos, length);
+    
+    if (length == 0) {
+        hasFinalNewline = false;
+        return text;
+    }
+    hasFinalNewline = (text[length - 1] == '\n');
+    
+    const long contentLength = hasFinalNewline ? length - 1 : length;
+    long       pos           = 0;
+    
+    while (true)
+    {
+        const byte* nl = (const byte*) memchr(text + pos, '\n', contentLength - pos);
+        long        e  = (nl != NULL) ? (nl - text) : contentLength;
+        
+        Line line;
+             line.begin     = pos;
+             line.length    = e - pos;
+             line.keyBegin  = pos;
+             line.keyLength = e - pos;
+             line.number    = 0;
+        lines.append(line);
+        
+        if (nl == NULL) {
+            break;
+        }
+        pos = e + 1;
+    }
+    return text;
+}
+
+
+void LineOperations::replaceLines(const byte* text, const MemArray<Line>& newLines)
+{
+    MemArray<byte> result;
+    
+    for (long i = 0, n = newLines.getLength(); i < n; ++i)
+    {
+        result.append(text + newLines[i].begin, newLines[i].length);
+        
+        if (i + 1 < n || hasFinalNewline) {
+            result.append('\n');
+        }
+    }
+    const long oldLength = endPos - beginPos;
+    
+    if (   result.getLength() == oldLength 
+        && memcmp(result.getPtr(0), text, oldLength) == 0)
+    {
+        return;
+    }
+    TextData::HistorySection::Ptr historySection = textData->createHistorySection();
+    
+    textData->rememberChangeAreaInHistory(beginPos, endPos);
+    
+    TextData::TextMark mark = textData->createNewMark();
+                       mark.moveToPos(beginPos);
+
+    // text points into the buffer and is invalid after modification,
+    // therefore the result has been assembled before
+
+    textData->removeAtMark(mark, oldLength);
+    textData->insertAtMark(mark, result.getPtr(0), result.getLength());
+    
+    endPos = beginPos + result.getLength();
+}
+
+
+void LineOperations::sort(const SortOptions& options)
+{
+    BasicRegex    keyRegex;
+    MemArray<int> ovector;
+
+    if (options.keyRegex.getLength() > 0) {
+        keyRegex = BasicRegex(options.keyRegex);
+        ovector.increaseTo(keyRegex.getOvecSize());
+    }
+    const byte* text = indexLines();
+    const long  n    = lines.getLength();
+    
+    if (n < 2 || textData->isReadOnly()) {
+        return;
+    }
+    for (long i = 0; i < n; ++i)
+    {
+        Line& line = lines[i];
+        
+        if (options.keyColumn > 0)
+        {
+            const byte* p   = text + line.begin;
+            long        pos = 0;
+            
+            for (int column = 1; ; ++column)
+            {
+                while (pos < line.length && isBlank(p[pos])) {
+                    ++pos;
+                }
+                long fieldBegin = pos;
+                while (pos < line.length && !isBlank(p[pos])) {
+                    ++pos;
+                }
+                if (column == options.keyColumn || pos >= line.length) {
+                    line.keyBegin  = line.begin + fieldBegin;
+                    line.keyLength = (column == options.keyColumn) ? pos - fieldBegin : 0;
+                    break;
+                }
+            }
+        }
+        if (keyRegex.isValid())
+        {
+            if (keyRegex.findMatch((const char*)(text + line.keyBegin), line.keyLength, 0,
+                                   BasicRegex::MatchOptions(), ovector))
+            {
+                int capture = (keyRegex.getNumberOfCapturingSubpatterns() > 0 && ovector[2] >= 0) ? 1 : 0;
+                
+                line.keyBegin  += ovector[2 * capture];
+                line.keyLength  = ovector[2 * capture + 1] - ovector[2 * capture];
+            }
+            else {
+                line.keyLength = 0;
+            }
+        }
+        if (options.numeric) {
+            line.number = parseNumber(text + line.keyBegin, line.keyLength);
+        }
+    }
+    LineComparator comparator(text, options);
+    Line*          sortLines = lines.getPtr(0);
+
+#if LUCED_USE_MULTI_THREAD
+    long numberOfThreads = util::minimum(n / MIN_LINES_PER_SORT_THREAD, (long) MAX_SORT_THREADS);
+#  ifdef _SC_NPROCESSORS_ONLN
+    numberOfThreads = util::minimum(numberOfThreads, (long) sysconf(_SC_NPROCESSORS_ONLN));
+#  endif
+    if (numberOfThreads > 1)
+    {
+        // every part is sorted in its own thread, the sorted parts 
+        // are merged afterwards, both steps keep the sort stable
+        
+        MemArray<long>               bounds;
+        ObjectArray<SortThread::Ptr> threads;
+        
+        for (long i = 0; i <= numberOfThreads; ++i) {
+            bounds.append(i * n / numberOfThreads);
+        }
+        for (long i = 0; i < numberOfThreads; ++i)
+        {
+            SortThread::Ptr thread = SortThread::create(sortLines + bounds[i], 
+                                                        sortLines + bounds[i + 1], comparator);
+            try {
+                Thread::start(thread);
+                threads.append(thread);
+            }
+            catch (SystemException&) {
+                std::stable_sort(sortLines + bounds[i], sortLines + bounds[i + 1], comparator);
+            }
+        }
+        for (long i = 0; i < threads.getLength(); ++i) {
+            threads[i]->waitForFinished();
+        }
+        long numberOfParts = numberOfThreads;
+        
+        while (numberOfParts > 1)
+        {
+            long i = 0;
+            long j = 0;
+            for (; i + 2 <= numberOfParts; i += 2, ++j) {
+                std::inplace_merge(sortLines + bounds[i], 
+                                   sortLines + bounds[i + 1], 
+                                   sortLines + bounds[i + 2], comparator);
+                bounds[j] = bounds[i];
+            }
+            for (; i <= numberOfParts; ++i, ++j) {
+                bounds[j] = bounds[i];
+            }
+            numberOfParts = j - 1;
+        }
+    }
+    else
+#endif // LUCED_USE_MULTI_THREAD
+    {
+        std::stable_sort(sortLines, sortLines + n, comparator);
+    }
+    replaceLines(text, lines);
+}
+
+
+void LineOperations::unique()
+{
+    const byte* text = indexLines();
+    const long  n    = lines.getLength();
+    
+    if (n < 2 || textData->isReadOnly()) {
+        return;
+    }
+    MemArray<Line> newLines;
+    
+    for (long i = 0; i < n; ++i)
+    {
+        if (i > 0) {
+            const Line& last = newLines.getLast();
+            if (   last.length == lines[i].length
+                && memcmp(text + last.begin, text + lines[i].begin, last.length) == 0)
+            {
+                continue;
+            }
+        }
+        newLines.append(lines[i]);
+    }
+    replaceLines(text, newLines);
+}
+
+
+void LineOperations::reverse()
+{
+    const byte* text = indexLines();
+    const long  n    = lines.getLength();
+    
+    if (n < 2 || textData->isReadOnly()) {
+        return;
+    }
+    std::reverse(lines.getPtr(0), lines.getPtr(0) + n);
+
+    replaceLines(text, lines);
+}
+
+
+void LineOperations::filter(const String& regexString, bool invert)
+{
+    BasicRegex    regex(regexString);
+    MemArray<int> ovector;
+                  ovector.increaseTo(regex.getOvecSize());
+
+    const byte* text = indexLines();
+    const long  n    = lines.getLength();
+    
+    if (n == 0 || textData->isReadOnly()) {
+        return;
+    }
+    MemArray<Line> newLines;
+    
+    for (long i = 0; i < n; ++i)
+    {
+        bool matched = regex.findMatch((const char*)(text + lines[i].begin), lines[i].length, 0,
+                                       BasicRegex::MatchOptions(), ovector);
+        if (matched != invert) {
+            newLines.append(lines[i]);
+        }
+    }
+    replaceLines(text, newLines);
+}
@@ -0,0 +1,117 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LINE_OPERATIONS_HPP
+#define LINE_OPERATIONS_HPP
+
+#include "RawPtr.hpp"
+#include "TextData.hpp"
+#include "MemArray.hpp"
+#include "String.hpp"
+
+namespace LucED
+{
+
+/**
+ * Rearranges the lines of a span of a TextData: sorting, removing 
+ * adjacent duplicates, reversing and filtering.
+ *
+ * The span is extended to whole lines. The lines are only indexed by 
+ * offsets into the text, the result is assembled once and replaces 
+ * the span in one history section, so that a single undo restores it.
+ */
+class LineOperations
+{
+public:
+    struct SortOptions
+    {
+        SortOptions()
+            : numeric(false),
+              reverse(false),
+              ignoreCase(false),
+              keyColumn(0)
+        {}
+        bool   numeric;
+        bool   reverse;
+        bool   ignoreCase;
+        
+        /** 1-based field separated by blanks, 0 for the whole line */
+        int    keyColumn;
+        
+        /** sorts by the first capture or by the whole match if not empty */
+        String keyRegex;
+    };
+    
+    LineOperations(RawPtr<TextData> textData, long beginPos, long endPos);
+    
+    /**
+     * Stable sort, large spans are sorted in parallel if 
+     * multiple threads are available.
+     * Throws RegexException for an invalid key regex.
+     */
+    void sort(const SortOptions& options);
+    
+    /**
+     * Removes adjacent duplicate lines like uniq(1).
+     */
+    void unique();
+    
+    void reverse();
+    
+    /**
+     * Keeps the lines matching the regex, with invert flag
+     * the lines matching the regex are removed.
+     * Throws RegexException for an invalid regex.
+     */
+    void filter(const String& regex, bool invert);
+    
+    long getBeginPos() const {
+        return beginPos;
+    }
+    long getEndPos() const {
+        return endPos;
+    }
+    
+    struct Line
+    {
+        long   begin;
+        long   length;
+        long   keyBegin;
+        long   keyLength;
+        double number;
+    };
+    
+private:
+    class SortThread;
+    
+    const byte* indexLines();
+    void replaceLines(const byte* text, const MemArray<Line>& newLines);
+    
+    RawPtr<TextData> textData;
+    long             beginPos;
+    long             endPos;
+    bool             hasFinalNewline;
+    MemArray<Line>   lines;
+};
+
+} // namespace LucED
+
+#endif // LINE_OPERATIONS_HPP
@@ -107,6 +107,14 @@ LuaVar LuaAccess::loadString(const char* script, const Nullable<String>& fileNam
 
 
 
+LuaVar LuaAccess::loadBuffer(const char* scriptBegin, long scriptLength, const Nullable<String>& fileName) const
+{
+    internLoadBuffer(scriptBegin, scriptLength, fileName);
+    
+    return LuaVar(*this, lua_gettop(L));
+}
+
+
 LuaVar LuaAccess::loadFile(const String& fileName) const
 {
     ByteBuffer buffer;
@@ -111,6 +111,15 @@ public:
     
     LuaVar toLua(const char* ptr, long length) const;
 
+    long getHeapBytes() const {
+        ASSERT(isCorrect());
+        return lua_gc(L, LUA_GCCOUNT, 0) * 1024L + lua_gc(L, LUA_GCCOUNTB, 0);
+    }
+    void collectGarbage() const {
+        ASSERT(isCorrect());
+        lua_gc(L, LUA_GCCOLLECT, 0);
+    }
+
     void clearGlobal(const char* name) const {
         ASSERT(isCorrect());
         lua_pushnil(L);
@@ -136,6 +145,9 @@ public:
 
     LuaVar loadFile(const String& fileName) const;
     
+    // loads script source or precompiled chunk
+    LuaVar loadBuffer(const char* scriptBegin, long scriptLength, const Nullable<String>& fileName = Null) const;
+    
     class Result;
     Result executeScript(const char* beginScript, long scriptLength) const;
     Result executeScript(String script) const;
@@ -29,6 +29,7 @@
 #include "LuaCMethod.hpp"
 #include "LuaFunctionArguments.hpp"
 #include "ExceptionLuaInterface.hpp"
+#include "TextRangeLuaInterface.hpp"
 
 using namespace LucED;
 
@@ -153,6 +154,8 @@ LuaCFunctionResult LuaInterpreter::errorHandlerFunction(const LuaCFunctionArgume
 extern int luaopen_posix (lua_State* L);
 extern int luaopen_lpeg  (lua_State* L);
 
+extern void lpeg_setsubjectreader(const char* (*reader)(lua_State* L, int idx, size_t* l));
+
 
 inline lua_State* LuaInterpreter::initState(LuaInterpreter* luaInterpreter, lua_State* L)
 {
@@ -161,6 +164,7 @@ inline lua_State* LuaInterpreter::initState(LuaInterpreter* luaInterpreter, lua_
     
     lua_pushcfunction(L, &luaopen_lpeg);
     lua_call(L, 0, 0);
+    lpeg_setsubjectreader(&TextRangeLuaInterface::readLpegSubject);
     
     LuaStateAccess::setLuaInterpreter(L, luaInterpreter);
     return L;
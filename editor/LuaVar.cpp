@@ -25,8 +25,27 @@
 #include "LuaInterpreter.hpp"
 #include "LuaException.hpp"
 
+#include "ByteBuffer.hpp"
+
 using namespace LucED;
 
+
+static int dumpWriter(lua_State* L, const void* p, size_t sz, void* ud)
+{
+    static_cast<ByteBuffer*>(ud)->append((const byte*) p, sz);
+    return 0;
+}
+
+void LuaVarRef::dumpFunction(RawPtr<ByteBuffer> buffer) const
+{
+    ASSERT(isCorrect());
+    ASSERT(isFunction());
+    
+    lua_pushvalue(L, stackIndex);
+    lua_dump(L, &dumpWriter, buffer);
+    lua_pop(L, 1);
+}
+
 /*
 LuaVar LuaVar::call()
 {
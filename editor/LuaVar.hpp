@@ -54,6 +54,7 @@ class LuaCFunctionArguments;
 class LuaInterpreter;
 class LuaVarList;
 class LuaFunctionArguments;
+class ByteBuffer;
 
 template
 <
@@ -551,6 +552,11 @@ public:
 
     LuaVar call();
 
+    /**
+     * Appends the precompiled chunk of this Lua function to the buffer,
+     * the result can be loaded with LuaAccess::loadBuffer.
+     */
+    void dumpFunction(RawPtr<ByteBuffer> buffer) const;
     
     RawPtr<LuaInterpreter> getLuaInterpreter() const;
 
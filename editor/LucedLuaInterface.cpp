@@ -27,6 +27,10 @@
 #include "GlobalConfig.hpp"
 #include "LuaIterator.hpp"
 #include "FileOpener.hpp"
+#include "MultiFileSearch.hpp"
+#include "RegexException.hpp"
+#include "MemoryStatistics.hpp"
+#include "SessionSnapshot.hpp"
 
 using namespace LucED;
 
@@ -166,3 +170,114 @@ LuaCFunctionResult LucedLuaInterface::bindActionKey(const LuaCFunctionArguments&
                                                                     action);
     return LuaCFunctionResult(luaAccess);
 }
+
+
+/**
+ * luced.findInFiles(searchString, directories, options) opens a result window,
+ * directories is a string or a list of strings, options is a string with
+ * 'i' for ignoring case, 'r' for regular expression and 'w' for whole words.
+ */
+LuaCFunctionResult LucedLuaInterface::findInFiles(const LuaCFunctionArguments& args)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+
+    if (   args.getLength() < 2 || args.getLength() > 3
+        || !args[0].isString()
+        || !(args[1].isString() || args[1].isTable())
+        || (args.getLength() == 3 && !args[2].isString()))
+    {
+        throw LuaArgException(luaAccess, "arguments must be searchString, directories and optional options string");
+    }
+    ObjectArray<String> directories;
+    
+    if (args[1].isString()) {
+        directories.append(args[1].toString());
+    }
+    else {
+        for (int i = 1; ; ++i)
+        {
+            LuaVar directory = args[1][i];
+            if (directory.isNil()) {
+                break;
+            }
+            if (!directory.isString()) {
+                throw LuaArgException(luaAccess, "directories must be list of strings");
+            }
+            directories.append(directory.toString());
+        }
+    }
+    SearchParameter p;
+                    p.setIgnoreCaseFlag(false);
+                    p.setFindString(args[0].toString());
+    
+    String options = (args.getLength() == 3) ? args[2].toString() : String();
+    
+    for (int i = 0; i < options.getLength(); ++i)
+    {
+        switch (options[i])
+        {
+            case 'i': p.setIgnoreCaseFlag(true); break;
+            case 'r': p.setRegexFlag(true);      break;
+            case 'w': p.setWholeWordFlag(true);  break;
+            default:  throw LuaArgException(luaAccess, String() << "invalid option '" << options[i] << "'");
+        }
+    }
+    try {
+        MultiFileSearch::start(p, directories);
+    } 
+    catch (RegexException& ex) {
+        throw LuaException(luaAccess, String() << "Invalid search pattern '" << p.getFindString() 
+                                               << "': " << ex.getMessage());
+    }
+    return LuaCFunctionResult(luaAccess);
+}
+
+
+/**
+ * luced.getMemoryStatistics() returns a table with the allocated bytes
+ * of the global caches and a list "buffers" with the allocated bytes
+ * per open buffer, biggest consumer first.
+ */
+LuaCFunctionResult LucedLuaInterface::getMemoryStatistics(const LuaCFunctionArguments& args)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+
+    if (args.getLength() != 0) {
+        throw LuaArgException(luaAccess);
+    }
+    return LuaCFunctionResult(luaAccess) << MemoryStatistics::collect(luaAccess).toLua(luaAccess);
+}
+
+
+/**
+ * luced.saveSession(name) stores the open windows, without name as the 
+ * session of the current instance. Returns the number of saved windows.
+ */
+LuaCFunctionResult LucedLuaInterface::saveSession(const LuaCFunctionArguments& args)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+
+    if (args.getLength() > 1 || (args.getLength() == 1 && !args[0].isString())) {
+        throw LuaArgException(luaAccess, "argument must be optional session name");
+    }
+    String sessionName = (args.getLength() == 1) ? args[0].toString() : String();
+    
+    return LuaCFunctionResult(luaAccess) << SessionSnapshot::save(sessionName);
+}
+
+
+/**
+ * luced.restoreSession(name) reopens the windows of a saved session.
+ * Returns the number of restored windows.
+ */
+LuaCFunctionResult LucedLuaInterface::restoreSession(const LuaCFunctionArguments& args)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+
+    if (args.getLength() > 1 || (args.getLength() == 1 && !args[0].isString())) {
+        throw LuaArgException(luaAccess, "argument must be optional session name");
+    }
+    String sessionName = (args.getLength() == 1) ? args[0].toString() : String();
+    
+    return LuaCFunctionResult(luaAccess) << SessionSnapshot::restore(sessionName);
+}
@@ -0,0 +1,258 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "MatchBackliteBuffer.hpp"
+#include "RegexException.hpp"
+#include "util.hpp"
+
+using namespace LucED;
+
+namespace // anonymous namespace
+{
+
+/**
+ * Larger changes are not rescanned at once but only when the 
+ * changed text becomes visible.
+ */
+const long MAX_RESCAN_LENGTH = 64 * 1024;
+
+} // anonymous namespace
+
+
+MatchBackliteBuffer::MatchBackliteBuffer(RawPtr<TextData> textData)
+    : textData(textData),
+      findUtil(textData),
+      activeFlag(false),
+      windowBegin(0),
+      windowEnd(0),
+      lastMatchIndex(0)
+{}
+
+
+void MatchBackliteBuffer::setSearchParameter(const SearchParameter& p)
+{
+    if (activeFlag && p.findsSameThan(parameter)) {
+        return;
+    }
+    parameter = p;
+    parameter.setSearchForwardFlag(true);
+    parameter.setAllowMatchAtStartOfSearchFlag(true);
+    
+    findUtil.setParameter(parameter);
+    
+    activeFlag = (p.getFindString().getLength() > 0);
+    
+    invalidateWindow();
+}
+
+
+void MatchBackliteBuffer::clear()
+{
+    if (activeFlag) {
+        activeFlag = false;
+        invalidateWindow();
+    }
+}
+
+
+void MatchBackliteBuffer::invalidateWindow()
+{
+    windowBegin    = 0;
+    windowEnd      = 0;
+    lastMatchIndex = 0;
+    matches.clear();
+    
+    updateListeners.invokeAllCallbacks(HilitingBuffer::UpdateInfo(0, textData->getLength()));
+}
+
+
+bool MatchBackliteBuffer::isInMatch(long textPos)
+{
+    long n = matches.getLength();
+    long i = lastMatchIndex;
+    
+    if (i >= n || matches[i].beginPos > textPos) 
+    {
+        // binary search for the last match beginning at or before textPos
+        
+        long low  = 0;
+        long high = n;
+        
+        while (low < high) {
+            long mid = (low + high) / 2;
+            if (matches[mid].beginPos <= textPos) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        if (low == 0) {
+            return false;
+        }
+        i = low - 1;
+    }
+    else
+    {
+        // sequential access while filling lines
+        
+        while (i + 1 < n && matches[i + 1].beginPos <= textPos) {
+            ++i;
+        }
+    }
+    lastMatchIndex = i;
+    
+    return textPos < matches[i].endPos;
+}
+
+
+void MatchBackliteBuffer::findMatches(long beginPos, long endPos, MemArray<Match>* result)
+{
+    try
+    {
+        long pos = beginPos;
+    
+        while (pos < endPos)
+        {
+            findUtil.setTextPosition(pos);
+            findUtil.setMaximalEndOfMatchPosition(endPos);
+            findUtil.findNext();
+            
+            if (!findUtil.wasFound() || findUtil.getMatchBeginPos() >= endPos) {
+                break;
+            }
+            long matchBegin = findUtil.getMatchBeginPos();
+            long matchEnd   = findUtil.getMatchEndPos();
+            
+            if (matchEnd > matchBegin) {
+                Match* m = result->appendAmount(1);
+                m->beginPos = matchBegin;
+                m->endPos   = matchEnd;
+                pos = matchEnd;
+            } else {
+                pos = textData->getNextWCharPos(matchBegin);
+            }
+        }
+    }
+    catch (RegexException& ex) {
+        activeFlag = false;
+    }
+    catch (LuaException& ex) {
+        activeFlag = false;
+    }
+}
+
+
+void MatchBackliteBuffer::fillWindow(long textPos, long numberOfLines)
+{
+    long b = textData->getThisLineBegin(textPos);
+    for (long i = 0; i < numberOfLines && b > 0; ++i) {
+        b = textData->getPrevLineBegin(b);
+    }
+    long e = textPos;
+    for (long i = 0; i < 2 * numberOfLines && e < textData->getLength(); ++i) {
+        e = textData->getNextLineBegin(e);
+    }
+    e = textData->getThisLineEnding(e);
+    
+    matches.clear();
+    lastMatchIndex = 0;
+    
+    findMatches(b, e, &matches);
+    
+    if (activeFlag) {
+        windowBegin = b;
+        windowEnd   = e + 1;
+    } else {
+        matches.clear();
+        windowBegin = 0;
+        windowEnd   = 0;
+    }
+}
+
+
+/**
+ * Matches before the change are kept, matches behind the change are
+ * moved and only the changed lines are searched again.
+ */
+void MatchBackliteBuffer::treatTextDataUpdate(TextData::UpdateInfo u)
+{
+    if (!activeFlag || windowBegin >= windowEnd || u.beginChangedPos >= windowEnd) {
+        return;
+    }
+    if (u.oldEndChangedPos < windowBegin)
+    {
+        for (long i = 0; i < matches.getLength(); ++i) {
+            matches[i].beginPos += u.changedAmount;
+            matches[i].endPos   += u.changedAmount;
+        }
+        windowBegin += u.changedAmount;
+        windowEnd   += u.changedAmount;
+        return;
+    }
+    long newEndChangedPos = u.oldEndChangedPos + u.changedAmount;
+    long rescanBegin      = textData->getThisLineBegin (u.beginChangedPos);
+    long rescanEnd        = textData->getThisLineEnding(util::minimum(textData->getLength(), newEndChangedPos));
+    
+    if (rescanEnd - rescanBegin > MAX_RESCAN_LENGTH) {
+        matches.clear();
+        windowBegin = 0;
+        windowEnd   = 0;
+        return;
+    }
+    
+    MemArray<Match> rescanned;
+    findMatches(rescanBegin, rescanEnd, &rescanned);
+    
+    if (!activeFlag) {
+        invalidateWindow();
+        return;
+    }
+    MemArray<Match> newMatches;
+    long i = 0;
+    
+    while (i < matches.getLength() && matches[i].endPos <= rescanBegin) {
+        *newMatches.appendAmount(1) = matches[i];
+        ++i;
+    }
+    for (long j = 0; j < rescanned.getLength(); ++j) {
+        *newMatches.appendAmount(1) = rescanned[j];
+    }
+    while (i < matches.getLength() && matches[i].beginPos < u.oldEndChangedPos) {
+        ++i;
+    }
+    for (; i < matches.getLength(); ++i) {
+        Match m = matches[i];
+              m.beginPos += u.changedAmount;
+              m.endPos   += u.changedAmount;
+        if (m.beginPos > rescanEnd) {
+            *newMatches.appendAmount(1) = m;
+        }
+    }
+    matches.clear();
+    matches.appendAmount(newMatches.getLength());
+    for (long j = 0; j < newMatches.getLength(); ++j) {
+        matches[j] = newMatches[j];
+    }
+    lastMatchIndex = 0;
+    
+    windowBegin = util::minimum(windowBegin, rescanBegin);
+    windowEnd   = util::maximum(windowEnd + u.changedAmount, rescanEnd + 1);
+}
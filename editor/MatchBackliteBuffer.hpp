@@ -0,0 +1,119 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MATCH_BACKLITE_BUFFER_HPP
+#define MATCH_BACKLITE_BUFFER_HPP
+
+#include "HeapObject.hpp"
+#include "TextData.hpp"
+#include "MemArray.hpp"
+#include "CallbackContainer.hpp"
+#include "HilitingBuffer.hpp"
+#include "OwningPtr.hpp"
+#include "RawPtr.hpp"
+#include "FindUtil.hpp"
+#include "SearchParameter.hpp"
+
+namespace LucED
+{
+
+/**
+ * Background overlay marking all matches of a search parameter.
+ *
+ * Matches are only computed for a window around the displayed lines.
+ * The window is kept while scrolling within it and is adjusted
+ * incrementally on text changes, so that highlighting all matches
+ * never scans the whole text.
+ */
+class MatchBackliteBuffer : public HeapObject
+{
+public:
+    typedef OwningPtr<MatchBackliteBuffer> Ptr;
+    
+    enum { MATCH_BACKGROUND = 3 };
+    
+    static Ptr create(RawPtr<TextData> textData) {
+        return Ptr(new MatchBackliteBuffer(textData));
+    }
+    
+    void setSearchParameter(const SearchParameter& p);
+    void clear();
+    
+    bool isActive() const {
+        return activeFlag;
+    }
+    const SearchParameter& getSearchParameter() const {
+        return parameter;
+    }
+    
+    /**
+     * Must be called before getBackground() is used for the 
+     * displayed lines beginning at textPos.
+     */
+    void prepareVisibleRange(long textPos, long numberOfLines) {
+        if (activeFlag && (textPos < windowBegin || textPos >= windowEnd)) {
+            fillWindow(textPos, numberOfLines);
+        }
+    }
+    
+    byte getBackground(long textPos) {
+        if (matches.getLength() == 0 || textPos < windowBegin || textPos >= windowEnd) {
+            return 0;
+        }
+        return isInMatch(textPos) ? MATCH_BACKGROUND : 0;
+    }
+    
+    void treatTextDataUpdate(TextData::UpdateInfo update);
+    
+    void registerUpdateListener(Callback<HilitingBuffer::UpdateInfo>::Ptr updateCallback) {
+        updateListeners.registerCallback(updateCallback);
+    }
+    
+private:
+    struct Match
+    {
+        long beginPos;
+        long endPos;
+    };
+    
+    MatchBackliteBuffer(RawPtr<TextData> textData);
+    
+    bool isInMatch(long textPos);
+    void fillWindow(long textPos, long numberOfLines);
+    void findMatches(long beginPos, long endPos, MemArray<Match>* result);
+    void invalidateWindow();
+    
+    RawPtr<TextData> textData;
+    FindUtil         findUtil;
+    SearchParameter  parameter;
+    bool             activeFlag;
+    
+    long             windowBegin;
+    long             windowEnd;
+    MemArray<Match>  matches;
+    long             lastMatchIndex;
+    
+    CallbackContainer<HilitingBuffer::UpdateInfo> updateListeners;
+};
+
+} // namespace LucED
+
+#endif // MATCH_BACKLITE_BUFFER_HPP
@@ -20,6 +20,8 @@
 /////////////////////////////////////////////////////////////////////////////////////
 
 #include "MatchLuaInterface.hpp"
+#include "TextRangeLuaInterface.hpp"
+#include "ViewLuaInterface.hpp"
 #include "ActionIdRegistry.hpp"
 #include "LuaCMethodArgChecker.hpp"
 #include "LuaArgException.hpp"
@@ -183,6 +185,12 @@ LuaCFunctionResult MatchLuaInterface::replace(const LuaCFunctionArguments& args)
     {
         int removeLength = epos - spos;
         
+        // within a transaction the text stays unchanged until the 
+        // transaction ends, so the captures keep their positions
+
+        if (e->getViewLuaInterface()->collectTransactionEdit(spos, removeLength, replaceString)) {
+            return LuaCFunctionResult(luaAccess);
+        }
         TextData::TextMark m = e->createNewMarkFromCursor();
         m.moveToPos(spos);
         
@@ -273,3 +281,27 @@ LuaCFunctionResult MatchLuaInterface::getMatchedBytes(const LuaCFunctionArgument
     return LuaCFunctionResult(luaAccess) << rslt;
 }
 
+
+LuaCFunctionResult MatchLuaInterface::getMatchedRange(const LuaCFunctionArguments& args)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+
+    if (!textData.isValid() || !e.isValid()) {
+        return LuaCFunctionResult(luaAccess);
+    }
+
+    int captureNumber = 0;
+    
+    if (args.getLength() > 0) {
+        captureNumber = getCaptureNumber(args[0]);
+    }
+    
+    long beginPos = ovector[captureNumber * 2];
+    long endPos   = ovector[captureNumber * 2 + 1];
+    
+    if (beginPos < 0 || endPos < beginPos) {
+        return LuaCFunctionResult(luaAccess);
+    }
+    return LuaCFunctionResult(luaAccess) << TextRangeLuaInterface::create(e, beginPos, endPos);
+}
+
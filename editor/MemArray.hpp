@@ -84,6 +84,18 @@ public:
     long getLength() const {
         return size;
     }
+    long getCapacityInBytes() const {
+        return mem.getCapacity();
+    }
+    bool needsCompaction() const {
+        return mem.isWorthShrinking(size * sizeof(T));
+    }
+    /**
+     * Returns the number of released bytes, see HeapMem::getShrinkedCapacity().
+     */
+    long compact(bool releaseAll = false) {
+        return mem.shrink(size * sizeof(T), releaseAll);
+    }
     MemArray& clear() {
         size = 0;
         return *this;
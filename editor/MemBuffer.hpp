@@ -62,6 +62,26 @@ public:
     long getLength() const {
         return (mem.getCapacity() - gapSize) / sizeof(T);
     }
+    long getCapacityInBytes() const {
+        return mem.getCapacity();
+    }
+    bool needsCompaction() const {
+        return mem.isWorthShrinking(getLength() * sizeof(T));
+    }
+    /**
+     * Moves the gap to the end and cuts it down, returns the number 
+     * of released bytes, see HeapMem::getShrinkedCapacity().
+     */
+    long compact(bool releaseAll = false) {
+        long usedBytes = getLength() * sizeof(T);
+        if (mem.getShrinkedCapacity(usedBytes, releaseAll) == mem.getCapacity()) {
+            return 0;
+        }
+        moveGap(getLength());
+        long rslt = mem.shrink(usedBytes, releaseAll);
+        gapSize = mem.getCapacity() - usedBytes;
+        return rslt;
+    }
 private:
     T* posToPtr(long pos) {
         if (pos < gapPos) {
@@ -118,6 +138,26 @@ public:
             return posToPtr(startPos);
         }
     }
+    /**
+     * Returns the number of elements beginning at pos that are
+     * stored contiguously, i.e. up to the gap or the end of the buffer.
+     */
+    long getContiguousLength(long pos) const {
+        ASSERT(0 <= pos && pos <= getLength());
+        if (pos < gapPos) {
+            return gapPos - pos;
+        } else {
+            return getLength() - pos;
+        }
+    }
+    /**
+     * Returns pointer to the element at pos without moving the gap,
+     * only getContiguousLength(pos) elements are valid behind this pointer.
+     */
+    const T* getContiguousPtr(long pos) const {
+        ASSERT(0 <= pos && pos <= getLength());
+        return posToPtr(pos);
+    }
     T* getPtr(long pos = 0) {
         return getAmount(pos, getLength() - pos);
     }
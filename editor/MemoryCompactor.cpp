@@ -0,0 +1,150 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "config.h"
+
+#if HAVE_MALLOC_TRIM
+#  include <malloc.h>
+#endif
+
+#include "MemoryCompactor.hpp"
+#include "EventDispatcher.hpp"
+#include "TopWinList.hpp"
+#include "EditorTopWin.hpp"
+#include "GlobalLuaInterpreter.hpp"
+#include "util.hpp"
+
+using namespace LucED;
+
+SingletonInstance<MemoryCompactor> MemoryCompactor::instance;
+
+
+namespace // anonymous namespace
+{
+
+/**
+ * Time without compaction requests before the compaction pass runs.
+ */
+const long IDLE_DELAY_SECS = 3;
+
+inline void returnFreeHeapToSystem()
+{
+#if HAVE_MALLOC_TRIM
+    malloc_trim(0);
+#endif
+}
+
+} // anonymous namespace
+
+
+MemoryCompactor::MemoryCompactor()
+    : processHandler(ProcessHandler::create(this, &MemoryCompactor::process,
+                                                  &MemoryCompactor::needsProcessing)),
+      idleTimerCallback(newCallback(this, &MemoryCompactor::handleIdleTimer)),
+      lastRequestTime(TimeStamp::now()),
+      isTimerRegistered(false),
+      isCompactionDue(false),
+      nextTopWinIndex(0)
+{
+    EventDispatcher::getInstance()->registerProcess(processHandler);
+}
+
+
+void MemoryCompactor::requestCompaction()
+{
+    lastRequestTime = TimeStamp::now();
+
+    if (!isTimerRegistered) {
+        EventDispatcher::getInstance()->registerTimerCallback(lastRequestTime + Seconds(IDLE_DELAY_SECS),
+                                                              idleTimerCallback);
+        isTimerRegistered = true;
+    }
+}
+
+
+void MemoryCompactor::handleIdleTimer()
+{
+    TimeStamp dueTime = lastRequestTime + Seconds(IDLE_DELAY_SECS);
+    
+    if (TimeStamp::now() < dueTime) {
+        EventDispatcher::getInstance()->registerTimerCallback(dueTime, idleTimerCallback);
+    } else {
+        isTimerRegistered = false;
+        isCompactionDue   = true;
+        nextTopWinIndex   = 0;
+    }
+}
+
+
+bool MemoryCompactor::needsProcessing()
+{
+    return isCompactionDue;
+}
+
+
+int MemoryCompactor::process(TimeStamp endTime)
+{
+    int numberOfTopWins = TopWinList::getInstance()->getNumberOfTopWins();
+    
+    while (nextTopWinIndex < numberOfTopWins)
+    {
+        compactTopWin(nextTopWinIndex++, false);
+
+        if (TimeStamp::now() >= endTime) {
+            return 0;
+        }
+    }
+    returnFreeHeapToSystem();
+    isCompactionDue = false;
+    return 0;
+}
+
+
+long MemoryCompactor::compactTopWin(int topWinIndex, bool releaseAll)
+{
+    EditorTopWin* topWin = dynamic_cast<EditorTopWin*>(TopWinList::getInstance()->getTopWin(topWinIndex));
+    
+    if (topWin == NULL) {
+        return 0;
+    }
+    return topWin->getTextEditorWidget()->getTextData()->compactMemory(releaseAll)
+         + topWin->getHilitedText()->compactMemory(releaseAll);
+}
+
+
+long MemoryCompactor::releaseMemory()
+{
+    long rslt = 0;
+    
+    for (int i = 0; i < TopWinList::getInstance()->getNumberOfTopWins(); ++i) {
+        rslt += compactTopWin(i, true);
+    }
+    LuaAccess luaAccess = GlobalLuaInterpreter::getInstance()->getCurrentLuaAccess();
+
+    long luaHeapBytes = luaAccess.getHeapBytes();
+    luaAccess.collectGarbage();
+    rslt += util::maximum(0L, luaHeapBytes - luaAccess.getHeapBytes());
+
+    returnFreeHeapToSystem();
+    isCompactionDue = false;
+
+    return rslt;
+}
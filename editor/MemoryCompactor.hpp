@@ -0,0 +1,83 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MEMORY_COMPACTOR_HPP
+#define MEMORY_COMPACTOR_HPP
+
+#include "HeapObject.hpp"
+#include "SingletonInstance.hpp"
+#include "ProcessHandler.hpp"
+#include "Callback.hpp"
+#include "TimeStamp.hpp"
+
+namespace LucED
+{
+
+/**
+ * Gives back the memory of buffers that were grown by transient large
+ * operations. Compaction is requested by TextData after big removals and
+ * is done when the editor has been idle for some time.
+ */
+class MemoryCompactor : public HeapObject
+{
+public:
+    static MemoryCompactor* getInstance() {
+        return instance.getPtr();
+    }
+    
+    /**
+     * Schedules a compaction pass, that runs if there was no
+     * further request within the idle delay.
+     */
+    void requestCompaction();
+    
+    /**
+     * Immediately reduces all buffers to their used size, collects
+     * Lua garbage and returns free heap memory to the operating system.
+     * Returns the number of released bytes.
+     */
+    long releaseMemory();
+
+private:
+    friend class SingletonInstance<MemoryCompactor>;
+    static SingletonInstance<MemoryCompactor> instance;
+    
+    MemoryCompactor();
+    
+    bool needsProcessing();
+    int  process(TimeStamp endTime);
+    
+    void handleIdleTimer();
+    
+    long compactTopWin(int topWinIndex, bool releaseAll);
+    
+    ProcessHandler::Ptr processHandler;
+    Callback<>::Ptr     idleTimerCallback;
+    
+    TimeStamp lastRequestTime;
+    bool      isTimerRegistered;
+    bool      isCompactionDue;
+    int       nextTopWinIndex;
+};
+
+} // namespace LucED
+
+#endif // MEMORY_COMPACTOR_HPP
@@ -0,0 +1,206 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <algorithm>
+
+#include "MemoryStatistics.hpp"
+#include "TopWinList.hpp"
+#include "EditorTopWin.hpp"
+#include "TextStyleCache.hpp"
+#include "HeapObjectAllocator.hpp"
+
+using namespace LucED;
+
+namespace // anonymous namespace
+{
+
+bool isBiggerConsumer(const MemoryStatistics::BufferUsage& lhs, const MemoryStatistics::BufferUsage& rhs)
+{
+    return lhs.getTotalBytes() > rhs.getTotalBytes();
+}
+
+} // anonymous namespace
+
+
+MemoryStatistics::BufferUsage::BufferUsage()
+    : numberOfWindows(0),
+      textLength(0),
+      textBytes(0),
+      numberOfMarks(0),
+      markBytes(0),
+      numberOfHistoryActions(0),
+      historyDataLength(0),
+      historyBytes(0),
+      numberOfBreaks(0),
+      hilitingBytes(0),
+      styleBufferBytes(0),
+      lineInfoBytes(0)
+{}
+
+
+MemoryStatistics MemoryStatistics::collect(LuaAccess luaAccess)
+{
+    MemoryStatistics        rslt;
+    ObjectArray<TextData*>  textDatas;
+    
+    RawPtr<TopWinList> topWins = TopWinList::getInstance();
+    
+    for (int w = 0; w < topWins->getNumberOfTopWins(); ++w)
+    {
+        EditorTopWin* topWin = dynamic_cast<EditorTopWin*>(topWins->getTopWin(w));
+        if (topWin == NULL) {
+            continue;
+        }
+        TextEditorWidget::Ptr editorWidget = topWin->getTextEditorWidget();
+        TextData::Ptr         textData     = editorWidget->getTextData();
+        
+        int i = 0;
+        while (i < textDatas.getLength() && textDatas[i] != textData.getRawPtr()) {
+            ++i;
+        }
+        if (i == textDatas.getLength())
+        {
+            textDatas.append(textData.getRawPtr());
+
+            BufferUsage u;
+            u.fileName      = textData->getFileName();
+            u.textLength    = textData->getLength();
+            u.textBytes     = textData->getAllocatedBufferBytes();
+            u.numberOfMarks = textData->getNumberOfMarks();
+            u.markBytes     = textData->getAllocatedMarkBytes();
+            
+            RawPtr<const EditingHistory> history = textData->getEditingHistory();
+            if (history.isValid()) {
+                u.numberOfHistoryActions = history->getNumberOfActions();
+                u.historyDataLength      = history->getHistoryDataLength();
+                u.historyBytes           = history->getAllocatedBytes();
+            }
+            HilitedText::Ptr hilitedText = topWin->getHilitedText();
+            u.numberOfBreaks = hilitedText->getNumberOfBreaks();
+            u.hilitingBytes  = hilitedText->getAllocatedBytes();
+            
+            rslt.bufferUsages.append(u);
+        }
+        BufferUsage& u = rslt.bufferUsages[i];
+        
+        u.numberOfWindows  += 1;
+        u.styleBufferBytes += editorWidget->getAllocatedStyleBufferBytes();
+        u.lineInfoBytes    += editorWidget->getAllocatedLineInfoBytes();
+    }
+    std::stable_sort(rslt.bufferUsages.getPtr(0), 
+                     rslt.bufferUsages.getPtr(0) + rslt.bufferUsages.getLength(), 
+                     &isBiggerConsumer);
+    
+    rslt.luaHeapBytes        = luaAccess.getHeapBytes();
+    rslt.numberOfTextStyles  = TextStyleCache::getInstance()->getNumberOfTextStyles();
+    rslt.numberOfFontInfos   = TextStyleCache::getInstance()->getNumberOfFontInfos();
+    rslt.fontInfoBytes       = TextStyleCache::getInstance()->getAllocatedFontInfoBytes();
+    rslt.heapObjectPoolBytes = HeapObjectAllocator::getPooledBytes();
+
+    return rslt;
+}
+
+
+long MemoryStatistics::getTotalBytes() const
+{
+    long rslt = luaHeapBytes + fontInfoBytes + heapObjectPoolBytes;
+    
+    for (int i = 0; i < bufferUsages.getLength(); ++i) {
+        rslt += bufferUsages[i].getTotalBytes();
+    }
+    return rslt;
+}
+
+
+LuaVar MemoryStatistics::toLua(LuaAccess luaAccess) const
+{
+    LuaVar buffers = luaAccess.newTable();
+    
+    for (int i = 0; i < bufferUsages.getLength(); ++i)
+    {
+        const BufferUsage& u = bufferUsages[i];
+        
+        LuaVar b = luaAccess.newTable();
+               b["fileName"]          = u.fileName;
+               b["windows"]           = u.numberOfWindows;
+               b["textLength"]        = u.textLength;
+               b["textBytes"]         = u.textBytes;
+               b["marks"]             = u.numberOfMarks;
+               b["markBytes"]         = u.markBytes;
+               b["historyActions"]    = u.numberOfHistoryActions;
+               b["historyDataLength"] = u.historyDataLength;
+               b["historyBytes"]      = u.historyBytes;
+               b["breaks"]            = u.numberOfBreaks;
+               b["hilitingBytes"]     = u.hilitingBytes;
+               b["styleBufferBytes"]  = u.styleBufferBytes;
+               b["lineInfoBytes"]     = u.lineInfoBytes;
+               b["totalBytes"]        = u.getTotalBytes();
+        buffers[i + 1] = b;
+    }
+    LuaVar rslt = luaAccess.newTable();
+           rslt["buffers"]             = buffers;
+           rslt["luaHeapBytes"]        = luaHeapBytes;
+           rslt["textStyles"]          = numberOfTextStyles;
+           rslt["fontInfos"]           = numberOfFontInfos;
+           rslt["fontInfoBytes"]       = fontInfoBytes;
+           rslt["heapObjectPoolBytes"] = heapObjectPoolBytes;
+           rslt["totalBytes"]          = getTotalBytes();
+    return rslt;
+}
+
+
+/**
+ * One line per buffer with fixed width columns, so that the
+ * report can be sorted by any column with the line operations.
+ */
+String MemoryStatistics::toReport() const
+{
+    char buffer[200];
+    
+    String rslt;
+    
+    sprintf(buffer, "%12s %12s %12s %12s %12s %12s %7s  %s\n",
+                    "total", "text", "marks", "history", "hiliting", "display", "windows", "file");
+    rslt << buffer;
+
+    for (int i = 0; i < bufferUsages.getLength(); ++i)
+    {
+        const BufferUsage& u = bufferUsages[i];
+        
+        sprintf(buffer, "%12ld %12ld %12ld %12ld %12ld %12ld %7d  ",
+                        u.getTotalBytes(), u.textBytes, u.markBytes, u.historyBytes,
+                        u.hilitingBytes, u.styleBufferBytes + u.lineInfoBytes, u.numberOfWindows);
+        rslt << buffer << u.fileName << "\n";
+    }
+    rslt << "\n";
+    
+    sprintf(buffer, "%12ld  Lua interpreter heap\n", luaHeapBytes);
+    rslt << buffer;
+    sprintf(buffer, "%12ld  %ld fonts for %ld text styles\n", fontInfoBytes, numberOfFontInfos, numberOfTextStyles);
+    rslt << buffer;
+    sprintf(buffer, "%12ld  pooled storage for small objects\n", heapObjectPoolBytes);
+    rslt << buffer;
+    sprintf(buffer, "%12ld  total\n", getTotalBytes());
+    rslt << buffer;
+
+    return rslt;
+}
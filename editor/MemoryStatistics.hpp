@@ -0,0 +1,106 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MEMORY_STATISTICS_HPP
+#define MEMORY_STATISTICS_HPP
+
+#include "String.hpp"
+#include "ObjectArray.hpp"
+#include "LuaVar.hpp"
+#include "LuaAccess.hpp"
+
+namespace LucED
+{
+
+/**
+ * Snapshot of the memory allocated for the open buffers and the
+ * global caches. Buffers shown in several windows are counted once,
+ * the display data of all their windows is summed up.
+ */
+class MemoryStatistics
+{
+public:
+    struct BufferUsage
+    {
+        BufferUsage();
+        
+        long getTotalBytes() const {
+            return textBytes + markBytes + historyBytes + hilitingBytes + styleBufferBytes + lineInfoBytes;
+        }
+        
+        String fileName;
+        int    numberOfWindows;
+        long   textLength;
+        long   textBytes;
+        long   numberOfMarks;
+        long   markBytes;
+        long   numberOfHistoryActions;
+        long   historyDataLength;
+        long   historyBytes;
+        long   numberOfBreaks;
+        long   hilitingBytes;
+        long   styleBufferBytes;
+        long   lineInfoBytes;
+    };
+    
+    static MemoryStatistics collect(LuaAccess luaAccess);
+    
+    /**
+     * Sorted by total bytes, biggest consumer first.
+     */
+    const ObjectArray<BufferUsage>& getBufferUsages() const {
+        return bufferUsages;
+    }
+    long getLuaHeapBytes() const {
+        return luaHeapBytes;
+    }
+    long getFontInfoBytes() const {
+        return fontInfoBytes;
+    }
+    long getHeapObjectPoolBytes() const {
+        return heapObjectPoolBytes;
+    }
+    long getTotalBytes() const;
+    
+    LuaVar toLua(LuaAccess luaAccess) const;
+    
+    String toReport() const;
+    
+private:
+    MemoryStatistics()
+        : luaHeapBytes(0),
+          numberOfTextStyles(0),
+          numberOfFontInfos(0),
+          fontInfoBytes(0),
+          heapObjectPoolBytes(0)
+    {}
+    
+    ObjectArray<BufferUsage> bufferUsages;
+    long                     luaHeapBytes;
+    long                     numberOfTextStyles;
+    long                     numberOfFontInfos;
+    long                     fontInfoBytes;
+    long                     heapObjectPoolBytes;
+};
+
+} // namespace LucED
+
+#endif // MEMORY_STATISTICS_HPP
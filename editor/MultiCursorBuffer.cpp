@@ -0,0 +1,160 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#include "MultiCursorBuffer.hpp"
+#include "util.hpp"
+
+using namespace LucED;
+
+namespace // anonymous namespace
+{
+
+class PositionComparator
+{
+public:
+    bool operator()(TextData::TextMark m1, TextData::TextMark m2) const {
+        return m1.getPos() < m2.getPos();
+    }
+};
+
+} // anonymous namespace
+
+
+MultiCursorBuffer::MultiCursorBuffer(RawPtr<TextData> textData)
+    : textData(textData),
+      lastBeginPos(0),
+      lastEndPos(0)
+{}
+
+
+void MultiCursorBuffer::addCursor(const TextData::TextMark& mark)
+{
+    cursors.append(mark);
+    sortCursors();
+}
+
+
+void MultiCursorBuffer::addCursors(const ObjectArray<TextData::TextMark>& marks)
+{
+    cursors.append(marks, 0, marks.getLength());
+    sortCursors();
+}
+
+
+void MultiCursorBuffer::sortCursors()
+{
+    long n = cursors.getLength();
+    
+    for (long i = 1; i < n; ++i) {
+        if (cursors[i].getPos() < cursors[i - 1].getPos()) {
+            std::stable_sort(cursors.getPtr(0), cursors.getPtr(0) + n, PositionComparator());
+            break;
+        }
+    }
+}
+
+
+void MultiCursorBuffer::clear()
+{
+    if (cursors.getLength() > 0) {
+        cursors.clear();
+        notifyAboutChangedRange();
+    }
+}
+
+
+void MultiCursorBuffer::treatMovedCursors(long primaryCursorPos)
+{
+    long n = cursors.getLength();
+    long w = 0;
+    
+    for (long i = 0; i < n; ++i)
+    {
+        long pos = cursors[i].getPos();
+        
+        if (pos != primaryCursorPos && (w == 0 || cursors[w - 1].getPos() != pos))
+        {
+            if (w != i) {
+                cursors[w] = cursors[i];
+            }
+            ++w;
+        }
+    }
+    if (w < n) {
+        cursors.removeAmount(w, n - w);
+    }
+    notifyAboutChangedRange();
+}
+
+
+/**
+ * The changed range covers the cursors before and after the
+ * change, the display only redraws the visible part of it.
+ */
+void MultiCursorBuffer::notifyAboutChangedRange()
+{
+    long beginPos = lastBeginPos;
+    long endPos   = lastEndPos;
+
+    if (cursors.getLength() > 0) 
+    {
+        long firstPos = cursors[0].getPos();
+        long lastPos  = cursors.getLast().getPos() + 1;
+
+        if (beginPos < endPos) {
+            util::minimize(&beginPos, firstPos);
+            util::maximize(&endPos,   lastPos);
+        } else {
+            beginPos = firstPos;
+            endPos   = lastPos;
+        }
+        lastBeginPos = firstPos;
+        lastEndPos   = lastPos;
+    }
+    else {
+        lastBeginPos = 0;
+        lastEndPos   = 0;
+    }
+    if (beginPos < endPos) {
+        updateListeners.invokeAllCallbacks(HilitingBuffer::UpdateInfo(beginPos, 
+                                                                      util::minimum(endPos, textData->getLength())));
+    }
+}
+
+
+bool MultiCursorBuffer::isCursorAt(long textPos)
+{
+    long low  = 0;
+    long high = cursors.getLength();
+    
+    while (low < high) {
+        long mid = (low + high) / 2;
+        if (cursors[mid].getPos() < textPos) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low < cursors.getLength() && cursors[low].getPos() == textPos;
+}
+
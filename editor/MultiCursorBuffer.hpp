@@ -0,0 +1,111 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MULTI_CURSOR_BUFFER_HPP
+#define MULTI_CURSOR_BUFFER_HPP
+
+#include "HeapObject.hpp"
+#include "TextData.hpp"
+#include "ObjectArray.hpp"
+#include "CallbackContainer.hpp"
+#include "HilitingBuffer.hpp"
+#include "OwningPtr.hpp"
+#include "RawPtr.hpp"
+
+namespace LucED
+{
+
+/**
+ * Additional cursors of a text widget besides its primary cursor.
+ *
+ * The cursors are text marks sorted by position. Text changes never 
+ * change the order of marks, but may move several cursors to the same
+ * position, therefore treatMovedCursors() merges them.
+ */
+class MultiCursorBuffer : public HeapObject
+{
+public:
+    typedef OwningPtr<MultiCursorBuffer> Ptr;
+    
+    enum { CURSOR_BACKGROUND = 4 };
+    
+    static Ptr create(RawPtr<TextData> textData) {
+        return Ptr(new MultiCursorBuffer(textData));
+    }
+    
+    bool hasCursors() const {
+        return cursors.getLength() > 0;
+    }
+    long getNumberOfCursors() const {
+        return cursors.getLength();
+    }
+    long getCursorPos(long i) {
+        return cursors[i].getPos();
+    }
+    TextData::TextMark getCursorMark(long i) {
+        return cursors[i];
+    }
+    
+    /**
+     * The given marks are taken over as cursors, i.e. they should
+     * not be moved afterwards by the caller.
+     */
+    void addCursor(const TextData::TextMark& mark);
+    void addCursors(const ObjectArray<TextData::TextMark>& marks);
+    void clear();
+
+    /**
+     * Must be called after cursor marks were moved. Merges cursors at
+     * the same position and removes a cursor at the position of
+     * the primary cursor.
+     */
+    void treatMovedCursors(long primaryCursorPos);
+    
+    byte getBackground(long textPos) {
+        if (cursors.getLength() == 0) {
+            return 0;
+        }
+        return isCursorAt(textPos) ? CURSOR_BACKGROUND : 0;
+    }
+    
+    void registerUpdateListener(Callback<HilitingBuffer::UpdateInfo>::Ptr updateCallback) {
+        updateListeners.registerCallback(updateCallback);
+    }
+    
+private:
+    MultiCursorBuffer(RawPtr<TextData> textData);
+    
+    bool isCursorAt(long textPos);
+    void sortCursors();
+    void notifyAboutChangedRange();
+    
+    RawPtr<TextData>               textData;
+    ObjectArray<TextData::TextMark> cursors;
+    
+    long lastBeginPos;
+    long lastEndPos;
+    
+    CallbackContainer<HilitingBuffer::UpdateInfo> updateListeners;
+};
+
+} // namespace LucED
+
+#endif // MULTI_CURSOR_BUFFER_HPP
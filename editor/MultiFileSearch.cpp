@@ -0,0 +1,453 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "MultiFileSearch.hpp"
+#include "EventDispatcher.hpp"
+#include "TopWinList.hpp"
+#include "EditorTopWin.hpp"
+#include "GlobalConfig.hpp"
+#include "FindUtil.hpp"
+#include "RegexException.hpp"
+#include "File.hpp"
+#include "util.hpp"
+
+using namespace LucED;
+
+namespace // anonymous namespace
+{
+
+const int  MAX_WORKERS                = 16;
+const long MAX_RESULT_LINE_LENGTH     = 512;
+const long RESULT_UPDATE_MICRO_SECS   = 100 * 1000;
+const long MAX_FILE_SIZE              = 0x7fffffff;
+const long CANCEL_CHECK_MATCHES       = 64;
+
+const char* const PCRE_VERBS[] = { "ACCEPT", "COMMIT", "F", "FAIL", "PRUNE", "SKIP", "THEN",
+                                   "CR", "LF", "CRLF", "ANYCRLF", "ANY", "UTF8", NULL };
+
+bool isPcreVerbAt(const String& pattern, int pos)
+{
+    for (int i = 0; PCRE_VERBS[i] != NULL; ++i) {
+        long verbEnd = pos + strlen(PCRE_VERBS[i]);
+        
+        if (   pattern.equalsSubstringAt(Pos(pos), PCRE_VERBS[i])
+            && verbEnd < pattern.getLength() && pattern[verbEnd] == ')')
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Returns true if the pattern contains a Lua callout "(*...)" or a
+ * numbered callout "(?C...)". These cannot be evaluated in the worker
+ * threads. Escaped characters, character classes and PCRE verbs 
+ * like "(*FAIL)" are not callouts.
+ */
+bool containsCallout(const String& pattern)
+{
+    bool inClass = false;
+    
+    for (int i = 0, n = pattern.getLength(); i < n; ++i)
+    {
+        if (pattern[i] == '\\') {
+            ++i;
+        }
+        else if (inClass) {
+            if (pattern[i] == ']') {
+                inClass = false;
+            }
+        }
+        else if (pattern[i] == '[') {
+            inClass = true;
+            if (i + 1 < n && pattern[i + 1] == '^') {
+                ++i;
+            }
+            if (i + 1 < n && pattern[i + 1] == ']') {
+                ++i;
+            }
+        }
+        else if (pattern[i] == '(' && i + 1 < n)
+        {
+            if (pattern[i + 1] == '*' && !isPcreVerbAt(pattern, i + 2)) {
+                return true;
+            }
+            if (pattern.equalsSubstringAt(Pos(i + 1), "?C")) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+ObjectArray<MultiFileSearch::WeakPtr> runningSearches;
+
+} // anonymous namespace
+
+
+MultiFileSearch::WeakPtr MultiFileSearch::start(const SearchParameter& p, const ObjectArray<String>& directories)
+{
+    OwningPtr rslt(new MultiFileSearch(p));
+    
+    String findString = p.getFindString();
+
+    if (findString.getLength() == 0) {
+        throw RegexException("Empty search string");
+    }
+    if (p.hasRegexFlag() && containsCallout(findString)) {
+        throw RegexException("Lua callouts are not supported for searching in files");
+    }
+    if (!p.hasRegexFlag() && !p.hasIgnoreCaseFlag() && !p.hasWholeWordFlag()) {
+        rslt->literal = findString;
+    }
+    else {
+        String pattern = p.hasRegexFlag() ? findString : FindUtil::quoteRegexCharacters(findString);
+        if (p.hasWholeWordFlag()) {
+            pattern = String() << "\\b" << pattern << "\\b";
+        }
+        BasicRegex::CreateOptions opts = BasicRegex::MULTILINE;
+        if (p.hasIgnoreCaseFlag()) {
+            opts |= BasicRegex::IGNORE_CASE;
+        }
+        rslt->regex = BasicRegex(pattern, opts);
+    }
+    
+    ObjectArray<String> absoluteDirectories;
+    String              header = String() << "Searching for '" << findString << "' in";
+
+    for (int i = 0; i < directories.getLength(); ++i) {
+        absoluteDirectories.append(File(directories[i]).getAbsoluteName());
+        header << " " << absoluteDirectories.getLast();
+    }
+    header << "\n\n";
+
+    String resultDirectory = (absoluteDirectories.getLength() > 0) ? absoluteDirectories[0] 
+                                                                   : File(".").getAbsoluteName();
+    TextData::Ptr    textData    = TextData::create();
+                     textData->setPseudoFileName(String() << resultDirectory << "/Find Results");
+    HilitedText::Ptr hilitedText = HilitedText::create(textData, GlobalConfig::getInstance()->getDefaultLanguageMode());
+
+    rslt->resultTextData = textData;
+    rslt->appendResult(header);
+    
+    EditorTopWin::Ptr win = EditorTopWin::create(hilitedText);
+                      win->show();
+    
+    runningSearches.append(rslt);
+    EventDispatcher::getInstance()->registerRunningComponent(rslt);
+    
+    rslt->collectOpenTextData(absoluteDirectories);
+    rslt->startWalk(absoluteDirectories);
+    
+    return rslt;
+}
+
+
+bool MultiFileSearch::cancelSearchesFor(RawPtr<TextData> resultTextData)
+{
+    bool wasCancelled = false;
+
+    for (int i = 0; i < runningSearches.getLength();)
+    {
+        if (!runningSearches[i].isValid() || !runningSearches[i]->isRunning()) {
+            runningSearches.remove(i);
+        }
+        else {
+            if (runningSearches[i]->resultTextData == resultTextData) {
+                runningSearches[i]->cancel();
+                wasCancelled = true;
+            }
+            ++i;
+        }
+    }
+    return wasCancelled;
+}
+
+
+MultiFileSearch::MultiFileSearch(const SearchParameter& p)
+    : DirectoryWalker(MAX_WORKERS, MicroSeconds(RESULT_UPDATE_MICRO_SECS)),
+      p(p),
+      finishedFlag(false),
+      numberOfSearchedFiles(0),
+      numberOfMatchingFiles(0),
+      numberOfMatches(0)
+{}
+
+
+MultiFileSearch::~MultiFileSearch()
+{
+    stopWalk();
+}
+
+
+/**
+ * The open TextDatas may contain unsaved changes, they are searched 
+ * instead of the files. Their file names are collected before the workers
+ * are started, so that the workers can skip these files.
+ */
+void MultiFileSearch::collectOpenTextData(const ObjectArray<String>& directories)
+{
+    RawPtr<TopWinList> topWins = TopWinList::getInstance();
+    
+    for (int w = 0; w < topWins->getNumberOfTopWins(); ++w)
+    {
+        EditorTopWin* topWin = dynamic_cast<EditorTopWin*>(topWins->getTopWin(w));
+        
+        if (topWin == NULL) {
+            continue;
+        }
+        TextData::Ptr textData = topWin->getHilitedText()->getTextData();
+        
+        if (textData->isFileNamePseudo()) {
+            continue;
+        }
+        String fileName = File(textData->getFileName()).getAbsoluteName();
+        
+        if (searchedFileNames.hasKey(fileName)) {
+            continue;
+        }
+        for (int i = 0; i < directories.getLength(); ++i)
+        {
+            if (isInDirectory(fileName, directories[i]))
+            {
+                searchedFileNames.set(fileName, true);
+                openTextDatas.append(OpenTextData(textData, fileName));
+                break;
+            }
+        }
+    }
+}
+
+
+/**
+ * Searches the collected open TextDatas until endTime.
+ */
+bool MultiFileSearch::processInMainThread(TimeStamp endTime)
+{
+    MemArray<int> ovector;
+    
+    if (regex.isValid()) {
+        ovector.increaseTo(regex.getOvecSize());
+    }
+    while (openTextDatas.getLength() > 0 && TimeStamp::now() < endTime)
+    {
+        OpenTextData openTextData = openTextDatas.getLast();
+        openTextDatas.removeLast();
+        
+        if (!openTextData.textData.isValid()) {
+            continue;
+        }
+        RawPtr<TextData> textData = openTextData.textData;
+        long             length   = textData->getLength();
+        const char*      buffer   = (const char*) textData->getAmount(0, length);
+        String           output;
+        
+        searchBuffer(openTextData.fileName, buffer, length, ovector, output);
+        
+        Mutex::Lock lock(mutex);
+        
+        pendingOutput << output;
+        ++numberOfSearchedFiles;
+    }
+    return openTextDatas.getLength() == 0;
+}
+
+
+/**
+ * Does not wait for the workers: they stop at their next cancel check and
+ * the search is finished after all workers have finished.
+ */
+void MultiFileSearch::cancel()
+{
+    if (!finishedFlag) {
+        openTextDatas.clear();
+        cancelWalk();
+    }
+}
+
+
+bool MultiFileSearch::shouldProcessFile(const String& fileName, long fileSize)
+{
+    return fileSize <= MAX_FILE_SIZE && !searchedFileNames.hasKey(fileName);
+}
+
+
+void MultiFileSearch::processFile(const String& fileName, long modificationTime, long fileSize)
+{
+    MappedFile mappedFile(fileName, MAX_FILE_SIZE);
+    
+    if (!mappedFile.isValid()) {
+        return;
+    }
+    String output;
+    
+    if (!mappedFile.isBinary())
+    {
+        MemArray<int> ovector;
+        if (regex.isValid()) {
+            ovector.increaseTo(regex.getOvecSize());
+        }
+        searchBuffer(fileName, mappedFile.getBuffer(), mappedFile.getLength(), ovector, output);
+    }
+    Mutex::Lock lock(mutex);
+    
+    ++numberOfSearchedFiles;
+    pendingOutput << output;
+}
+
+
+/**
+ * Appends one result line for each line containing a match.
+ * May be called concurrently: only reads the compiled regex.
+ * Stops early if the search has been cancelled.
+ */
+void MultiFileSearch::searchBuffer(const String& fileName, const char* buffer, long length,
+                                   MemArray<int>& ovector, String& output)
+{
+    long lineNumber    = 1;
+    long lineBegin     = 0;
+    long countedPos    = 0;
+    long pos           = 0;
+    long matches       = 0;
+    
+    const char* literalPtr    = literal.toCString();
+    const long  literalLength = literal.getLength();
+    
+    while (pos < length)
+    {
+        if (matches % CANCEL_CHECK_MATCHES == 0 && isWalkCancelled()) {
+            break;
+        }
+        long matchBegin = -1;
+        
+        if (literalLength > 0)
+        {
+            // literal fast path: memchr for the first byte, memcmp for the rest
+            
+            const char* p   = buffer + pos;
+            const char* end = buffer + length - literalLength;
+            
+            while (p <= end && (p = (const char*) memchr(p, literalPtr[0], end - p + 1)) != NULL) {
+                if (memcmp(p, literalPtr, literalLength) == 0) {
+                    matchBegin = p - buffer;
+                    break;
+                }
+                ++p;
+            }
+        }
+        else if (regex.findMatch(buffer, length, pos, BasicRegex::MatchOptions(), ovector))
+        {
+            matchBegin = ovector[0];
+        }
+        if (matchBegin < 0) {
+            break;
+        }
+        for (const char* p = buffer + countedPos; 
+             (p = (const char*) memchr(p, '\n', matchBegin - (p - buffer))) != NULL; ++p)
+        {
+            ++lineNumber;
+            lineBegin = p - buffer + 1;
+        }
+        const char* nl      = (const char*) memchr(buffer + matchBegin, '\n', length - matchBegin);
+        long        lineEnd = (nl != NULL) ? (nl - buffer) : length;
+        
+        output << fileName << ":" << lineNumber << ": "
+               << String(buffer + lineBegin, util::minimum(lineEnd - lineBegin, MAX_RESULT_LINE_LENGTH))
+               << "\n";
+        ++matches;
+        
+        countedPos = lineEnd;
+        pos        = lineEnd + 1;
+    }
+    if (matches > 0)
+    {
+        Mutex::Lock lock(mutex);
+        ++numberOfMatchingFiles;
+        numberOfMatches += matches;
+    }
+}
+
+
+void MultiFileSearch::handleWalkProgress()
+{
+    flushResults();
+}
+
+
+void MultiFileSearch::flushResults()
+{
+    String output;
+    {
+        Mutex::Lock lock(mutex);
+        output = pendingOutput;
+        pendingOutput = String();
+    }
+    if (!resultTextData.isValid()) {
+        cancel();
+        return;
+    }
+    if (output.getLength() > 0) {
+        appendResult(output);
+    }
+}
+
+
+/**
+ * The mark is only held while inserting: the result window 
+ * may be closed while the search is running.
+ */
+void MultiFileSearch::appendResult(const String& text)
+{
+    bool               wasModified = resultTextData->getModifiedFlag();
+    TextData::TextMark mark        = resultTextData->createNewMark();
+    
+    mark.moveToPos(resultTextData->getLength());
+    resultTextData->insertAtMark(mark, text);
+    
+    if (!wasModified) {
+        resultTextData->setModifiedFlag(false);
+    }
+}
+
+
+void MultiFileSearch::handleWalkFinished()
+{
+    finishedFlag = true;
+
+    if (resultTextData.isValid())
+    {
+        flushResults();
+        
+        bool   wasCancelled = isWalkCancelled();
+        String summary;
+        {
+            Mutex::Lock lock(mutex);
+            summary << "\n" << numberOfMatches << " matches in " << numberOfMatchingFiles << " files, "
+                    << numberOfSearchedFiles << " files searched" 
+                    << (wasCancelled ? ", cancelled" : "") << "\n";
+        }
+        appendResult(summary);
+    }
+    EventDispatcher::getInstance()->deregisterRunningComponent(this);
+}
@@ -0,0 +1,128 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MULTI_FILE_SEARCH_HPP
+#define MULTI_FILE_SEARCH_HPP
+
+#include "config.h"
+
+#include "DirectoryWalker.hpp"
+#include "OwningPtr.hpp"
+#include "WeakPtr.hpp"
+#include "RawPtr.hpp"
+#include "ObjectArray.hpp"
+#include "HashMap.hpp"
+#include "String.hpp"
+#include "TimeStamp.hpp"
+#include "BasicRegex.hpp"
+#include "SearchParameter.hpp"
+#include "TextData.hpp"
+
+namespace LucED
+{
+
+/**
+ * Searches all files below some directories and the contents of the
+ * open editor windows for files in these directories.
+ *
+ * The matching lines are appended as "fileName:lineNumber: line" to a
+ * result window while the search is running. The files are searched by
+ * the workers of the DirectoryWalker, the open editor windows are searched
+ * in the main thread in time slices between the result updates. 
+ * Closing the result window cancels the search.
+ */
+class MultiFileSearch : public DirectoryWalker
+{
+public:
+    typedef LucED::OwningPtr<MultiFileSearch> OwningPtr;
+    typedef LucED::WeakPtr  <MultiFileSearch> WeakPtr;
+
+    /**
+     * Opens the result window and starts the search.
+     * Throws RegexException for an invalid search pattern.
+     */
+    static WeakPtr start(const SearchParameter& p, const ObjectArray<String>& directories);
+    
+    /**
+     * Cancels the searches writing into the given result text.
+     * Returns true if a running search was cancelled.
+     */
+    static bool cancelSearchesFor(RawPtr<TextData> resultTextData);
+    
+    ~MultiFileSearch();
+    
+    void cancel();
+    
+    bool isRunning() const {
+        return !finishedFlag;
+    }
+
+private:
+    struct OpenTextData
+    {
+        OpenTextData()
+        {}
+        OpenTextData(RawPtr<TextData> textData, const String& fileName)
+            : textData(textData), fileName(fileName)
+        {}
+        LucED::WeakPtr<TextData> textData;
+        String                   fileName;
+    };
+    
+    MultiFileSearch(const SearchParameter& p);
+    
+    void collectOpenTextData(const ObjectArray<String>& directories);
+    
+    virtual bool shouldProcessFile(const String& fileName, long fileSize);
+    virtual void processFile(const String& fileName, long modificationTime, long fileSize);
+    virtual bool processInMainThread(TimeStamp endTime);
+    virtual void handleWalkProgress();
+    virtual void handleWalkFinished();
+
+    void searchBuffer(const String& fileName, const char* buffer, long length,
+                      MemArray<int>& ovector, String& output);
+    void flushResults();
+    void appendResult(const String& text);
+
+    SearchParameter                  p;
+    BasicRegex                       regex;
+    String                           literal;
+    
+    LucED::WeakPtr<TextData>         resultTextData;
+    bool                             finishedFlag;
+    
+    /** files of open editor windows, read only while workers are running */
+    HashMap<String,bool>             searchedFileNames;
+    
+    /** open editor windows not searched yet, only accessed in the main thread */
+    ObjectArray<OpenTextData>        openTextDatas;
+    
+    // following members are protected by mutex
+    
+    String                           pendingOutput;
+    long                             numberOfSearchedFiles;
+    long                             numberOfMatchingFiles;
+    long                             numberOfMatches;
+};
+
+} // namespace LucED
+
+#endif // MULTI_FILE_SEARCH_HPP
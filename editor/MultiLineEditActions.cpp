@@ -25,7 +25,6 @@
 #include <X11/Xatom.h>
 
 #include "Clipboard.hpp"
-#include "FindUtil.hpp"
 #include "KeyModifier.hpp"
 #include "FileOpener.hpp"
 #include "Regex.hpp"
@@ -50,6 +49,7 @@ void MultiLineEditActions::cursorDown()
         } else {
             // Cursor is in last line
         }
+        e->moveAdditionalCursors(TextEditorWidget::CURSOR_DOWN);
     }
     e->assureCursorVisible();
 }
@@ -67,6 +67,7 @@ void MultiLineEditActions::cursorUp()
             freePos.extraColumns = 0;
         }
         e->moveCursorToFreePos(freePos);
+        e->moveAdditionalCursors(TextEditorWidget::CURSOR_UP);
     }
     e->assureCursorVisible();
 }
@@ -293,6 +294,62 @@ void MultiLineEditActions::shiftBlockRight()
     e->rememberCursorPixX();
 }
 
+bool MultiLineEditActions::canRearrangeSelectedLines()
+{
+    return !e->areCursorChangesDisabled() && e->hasSelection() && !e->isReadOnly();
+}
+
+void MultiLineEditActions::selectRearrangedLines(const LineOperations& lineOperations)
+{
+    e->moveCursorToTextPosition(lineOperations.getEndPos());
+    e->setPrimarySelection(lineOperations.getBeginPos(), lineOperations.getEndPos());
+    e->assureSelectionVisible();
+    e->rememberCursorPixX();
+}
+
+void MultiLineEditActions::sortLines()
+{
+    if (canRearrangeSelectedLines())
+    {
+        LineOperations lineOperations(e->getTextData(), e->getBeginSelectionPos(), e->getEndSelectionPos());
+        lineOperations.sort(LineOperations::SortOptions());
+        selectRearrangedLines(lineOperations);
+    }
+}
+
+void MultiLineEditActions::sortLinesNumerically()
+{
+    if (canRearrangeSelectedLines())
+    {
+        LineOperations::SortOptions options;
+                                    options.numeric = true;
+
+        LineOperations lineOperations(e->getTextData(), e->getBeginSelectionPos(), e->getEndSelectionPos());
+        lineOperations.sort(options);
+        selectRearrangedLines(lineOperations);
+    }
+}
+
+void MultiLineEditActions::uniqueLines()
+{
+    if (canRearrangeSelectedLines())
+    {
+        LineOperations lineOperations(e->getTextData(), e->getBeginSelectionPos(), e->getEndSelectionPos());
+        lineOperations.unique();
+        selectRearrangedLines(lineOperations);
+    }
+}
+
+void MultiLineEditActions::reverseLines()
+{
+    if (canRearrangeSelectedLines())
+    {
+        LineOperations lineOperations(e->getTextData(), e->getBeginSelectionPos(), e->getEndSelectionPos());
+        lineOperations.reverse();
+        selectRearrangedLines(lineOperations);
+    }
+}
+
 void MultiLineEditActions::cursorPageDown()
 {
     if (!e->areCursorChangesDisabled())
@@ -474,7 +531,17 @@ void MultiLineEditActions::appendNewLineAutoIndent()
 
 void MultiLineEditActions::newLineAutoIndent(bool insert)
 {
-    if (!e->areCursorChangesDisabled() && !e->isReadOnly())
+    if (insert && e->hasAdditionalCursors() && !e->areCursorChangesDisabled() && !e->isReadOnly())
+    {
+        // no auto indentation with additional cursors, the same text
+        // is inserted at all cursors
+        
+        e->setCurrentActionCategory(TextEditorWidget::ACTION_NEWLINE);
+        e->hideCursor();
+        e->releaseSelection();
+        e->insertAtAllCursors("\n");
+    }
+    else if (!e->areCursorChangesDisabled() && !e->isReadOnly())
     {
         e->setCurrentActionCategory(TextEditorWidget::ACTION_NEWLINE);
         
@@ -605,263 +672,182 @@ void MultiLineEditActions::newLineFixedColumnIndentBackward()
 }
 
 
-void MultiLineEditActions::findNextLuaStructureElement()
+RawPtr<BlockMatcher> MultiLineEditActions::getBlockMatcher()
 {
-    #define LUA_BEGIN_WORDS "function|if|do|repeat"
-    #define LUA_END_WORDS   "end|until"
-    #define LUA_ALL_WORDS   LUA_BEGIN_WORDS "|" LUA_END_WORDS "|then|else|elseif|while|for"
+    if (!blockMatcher.isValid() || blockMatcher->getHilitedText() != e->getHilitedText()) {
+        blockMatcher = BlockMatcher::create(e->getHilitedText());
+    }
+    return blockMatcher;
+}
+
 
+void MultiLineEditActions::findNextLuaStructureElement()
+{
     if (!e->areCursorChangesDisabled())
     {
         e->hideCursor();
 
-        FindUtil findUtil(e->getTextData());
+        RawPtr<BlockMatcher> m = getBlockMatcher();
 
         long cursorPos = e->getCursorTextPosition();
+        long foundIndex;
+        long index     = m->findElementAt(cursorPos, true);
         
-        long beginWordPos   = findUtil.find("(?<=^|\\W)\\w+", cursorPos, FindUtil::Options() | FindUtil::REGEX | FindUtil::BACKWARD);
-        long endWordPos     = -1;
-        bool isCursorAtWord = false;
-        
-        if (beginWordPos >= 0) {
-            endWordPos = findUtil.getMatchEndPos();
-            isCursorAtWord = (beginWordPos <= cursorPos && cursorPos <= endWordPos);
-        }
-        
-        bool wasFound = false;
-        
-        if (   isCursorAtWord
-            && findUtil.doesMatch("\\b(" LUA_ALL_WORDS ")\\b", beginWordPos, FindUtil::Options() | FindUtil::REGEX))
+        if (index >= 0)
         {
-            if (findUtil.doesMatch("\\b(function|repeat|do)\\b", beginWordPos, FindUtil::Options() | FindUtil::REGEX))
-            {
-                int counter = 1;
-                while (counter > 0)
-                {
-                    if (counter == 1) {
-                        beginWordPos = findUtil.find("\\b(" LUA_BEGIN_WORDS "|" LUA_END_WORDS "|then|else|elseif)\\b", endWordPos, FindUtil::Options() | FindUtil::REGEX);
-                    } else {
-                        beginWordPos = findUtil.find("\\b(" LUA_BEGIN_WORDS "|" LUA_END_WORDS ")\\b", endWordPos, FindUtil::Options() | FindUtil::REGEX);
-                    }
-                    if (beginWordPos == -1) {
-                        break;
-                    }
-                    endWordPos   = findUtil.getMatchEndPos();
-
-                    if (findUtil.doesMatch("\\b(" LUA_BEGIN_WORDS ")\\b", beginWordPos, FindUtil::Options() | FindUtil::REGEX))
-                    {
-                        ++counter;
-                    }
-                    else
-                    {
-                        --counter;
-                    }
-                }
-                wasFound = (counter == 0);
-            }
-            else if (findUtil.doesMatch("\\b(if|while|for|elseif)\\b", beginWordPos, FindUtil::Options() | FindUtil::REGEX))
-            {
-                beginWordPos = findUtil.find("\\b(" LUA_ALL_WORDS ")\\b", endWordPos, FindUtil::Options() | FindUtil::REGEX);
-                if (beginWordPos >= 0)
-                {
-                    endWordPos = findUtil.getMatchEndPos();
-                    wasFound = true;
-                }
-            }
-            else if (findUtil.doesMatch("\\b(end|until)\\b", beginWordPos, FindUtil::Options() | FindUtil::REGEX))
-            {
-                beginWordPos = findUtil.find("\\b(" LUA_ALL_WORDS ")\\b", endWordPos, FindUtil::Options() | FindUtil::REGEX);
-                if (beginWordPos >= 0)
-                {
-                    endWordPos = findUtil.getMatchEndPos();
-                    if (!findUtil.doesMatch("\\b(end|until|then|else|elseif)\\b", beginWordPos, FindUtil::Options() | FindUtil::REGEX))
-                    {
-                        wasFound = true;
-                    }
-                }
-            }
-            else if (findUtil.doesMatch("\\b(then|else)\\b", beginWordPos, FindUtil::Options() | FindUtil::REGEX))
-            {
-                int counter = 1;
-                while (counter > 0)
-                {
-                    if (counter == 1) {
-                        beginWordPos = findUtil.find("\\b(" LUA_BEGIN_WORDS "|" LUA_END_WORDS "|then|else|elseif)\\b", endWordPos, FindUtil::Options() | FindUtil::REGEX);
-                    } else {
-                        beginWordPos = findUtil.find("\\b(" LUA_BEGIN_WORDS "|" LUA_END_WORDS ")\\b", endWordPos, FindUtil::Options() | FindUtil::REGEX);
-                    }
-
-                    if (beginWordPos == -1) {
-                        break;
-                    }
-                    endWordPos   = findUtil.getMatchEndPos();
-
-                    if (findUtil.doesMatch("\\b(" LUA_BEGIN_WORDS ")\\b", beginWordPos, FindUtil::Options() | FindUtil::REGEX))
-                    {
-                        ++counter;
-                    }
-                    else
-                    {
-                        --counter;
-                    }
-                }
-                wasFound = (counter == 0);
-            }
-            else {
-                wasFound = true;
+            if (m->getElement(index).type != BlockMatcher::END) {
+                foundIndex = m->findNextElementOfBlock(index);
+            } else {
+                foundIndex = m->findNextElement(m->getElement(index).endPos);
             }
         }
-        else
-        {
-            beginWordPos = findUtil.find("\\b(" LUA_ALL_WORDS ")\\b", cursorPos, FindUtil::Options() | FindUtil::REGEX); 
-            if (beginWordPos >= 0) {
-                wasFound = true;
-                endWordPos = findUtil.getMatchEndPos();
-            }
+        else {
+            foundIndex = m->findNextElement(cursorPos);
         }
-        if (wasFound)
+        if (foundIndex >= 0)
         {
-            e->moveCursorToTextPosition(endWordPos);
-            e->setPrimarySelection(beginWordPos, endWordPos);
+            const BlockMatcher::Element& found = m->getElement(foundIndex);
+
+            e->moveCursorToTextPosition(found.endPos);
+            e->setPrimarySelection(found.beginPos, found.endPos);
         }
     }
     e->assureCursorVisible();
     e->rememberCursorPixX();
     e->showCursor();
-
-    #undef LUA_BEGIN_WORDS
-    #undef LUA_END_WORDS
-    #undef LUA_ALL_WORDS
 }
 
 
 
 void MultiLineEditActions::findPrevLuaStructureElement()
 {
-    #define LUA_BEGIN_WORDS "function|if|do|repeat"
-    #define LUA_END_WORDS   "end|until"
-    #define LUA_ALL_WORDS   LUA_BEGIN_WORDS "|" LUA_END_WORDS "|then|else|elseif|while|for"
-    
     if (!e->areCursorChangesDisabled())
     {
         e->hideCursor();
 
-        FindUtil findUtil(e->getTextData());
+        RawPtr<BlockMatcher> m = getBlockMatcher();
 
         long cursorPos = e->getCursorTextPosition();
+        long foundIndex;
+        long index     = m->findElementAt(cursorPos, false);
         
-        long beginWordPos   = findUtil.find("(?<=^|\\W)\\w+", cursorPos, FindUtil::Options() | FindUtil::REGEX | FindUtil::BACKWARD);
-        long endWordPos     = -1;
-        bool isCursorAtWord = false;
-        
-        if (beginWordPos >= 0) {
-            endWordPos = findUtil.getMatchEndPos();
-            isCursorAtWord = (beginWordPos <= cursorPos && cursorPos <= endWordPos);
+        if (index >= 0)
+        {
+            if (m->getElement(index).type != BlockMatcher::BEGIN) {
+                foundIndex = m->findPrevElementOfBlock(index);
+            } else {
+                foundIndex = m->findPrevElement(m->getElement(index).beginPos);
+            }
+        }
+        else {
+            foundIndex = m->findPrevElement(cursorPos);
+        }
+        if (foundIndex >= 0)
+        {
+            const BlockMatcher::Element& found = m->getElement(foundIndex);
+
+            e->moveCursorToTextPosition(found.beginPos);
+            e->setPrimarySelection(found.beginPos, found.endPos);
         }
+    }
+    e->assureCursorVisible();
+    e->rememberCursorPixX();
+    e->showCursor();
+}
+
+
+void MultiLineEditActions::addCursorBelow()
+{
+    if (!e->areCursorChangesDisabled() && !e->isReadOnly())
+    {
+        RawPtr<MultiCursorBuffer> cursors  = e->getMultiCursorBuffer();
+        RawPtr<TextData>          textData = e->getTextData();
         
-        bool wasFound = false;
+        TextData::TextMark m = e->createNewMarkFromCursor();
         
-        if (   isCursorAtWord
-            && findUtil.doesMatch("\\b(" LUA_ALL_WORDS ")\\b", beginWordPos, FindUtil::Options() | FindUtil::REGEX))
-        {
-            if (findUtil.doesMatch("\\b(end|until)\\b", beginWordPos, FindUtil::Options() | FindUtil::REGEX))
-            {
-                int counter = 1;
-                while (counter > 0)
-                {
-                    if (counter == 1) {
-                        beginWordPos = findUtil.find("\\b(" LUA_BEGIN_WORDS "|" LUA_END_WORDS "|then|else|elseif|repeat)\\b", beginWordPos - 1, FindUtil::Options() | FindUtil::REGEX | FindUtil::BACKWARD);
-                    } else {
-                        beginWordPos = findUtil.find("\\b(" LUA_BEGIN_WORDS "|" LUA_END_WORDS ")\\b", beginWordPos - 1, FindUtil::Options() | FindUtil::REGEX | FindUtil::BACKWARD);
-                    }
+        if (cursors->hasCursors() && cursors->getCursorPos(cursors->getNumberOfCursors() - 1) > m.getPos()) {
+            m = textData->createNewMark(cursors->getCursorMark(cursors->getNumberOfCursors() - 1));
+        }
+        if (m.getLine() + 1 < textData->getNumberOfLines()) {
+            m.moveToLineAndWCharColumn(m.getLine() + 1, e->getCursorWCharColumn());
+            e->addAdditionalCursor(m);
+        }
+    }
+}
 
-                    if (beginWordPos == -1) {
-                        break;
-                    }
-                    endWordPos   = findUtil.getMatchEndPos();
 
-                    if (findUtil.doesMatch("\\b(" LUA_END_WORDS ")\\b", beginWordPos, FindUtil::Options() | FindUtil::REGEX))
-                    {
-                        ++counter;
-                    }
-                    else
-                    {
-                        --counter;
-                    }
-                }
-                wasFound = (counter == 0);
-            }
-            else if (findUtil.doesMatch("\\b(then)\\b", beginWordPos, FindUtil::Options() | FindUtil::REGEX))
-            {
-                beginWordPos = findUtil.find("\\b(" LUA_ALL_WORDS ")\\b", beginWordPos - 1, FindUtil::Options() | FindUtil::REGEX | FindUtil::BACKWARD);
-                if (beginWordPos >= 0)
-                {
-                    endWordPos = findUtil.getMatchEndPos();
-                    wasFound = true;
-                }
-            }
-            else if (findUtil.doesMatch("\\b(do|function|if|while|for|repeat)\\b", beginWordPos, FindUtil::Options() | FindUtil::REGEX))
-            {
-                beginWordPos = findUtil.find("\\b(" LUA_ALL_WORDS ")\\b", beginWordPos - 1, FindUtil::Options() | FindUtil::REGEX | FindUtil::BACKWARD);
-                if (beginWordPos >= 0)
-                {
-                    endWordPos = findUtil.getMatchEndPos();
-                    if (!findUtil.doesMatch("\\b(function|if|repeat|do|then|else)\\b", beginWordPos, FindUtil::Options() | FindUtil::REGEX))
-                    {
-                        wasFound = true;
-                    }
-                }
-            }
-            else if (findUtil.doesMatch("\\b(then|else|elseif)\\b", beginWordPos, FindUtil::Options() | FindUtil::REGEX))
-            {
-                int counter = 1;
-                while (counter > 0)
-                {
-                    if (counter == 1) {
-                        beginWordPos = findUtil.find("\\b(" LUA_BEGIN_WORDS "|" LUA_END_WORDS "|then|else|elseif)\\b", beginWordPos - 1, FindUtil::Options() | FindUtil::REGEX | FindUtil::BACKWARD);
-                    } else {
-                        beginWordPos = findUtil.find("\\b(" LUA_BEGIN_WORDS "|" LUA_END_WORDS ")\\b", beginWordPos - 1, FindUtil::Options() | FindUtil::REGEX | FindUtil::BACKWARD);
-                    }
+void MultiLineEditActions::addCursorAbove()
+{
+    if (!e->areCursorChangesDisabled() && !e->isReadOnly())
+    {
+        RawPtr<MultiCursorBuffer> cursors  = e->getMultiCursorBuffer();
+        RawPtr<TextData>          textData = e->getTextData();
+        
+        TextData::TextMark m = e->createNewMarkFromCursor();
+        
+        if (cursors->hasCursors() && cursors->getCursorPos(0) < m.getPos()) {
+            m = textData->createNewMark(cursors->getCursorMark(0));
+        }
+        if (m.getLine() > 0) {
+            m.moveToLineAndWCharColumn(m.getLine() - 1, e->getCursorWCharColumn());
+            e->addAdditionalCursor(m);
+        }
+    }
+}
 
-                    if (beginWordPos == -1) {
-                        break;
-                    }
-                    endWordPos   = findUtil.getMatchEndPos();
 
-                    if (findUtil.doesMatch("\\b(" LUA_END_WORDS ")\\b", beginWordPos, FindUtil::Options() | FindUtil::REGEX))
-                    {
-                        ++counter;
-                    }
-                    else
-                    {
-                        --counter;
-                    }
-                }
-                wasFound = (counter == 0);
-            }
-            else {
-                wasFound = true;
-            }
+/**
+ * Adds a cursor in the column of the primary cursor to every 
+ * other line of the selection.
+ */
+void MultiLineEditActions::addCursorsToSelectedLines()
+{
+    if (!e->areCursorChangesDisabled() && !e->isReadOnly() && e->hasSelection())
+    {
+        RawPtr<TextData> textData = e->getTextData();
+        
+        long column     = e->getCursorWCharColumn();
+        long cursorLine = e->getCursorLineNumber();
+        
+        TextData::TextMark m       = e->createNewMarkFromCursor();
+        TextData::TextMark endMark = e->createNewMarkFromCursor();
+        
+        m      .moveToPos(e->getBeginSelectionPos());
+        endMark.moveToPos(e->getEndSelectionPos());
+        
+        long endLine = endMark.getLine();
+        
+        if (endMark.isAtBeginOfLine() && endLine > m.getLine()) {
+            endLine -= 1;
         }
-        else
+        e->releaseSelection();
+        
+        ObjectArray<TextData::TextMark> marks;
+        
+        m.moveToBeginOfLine();
+        
+        for (long line = m.getLine(); line <= endLine; ++line)
         {
-            beginWordPos = findUtil.find("\\b(" LUA_ALL_WORDS ")\\b", cursorPos - 1, FindUtil::Options() | FindUtil::REGEX | FindUtil::BACKWARD);
-            if (beginWordPos >= 0) {
-                wasFound = true;
-                endWordPos = findUtil.getMatchEndPos();
+            if (line != cursorLine) {
+                TextData::TextMark c = textData->createNewMark(m);
+                c.moveToLineAndWCharColumn(line, column);
+                marks.append(c);
+            }
+            if (line < endLine) {
+                m.moveToNextLineBegin();
             }
         }
-        if (wasFound)
-        {
-            e->moveCursorToTextPosition(beginWordPos);
-            e->setPrimarySelection(beginWordPos, endWordPos);
-        }
+        e->addAdditionalCursors(marks);
     }
-    e->assureCursorVisible();
-    e->rememberCursorPixX();
-    e->showCursor();
+}
 
-    #undef LUA_BEGIN_WORDS
-    #undef LUA_END_WORDS
-    #undef LUA_ALL_WORDS
+
+bool MultiLineEditActions::removeAdditionalCursors()
+{
+    if (e->hasAdditionalCursors()) {
+        e->removeAdditionalCursors();
+        return true;
+    } else {
+        return false;
+    }
 }
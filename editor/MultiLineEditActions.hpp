@@ -26,6 +26,8 @@
 #include "OwningPtr.hpp"
 #include "TextEditorWidget.hpp"
 #include "ActionMethodBinding.hpp"
+#include "BlockMatcher.hpp"
+#include "LineOperations.hpp"
 
 namespace LucED
 {
@@ -57,8 +59,16 @@ public:
     void selectionCursorPageUp();
     void shiftBlockLeft();
     void shiftBlockRight();
+    void sortLines();
+    void sortLinesNumerically();
+    void uniqueLines();
+    void reverseLines();
     void findNextLuaStructureElement();
     void findPrevLuaStructureElement();
+    void addCursorBelow();
+    void addCursorAbove();
+    void addCursorsToSelectedLines();
+    bool removeAdditionalCursors();
 
 private:
     MultiLineEditActions(RawPtr<TextEditorWidget> editWidget)
@@ -68,8 +78,14 @@ private:
 
     void newLineFixedColumnIndent(bool forward);
     void newLineAutoIndent(bool insert);
+    
+    RawPtr<BlockMatcher> getBlockMatcher();
+    
+    bool canRearrangeSelectedLines();
+    void selectRearrangedLines(const LineOperations& lineOperations);
 
     RawPtr<TextEditorWidget> e;
+    BlockMatcher::Ptr        blockMatcher;
 };
 
 } // namespace LucED
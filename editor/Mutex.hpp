@@ -50,9 +50,9 @@ public:
     class Lock
     {
     public:
-        explicit Lock(Mutex::Ptr mutex)
+        explicit Lock(const Mutex::Ptr& mutex)
         #if LUCED_USE_MULTI_THREAD
-            : mutex(mutex)
+            : mutex(mutex.getRawPtr())
         #endif
         {
         #if LUCED_USE_MULTI_THREAD
@@ -85,7 +85,9 @@ public:
         Lock& operator=(const Lock& rhs);
 
     #if LUCED_USE_MULTI_THREAD
-        Mutex::Ptr mutex;
+        // not an OwningPtr: locking from other threads must not 
+        // touch the reference counter
+        Mutex* mutex;
     #endif
     };
     
@@ -123,6 +123,9 @@ public:
     long getLength() const {
         return memArray.getLength();
     }
+    long getCapacityInBytes() const {
+        return memArray.getCapacityInBytes();
+    }
     ObjectArray<T>& clear()
     {
         invalidateAllPtrGuards();
@@ -35,8 +35,8 @@ PasteDataReceiver::PasteDataReceiver(RawPtr<GuiWidget> baseWidget, ContentHandle
     receivingPasteDataFlag(false),
     isMultiPartPastingFlag(false),
     display             (GuiRoot::getInstance()->getDisplay()),
-    x11AtomForTargets   (XInternAtom(display, "TARGETS", False)),
-    x11AtomForIncr      (XInternAtom(display, "INCR", False)),
+    x11AtomForTargets   (GuiRoot::getInstance()->getX11Atom("TARGETS")),
+    x11AtomForIncr      (GuiRoot::getInstance()->getX11Atom("INCR")),
     x11AtomForUtf8String(GuiRoot::getInstance()->getX11Utf8StringAtom())
 {
     GuiWidget::EventProcessorAccess::addToXEventMaskForGuiWidget(baseWidget, PropertyChangeMask);
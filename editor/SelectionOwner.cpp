@@ -36,11 +36,11 @@ WeakPtr<SelectionOwner> SelectionOwner::primarySelectionOwnerCandidate = NULL;
 SelectionOwner::SelectionOwner(RawPtr<GuiWidget> baseWidget, Type type, ContentHandler::Ptr contentHandler)
       : baseWidget(baseWidget),
         contentHandler(contentHandler),
-        x11AtomForSelection(type == TYPE_PRIMARY ? XA_PRIMARY : XInternAtom(GuiRoot::getInstance()->getDisplay(), "CLIPBOARD", False)),
+        x11AtomForSelection(type == TYPE_PRIMARY ? XA_PRIMARY : GuiRoot::getInstance()->getX11Atom("CLIPBOARD")),
         hasSelectionOwnershipFlag(false),
         display              (GuiRoot::getInstance()->getDisplay()),
-        x11AtomForTargets    (XInternAtom(display, "TARGETS", False)),
-        x11AtomForIncr       (XInternAtom(display, "INCR", False)),
+        x11AtomForTargets    (GuiRoot::getInstance()->getX11Atom("TARGETS")),
+        x11AtomForIncr       (GuiRoot::getInstance()->getX11Atom("INCR")),
         x11AtomForUtf8String (GuiRoot::getInstance()->getX11Utf8StringAtom()),
         lastX11Timestamp(0)
 {
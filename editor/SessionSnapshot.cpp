@@ -0,0 +1,556 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SessionSnapshot.hpp"
+#include "TopWinList.hpp"
+#include "EditorTopWin.hpp"
+#include "GlobalConfig.hpp"
+#include "GuiRoot.hpp"
+#include "ByteBuffer.hpp"
+#include "FileException.hpp"
+#include "ConfigException.hpp"
+#include "File.hpp"
+#include "ObjectArray.hpp"
+#include "WeakPtr.hpp"
+
+using namespace LucED;
+
+
+namespace // anonymous namespace
+{
+
+const char* const SESSION_FILE_HEADER = "LucED session 1\n";
+
+enum WindowState
+{
+    NORMAL_WINDOW  = 'N',
+    CURRENT_WINDOW = 'C',
+    ICONIC_WINDOW  = 'I'
+};
+
+class ViewState
+{
+public:
+    ViewState()
+        : width(-1), height(-1),
+          cursorLine(0), cursorColumn(0), topLine(0),
+          state(NORMAL_WINDOW)
+    {}
+    EditorTopWin::Ptr topWin;
+    int               width;
+    int               height;
+    long              cursorLine;
+    long              cursorColumn;
+    long              topLine;
+    char              state;
+};
+
+
+/**
+ * A file of a restored session, that is not loaded until one
+ * of its windows is mapped.
+ */
+class PendingFile : public HeapObject
+{
+public:
+    typedef OwningPtr<PendingFile> Ptr;
+    
+    static Ptr create() {
+        return Ptr(new PendingFile());
+    }
+
+    bool isSameFile(const File::Info& fileInfo) const
+    {
+        if (!fileInfo.exists()) {
+            return false;
+        }
+        TimeStamp t = fileInfo.getLastModifiedTime();
+        
+        return    (long) t.getSeconds()      == seconds
+               && (long) t.getMicroSeconds() == microSeconds
+               && fileInfo.getFileSize()     == fileSize;
+    }
+    
+    void load();
+    
+    String                 fileName;
+    long                   seconds;
+    long                   microSeconds;
+    long                   fileSize;
+    String                 languageModeName;
+    String                 encoding;
+    ObjectArray<ViewState> views;
+
+    WeakPtr<TextData>      textData;
+    WeakPtr<HilitedText>   hilitedText;
+    bool                   isLoaded;
+
+private:
+    PendingFile()
+        : seconds(-1),
+          microSeconds(0),
+          fileSize(0),
+          isLoaded(false)
+    {}
+
+    void setMessageBox(const MessageBoxParameter& p)
+    {
+        for (int i = 0; i < views.getLength(); ++i) {
+            if (views[i].topWin.isValid()) {
+                views[i].topWin->setMessageBox(p);
+                break;
+            }
+        }
+    }
+};
+
+ObjectArray<PendingFile::Ptr> pendingFiles;
+
+
+void PendingFile::load()
+{
+    if (isLoaded || textData.isInvalid()) {
+        return;
+    }
+    isLoaded = true;
+
+    try
+    {
+        ByteBuffer buffer;
+        File       file(fileName);
+        File::Info fileInfo = file.getInfo();
+        
+        file.loadInto(&buffer);
+        
+        String fileEncoding = encoding;
+        
+        if (!isSameFile(fileInfo))
+        {
+            // file was changed after the session was saved
+            try
+            {
+                GlobalConfig::LanguageModeAndEncoding result = GlobalConfig::getInstance()
+                                                               ->getLanguageModeAndEncodingForFileNameAndContent
+                                                               (
+                                                                 fileName,
+                                                                 &buffer,
+                                                                 fileInfo.getLastModifiedTime()
+                                                               );
+                if (hilitedText.isValid() && result.languageMode != hilitedText->getLanguageMode()) {
+                    hilitedText->setLanguageMode(result.languageMode);
+                }
+                if (result.encoding.getLength() > 0) {
+                    fileEncoding = result.encoding;
+                }
+            }
+            catch (ConfigException& ex)
+            {}
+        }
+        textData->takeOverFileBuffer(fileName, fileEncoding, &buffer);
+        textData->setRealFileName(fileName);
+    }
+    catch (BaseException& ex)
+    {
+        setMessageBox(MessageBoxParameter().setTitle("Error opening file")
+                                           .setMessage(ex.getMessage())
+                                           .setCancelButton("O]K"));
+        return;
+    }
+    for (int i = 0; i < views.getLength(); ++i)
+    {
+        if (views[i].topWin.isValid())
+        {
+            TextEditorWidget::Ptr textEditor = views[i].topWin->getTextEditorWidget();
+            TextData::TextMark    mark       = textData->createNewMark();
+            
+            mark.moveToLineAndWCharColumn(views[i].cursorLine, views[i].cursorColumn);
+            
+            textEditor->moveCursorToTextMark(mark);
+            textEditor->setTopLineNumber(views[i].topLine);
+        }
+    }
+    long numberOfRecoveredChanges = textData->recoverFromJournal();
+    
+    if (numberOfRecoveredChanges > 0)
+    {
+        setMessageBox(MessageBoxParameter().setTitle("Recovered changes")
+                                           .setMessage(String() << "Unsaved changes of file '" << File(fileName).getBaseName()
+                                                                << "' were recovered from the edit journal "
+                                                                << "(" << numberOfRecoveredChanges << " changes).")
+                                           .setCancelButton("O]K"));
+    }
+}
+
+
+void removeObsoletePendingFiles()
+{
+    for (int i = 0; i < pendingFiles.getLength();)
+    {
+        if (pendingFiles[i]->isLoaded || pendingFiles[i]->textData.isInvalid()) {
+            pendingFiles.remove(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+
+RawPtr<PendingFile> getPendingFile(TextData* textData)
+{
+    for (int i = 0; i < pendingFiles.getLength(); ++i) {
+        if (pendingFiles[i]->textData.getRawPtr() == textData) {
+            return pendingFiles[i];
+        }
+    }
+    return Null;
+}
+
+
+void appendViewState(ByteBuffer* buffer, const ViewState& v)
+{
+    buffer->appendString(String() << "W " << v.width 
+                                  << " "  << v.height
+                                  << " "  << v.cursorLine
+                                  << " "  << v.cursorColumn
+                                  << " "  << v.topLine
+                                  << " "  << v.state << "\n");
+}
+
+
+EditorTopWin* getEditorTopWin(int i)
+{
+    return dynamic_cast<EditorTopWin*>(TopWinList::getInstance()->getTopWin(i));
+}
+
+} // anonymous namespace
+
+
+String SessionSnapshot::getSessionFileName(const String& sessionName)
+{
+    String name = sessionName;
+    
+    if (name.getLength() == 0) {
+        if (GuiRoot::getInstance()->hasInstanceName() && GuiRoot::getInstance()->getInstanceName().getLength() > 0) {
+            name = GuiRoot::getInstance()->getInstanceName();
+        } else {
+            name = "default";
+        }
+    }
+    return File(String() << GlobalConfig::getInstance()->getConfigDirectory() << "/.sessions",
+                name.toSubstitutedString('/', '%'));
+}
+
+
+/**
+ * Format: header line, then for each file "F <seconds> <microSeconds> 
+ * <fileSize> <languageMode> <encoding> <fileName>" followed by its 
+ * windows as "W <width> <height> <cursorLine> <cursorColumn> <topLine> 
+ * <state>". The state is 'C' for the window having the focus, 'I' for
+ * iconified windows and 'N' otherwise.
+ */
+int SessionSnapshot::save(const String& sessionName)
+{
+    removeObsoletePendingFiles();
+    
+    ByteBuffer buffer;
+               buffer.appendString(SESSION_FILE_HEADER);
+    
+    int numberOfTopWins = TopWinList::getInstance()->getNumberOfTopWins();
+    int rslt            = 0;
+
+    for (int i = 0; i < numberOfTopWins; ++i)
+    {
+        EditorTopWin* topWin = getEditorTopWin(i);
+        
+        if (topWin == NULL) {
+            continue;
+        }
+        TextData*           textData = topWin->getTextEditorWidget()->getTextData().getRawPtr();
+        RawPtr<PendingFile> pending  = getPendingFile(textData);
+        
+        if (textData->isFileNamePseudo() && !pending.isValid()) {
+            continue;
+        }
+        bool isFirstWindowOfFile = true;
+        
+        for (int j = 0; j < i; ++j) {
+            if (getEditorTopWin(j) != NULL && getEditorTopWin(j)->getTextEditorWidget()->getTextData().getRawPtr() == textData) {
+                isFirstWindowOfFile = false;
+                break;
+            }
+        }
+        if (!isFirstWindowOfFile) {
+            continue;
+        }
+        if (pending.isValid())
+        {
+            buffer.appendString(String() << "F " << pending->seconds
+                                         << " "  << pending->microSeconds
+                                         << " "  << pending->fileSize
+                                         << " "  << pending->languageModeName
+                                         << " "  << pending->encoding
+                                         << " "  << pending->fileName << "\n");
+        }
+        else
+        {
+            const File::Info& fileInfo = textData->getLastFileInfo();
+            String            encoding = textData->getEncoding();
+            
+            if (fileInfo.exists()) {
+                TimeStamp t = fileInfo.getLastModifiedTime();
+                buffer.appendString(String() << "F " << (long) t.getSeconds()
+                                             << " "  << (long) t.getMicroSeconds()
+                                             << " "  << fileInfo.getFileSize());
+            } else {
+                buffer.appendString("F -1 0 0");
+            }
+            buffer.appendString(String() << " " << topWin->getHilitedText()->getLanguageMode()->getName()
+                                         << " " << (encoding.getLength() > 0 ? encoding : String("-"))
+                                         << " " << textData->getFileName() << "\n");
+        }
+        for (int j = i; j < numberOfTopWins; ++j)
+        {
+            EditorTopWin* w = getEditorTopWin(j);
+            
+            if (w == NULL || w->getTextEditorWidget()->getTextData().getRawPtr() != textData) {
+                continue;
+            }
+            ViewState v;
+            bool      hasPendingView = false;
+
+            if (pending.isValid()) {
+                for (int k = 0; k < pending->views.getLength(); ++k) {
+                    if (pending->views[k].topWin == w) {
+                        v = pending->views[k];
+                        hasPendingView = true;
+                        break;
+                    }
+                }
+            }
+            if (!hasPendingView)
+            {
+                TextEditorWidget::Ptr textEditor = w->getTextEditorWidget();
+                
+                v.cursorLine   = textEditor->getCursorLineNumber();
+                v.cursorColumn = textEditor->getCursorWCharColumn();
+                v.topLine      = textEditor->getTopLineNumber();
+            }
+            v.width  = w->getPosition().w;
+            v.height = w->getPosition().h;
+            
+            if (w->hasFocus()) {
+                v.state = CURRENT_WINDOW;
+            } else if (w->isIconified()) {
+                v.state = ICONIC_WINDOW;
+            } else {
+                v.state = NORMAL_WINDOW;
+            }
+            
+            appendViewState(&buffer, v);
+            ++rslt;
+        }
+    }
+    File sessionFile(getSessionFileName(sessionName));
+    File tempFile(String() << sessionFile << ".tmp");
+    
+    tempFile.getDir().createDirectory();
+    tempFile.storeData(&buffer);
+    
+    if (rename(tempFile.toString().toCString(), sessionFile.toString().toCString()) != 0) {
+        throw FileException(errno, String() << "error writing session file '" << sessionFile << "': " << strerror(errno));
+    }
+    return rslt;
+}
+
+
+int SessionSnapshot::restore(const String& sessionName)
+{
+    File sessionFile(getSessionFileName(sessionName));
+    
+    if (!sessionFile.exists()) {
+        return 0;
+    }
+    ByteBuffer buffer;
+    sessionFile.loadInto(&buffer);
+    
+    long headerLength = strlen(SESSION_FILE_HEADER);
+    
+    if (   buffer.getLength() < headerLength
+        || memcmp(buffer.getPtr(0), SESSION_FILE_HEADER, headerLength) != 0)
+    {
+        return 0;
+    }
+    const char* data   = (const char*) buffer.getPtr(0);
+    long        length = buffer.getLength();
+    long        pos    = headerLength;
+
+    ObjectArray<PendingFile::Ptr> files;
+    
+    while (pos < length)
+    {
+        const char* nl      = (const char*) memchr(data + pos, '\n', length - pos);
+        long        lineEnd = (nl != NULL) ? (nl - data) : length;
+        String      line(data + pos, lineEnd - pos);
+        
+        pos = lineEnd + 1;
+        
+        char* p;
+        
+        if (line.startsWith("F "))
+        {
+            PendingFile::Ptr file = PendingFile::create();
+            
+            file->seconds      = strtol(line.toCString() + 2, &p, 10);
+            file->microSeconds = strtol(p, &p, 10);
+            file->fileSize     = strtol(p, &p, 10);
+
+            const char* modeName = p + 1;
+            const char* encoding = strchr(modeName, ' ');
+            const char* fileName = (encoding != NULL) ? strchr(encoding + 1, ' ') : NULL;
+            
+            if (fileName != NULL)
+            {
+                file->languageModeName = String(modeName, encoding - modeName);
+                file->encoding         = String(encoding + 1, fileName - (encoding + 1));
+                file->fileName         = String(fileName + 1);
+                
+                if (file->encoding == "-") {
+                    file->encoding = String();
+                }
+                files.append(file);
+            }
+        }
+        else if (line.startsWith("W ") && files.getLength() > 0)
+        {
+            ViewState v;
+            
+            v.width        = strtol(line.toCString() + 2, &p, 10);
+            v.height       = strtol(p, &p, 10);
+            v.cursorLine   = strtol(p, &p, 10);
+            v.cursorColumn = strtol(p, &p, 10);
+            v.topLine      = strtol(p, &p, 10);
+            
+            if (p[0] == ' ' && (   p[1] == CURRENT_WINDOW 
+                                || p[1] == ICONIC_WINDOW)) 
+            {
+                v.state = p[1];
+            }
+            files.getLast()->views.append(v);
+        }
+    }
+    removeObsoletePendingFiles();
+
+    // missing files and files that are already open are not restored
+
+    for (int i = 0; i < files.getLength();)
+    {
+        PendingFile::Ptr file = files[i];
+        bool             skip = (file->views.getLength() == 0 || !File(file->fileName).exists());
+        
+        for (int j = 0; !skip && j < TopWinList::getInstance()->getNumberOfTopWins(); ++j) {
+            if (getEditorTopWin(j) != NULL && getEditorTopWin(j)->getFileName() == file->fileName) {
+                skip = true;
+            }
+        }
+        if (skip) {
+            files.remove(i);
+        } else {
+            ++i;
+        }
+    }
+
+    // Only the current window is shown, so that only its file is loaded,
+    // the other windows are iconified and load their files when opened.
+    // Without current window the first not iconified window is shown,
+    // otherwise the first restored window.
+    
+    int shownFile = -1;
+    int shownView = -1;
+    
+    for (int i = 0; i < files.getLength() && shownView < 0; ++i) {
+        for (int j = 0; j < files[i]->views.getLength(); ++j) {
+            if (files[i]->views[j].state == CURRENT_WINDOW) {
+                shownFile = i;
+                shownView = j;
+                break;
+            }
+        }
+    }
+    for (int i = 0; i < files.getLength() && shownView < 0; ++i) {
+        for (int j = 0; j < files[i]->views.getLength(); ++j) {
+            if (files[i]->views[j].state == NORMAL_WINDOW) {
+                shownFile = i;
+                shownView = j;
+                break;
+            }
+        }
+    }
+    if (shownView < 0 && files.getLength() > 0) {
+        shownFile = 0;
+        shownView = 0;
+    }
+    RawPtr<GlobalConfig> config = GlobalConfig::getInstance();
+    int                  rslt   = 0;
+    
+    for (int i = 0; i < files.getLength(); ++i)
+    {
+        PendingFile::Ptr file = files[i];
+        
+        LanguageMode::Ptr languageMode = config->getLanguageModes()->getLanguageMode(file->languageModeName);
+        
+        if (!languageMode.isValid()) {
+            languageMode = config->getLanguageModeForFileName(file->fileName);
+        }
+        TextData::Ptr    textData    = TextData::create();
+        HilitedText::Ptr hilitedText = HilitedText::create(textData, languageMode);
+        
+        // pseudo until loaded, so that the empty buffer cannot be saved
+        textData->setPseudoFileName(file->fileName);
+        textData->enableJournal();
+        
+        file->textData    = textData;
+        file->hilitedText = hilitedText;
+        
+        pendingFiles.append(file);
+        
+        for (int j = 0; j < file->views.getLength(); ++j)
+        {
+            EditorTopWin::Ptr topWin = EditorTopWin::create(hilitedText, file->views[j].width, 
+                                                                         file->views[j].height);
+            topWin->setFirstMappedCallback(newCallback(file, &PendingFile::load));
+            
+            if (i == shownFile && j == shownView) {
+                topWin->show();
+            } else {
+                topWin->showIconified();
+            }
+
+            file->views[j].topWin = topWin;
+            ++rslt;
+        }
+    }
+    return rslt;
+}
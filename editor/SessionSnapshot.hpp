@@ -0,0 +1,60 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SESSION_SNAPSHOT_HPP
+#define SESSION_SNAPSHOT_HPP
+
+#include "String.hpp"
+
+namespace LucED
+{
+
+/**
+ * Persists the set of editor windows with their file identities, 
+ * cursor and scroll positions, language modes and iconic states. 
+ * Restored windows are created immediately, but only the current
+ * window is shown, the others are iconified. A file is only loaded
+ * and hilited when one of its windows is mapped for the first time.
+ */
+class SessionSnapshot
+{
+public:
+    /**
+     * Writes the session file for the given name, an empty name means
+     * the session of the current LucED instance. Returns the number of
+     * saved windows.
+     */
+    static int save(const String& sessionName = "");
+    
+    /**
+     * Creates the windows of a saved session. Files that are already
+     * open or that no longer exist are skipped. Returns the number
+     * of restored windows.
+     */
+    static int restore(const String& sessionName = "");
+
+private:
+    static String getSessionFileName(const String& sessionName);
+};
+
+} // namespace LucED
+
+#endif // SESSION_SNAPSHOT_HPP
@@ -52,6 +52,7 @@ void SingleLineEditActions::cursorLeft()
         else {
             e->moveCursorRelativeWCharColumns(-1);
         }
+        e->moveAdditionalCursors(TextEditorWidget::CURSOR_LEFT);
     }
     e->assureCursorVisible();
     e->rememberCursorPixX();
@@ -73,6 +74,7 @@ void SingleLineEditActions::cursorRight()
         } else {
             e->moveCursorRelativeWCharColumns(+1);
         }
+        e->moveAdditionalCursors(TextEditorWidget::CURSOR_RIGHT);
     }
     e->assureCursorVisible();
     e->rememberCursorPixX();
@@ -355,6 +357,7 @@ void SingleLineEditActions::cursorBeginOfLine()
         TextData::TextMark mark = e->createNewMarkFromCursor();
         mark.moveToBeginOfLine();
         e->moveCursorToTextMark(mark);
+        e->moveAdditionalCursors(TextEditorWidget::CURSOR_BEGIN_OF_LINE);
     }
     e->assureCursorVisible();
     e->rememberCursorPixX();
@@ -369,6 +372,7 @@ void SingleLineEditActions::cursorEndOfLine()
         TextData::TextMark mark = e->createNewMarkFromCursor();
         mark.moveToEndOfLine();
         e->moveCursorToTextMark(mark);
+        e->moveAdditionalCursors(TextEditorWidget::CURSOR_END_OF_LINE);
     }
     e->assureCursorVisible();
     e->rememberCursorPixX();
@@ -478,7 +482,13 @@ void SingleLineEditActions::backSpace()
     {
 
         e->hideCursor();
-        if (e->hasPrimarySelection())
+        if (e->hasAdditionalCursors())
+        {
+            e->releaseSelection();
+            e->setCurrentActionCategory(TextEditorWidget::ACTION_KEYBOARD_INPUT);
+            e->removeAtAllCursors(true);
+        }
+        else if (e->hasPrimarySelection())
         {
             {
                 TextData::HistorySection::Ptr historySectionHolder = e->getTextData()->createHistorySection();
@@ -574,7 +584,13 @@ void SingleLineEditActions::deleteKey()
     if (!e->areCursorChangesDisabled() && !e->isReadOnly())
     {
         e->hideCursor();
-        if (e->hasPrimarySelection()) 
+        if (e->hasAdditionalCursors())
+        {
+            e->releaseSelection();
+            e->setCurrentActionCategory(TextEditorWidget::ACTION_KEYBOARD_INPUT);
+            e->removeAtAllCursors(false);
+        }
+        else if (e->hasPrimarySelection())
         {
             {
                 TextData::HistorySection::Ptr historySectionHolder = e->getTextData()->createHistorySection();
@@ -0,0 +1,84 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "StartupTiming.hpp"
+#include "TimeStamp.hpp"
+#include "Nullable.hpp"
+#include "GuiRoot.hpp"
+
+using namespace LucED;
+
+namespace // anonymous namespace
+{
+
+bool                isEnabled  = false;
+Nullable<TimeStamp> startTime;
+Nullable<TimeStamp> lastTime;
+
+inline double getMilliSecs(const TimePeriod& p)
+{
+    return p.getSeconds() * 1000.0 + p.getMicroSeconds() / 1000.0;
+}
+
+} // anonymous namespace
+
+
+void StartupTiming::start()
+{
+    isEnabled = (::getenv("LUCED_STARTUP_TIMING") != NULL);
+    
+    if (isEnabled) {
+        startTime = TimeStamp::now();
+        lastTime  = startTime;
+    }
+}
+
+
+void StartupTiming::reportPhase(const char* phaseName)
+{
+    if (isEnabled)
+    {
+        TimeStamp now = TimeStamp::now();
+        
+        long numberOfRequests = 0;
+        if (GuiRoot::isInstanceValid()) {
+            numberOfRequests = NextRequest(GuiRoot::getInstance()->getDisplay()) - 1;
+        }
+        fprintf(stderr, "LucED startup: %8.1f ms (+%7.1f ms) %6ld X11 requests   %s\n",
+                        getMilliSecs(now - startTime.get()),
+                        getMilliSecs(now - lastTime.get()),
+                        numberOfRequests,
+                        phaseName);
+        lastTime = now;
+    }
+}
+
+
+void StartupTiming::finish(const char* phaseName)
+{
+    if (isEnabled) {
+        reportPhase(phaseName);
+        isEnabled = false;
+    }
+}
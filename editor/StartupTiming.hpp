@@ -0,0 +1,47 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef STARTUP_TIMING_HPP
+#define STARTUP_TIMING_HPP
+
+namespace LucED
+{
+
+/**
+ * Prints the elapsed time and the number of X11 requests of the
+ * startup phases to stderr, if the environment variable 
+ * LUCED_STARTUP_TIMING is set. The report ends with the first
+ * window that is shown.
+ */
+class StartupTiming
+{
+public:
+    static void start();
+    static void reportPhase(const char* phaseName);
+    static void finish(const char* phaseName);
+    
+private:
+    StartupTiming();
+};
+
+} // namespace LucED
+
+#endif // STARTUP_TIMING_HPP
@@ -0,0 +1,749 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SymbolIndex.hpp"
+#include "EventDispatcher.hpp"
+#include "TopWinList.hpp"
+#include "EditorTopWin.hpp"
+#include "GlobalConfig.hpp"
+#include "ByteBuffer.hpp"
+#include "FileException.hpp"
+#include "File.hpp"
+#include "Seconds.hpp"
+#include "util.hpp"
+
+using namespace LucED;
+
+namespace // anonymous namespace
+{
+
+const int  MAX_WORKERS                = 8;
+const long MAX_FILE_SIZE              = 16 * 1024 * 1024;
+const long UPDATE_MICRO_SECS          = 200 * 1000;
+const long REFRESH_INTERVAL_SECS      = 10;
+
+const char* const INDEX_FILE_HEADER   = "LucED symbols 1\n";
+
+const char* const PROJECT_MARKERS[]     = { ".git", ".svn", ".hg", ".bzr", ".luced-project", NULL };
+
+String getProjectRoot(const String& directory)
+{
+    String dir = directory;
+    
+    while (dir.getLength() > 1)
+    {
+        for (int i = 0; PROJECT_MARKERS[i] != NULL; ++i) {
+            if (File(dir, PROJECT_MARKERS[i]).exists()) {
+                return dir;
+            }
+        }
+        dir = File(dir).getDirName();
+    }
+    return directory;
+}
+
+ObjectArray<SymbolIndex::WeakPtr> indices;
+
+} // anonymous namespace
+
+
+SymbolIndex::TextTracker::TextTracker(RawPtr<TextData> textData, const String& fileName)
+    : textData(textData),
+      fileName(fileName),
+      completeFlag(true),
+      changedFlag(false),
+      changedBegin(0),
+      changedEnd(0),
+      extractedNumberOfLines(0),
+      anchorPos(0),
+      anchorLine(0),
+      anchorNumberOfLines(textData->getNumberOfLines())
+{
+    textData->registerUpdateListener(newCallback(this, &TextTracker::treatTextDataUpdate));
+}
+
+
+/**
+ * Extends the changed range by the update, positions behind 
+ * the update are moved by the changed amount.
+ */
+void SymbolIndex::TextTracker::treatTextDataUpdate(TextData::UpdateInfo update)
+{
+    long newEndChangedPos = update.oldEndChangedPos + update.changedAmount;
+    long lineDelta        = textData->getNumberOfLines() - anchorNumberOfLines;
+    
+    anchorNumberOfLines = textData->getNumberOfLines();
+    
+    if (anchorPos >= update.oldEndChangedPos && anchorPos > update.beginChangedPos) {
+        anchorPos  += update.changedAmount;
+        anchorLine += lineDelta;
+    }
+    else if (anchorPos > update.beginChangedPos) {
+        anchorPos  = 0;
+        anchorLine = 0;
+    }
+
+    if (!changedFlag) {
+        changedBegin = update.beginChangedPos;
+        changedEnd   = newEndChangedPos;
+        changedFlag  = true;
+    }
+    else {
+        if (changedEnd >= update.oldEndChangedPos) {
+            changedEnd += update.changedAmount;
+        }
+        changedBegin = util::minimum(changedBegin, update.beginChangedPos);
+        changedEnd   = util::maximum(changedEnd,   newEndChangedPos);
+    }
+}
+
+
+/**
+ * Counts the newlines between the anchor and pos, 
+ * pos becomes the new anchor.
+ */
+long SymbolIndex::TextTracker::getLineOfPos(long pos)
+{
+    long        beginPos = util::minimum(anchorPos, pos);
+    long        endPos   = util::maximum(anchorPos, pos);
+    const char* buffer   = (const char*) textData->getAmount(beginPos, endPos - beginPos);
+    long        lines    = 0;
+    
+    for (const char* p = buffer; (p = (const char*) memchr(p, '\n', endPos - beginPos - (p - buffer))) != NULL; ++p) {
+        ++lines;
+    }
+    anchorLine = (pos >= anchorPos) ? anchorLine + lines : anchorLine - lines;
+    anchorPos  = pos;
+    
+    return anchorLine;
+}
+
+
+SymbolIndex::WeakPtr SymbolIndex::getInstanceForFile(const String& fileName)
+{
+    String rootDirectory = getProjectRoot(File(File(fileName).getAbsoluteName()).getDirName());
+
+    for (int i = 0; i < indices.getLength();)
+    {
+        if (!indices[i].isValid()) {
+            indices.remove(i);
+        }
+        else {
+            if (indices[i]->rootDirectory == rootDirectory) {
+                return indices[i];
+            }
+            ++i;
+        }
+    }
+    OwningPtr rslt(new SymbolIndex(rootDirectory));
+    
+    indices.append(rslt);
+    EventDispatcher::getInstance()->registerRunningComponent(rslt);
+    
+    rslt->load();
+    rslt->refresh();
+    
+    return rslt;
+}
+
+
+SymbolIndex::SymbolIndex(const String& rootDirectory)
+    : DirectoryWalker(MAX_WORKERS, MicroSeconds(UPDATE_MICRO_SECS)),
+      rootDirectory(rootDirectory),
+      indexFileName(File(String() << GlobalConfig::getInstance()->getConfigDirectory() << "/.symbols",
+                         rootDirectory.toSubstitutedString('/', '%'))),
+      modifiedFlag(false)
+{}
+
+
+SymbolIndex::~SymbolIndex()
+{
+    stopWalk();
+}
+
+
+/**
+ * Copies the definition patterns of the language modes, so that
+ * the workers do not need to access the GlobalConfig. Like
+ * LanguageModeSelectors the first matching file name regex wins.
+ */
+void SymbolIndex::buildRules()
+{
+    RawPtr<GlobalConfig>       config    = GlobalConfig::getInstance();
+    LanguageModeSelectors::Ptr selectors = config->getLanguageModeSelectors();
+    LanguageModes::Ptr         modes     = config->getLanguageModes();
+    
+    rules.clear();
+
+    for (int i = 0; i < selectors->getLength(); ++i)
+    {
+        Nullable<BasicRegex> fileNameRegex = selectors->get(i)->getFileNameRegex();
+        
+        if (!fileNameRegex.isValid()) {
+            continue;
+        }
+        rules.append(Rule(fileNameRegex.get()));
+        
+        LanguageMode::Ptr languageMode = modes->getLanguageMode(selectors->get(i)->getLanguageMode());
+        
+        if (languageMode.isValid())
+        {
+            LanguageMode::DefinitionPatterns::Ptr patterns = languageMode->getDefinitionPatterns();
+            
+            for (int j = 0; j < patterns->getLength(); ++j) {
+                rules.getLast().definitions.append(DefinitionRule(patterns->get(j)->getKind(),
+                                                                  patterns->get(j)->getRegex()));
+            }
+        }
+    }
+}
+
+
+const SymbolIndex::Rule* SymbolIndex::findRule(const String& fileName, MemArray<int>& ovector) const
+{
+    for (int i = 0; i < rules.getLength(); ++i)
+    {
+        const BasicRegex& re = rules[i].fileNameRegex;
+        
+        ovector.increaseTo(re.getOvecSize());
+        
+        if (   re.findMatch(fileName.toCString(), fileName.getLength(), 0, BasicRegex::MatchOptions(), ovector)
+            && ovector[0] == 0 && ovector[1] == fileName.getLength())
+        {
+            return (rules[i].definitions.getLength() > 0) ? &rules[i] : NULL;
+        }
+    }
+    return NULL;
+}
+
+
+/**
+ * May be called concurrently: only reads the compiled regexes.
+ */
+void SymbolIndex::extractSymbols(const Rule& rule, const char* buffer, long length, 
+                                 MemArray<int>& ovector, ObjectArray<Symbol>& symbols,
+                                 long firstLineNumber)
+{
+    for (int i = 0; i < rule.definitions.getLength(); ++i)
+    {
+        const DefinitionRule& definition = rule.definitions[i];
+        const int             capture    = (definition.regex.getNumberOfCapturingSubpatterns() > 0) ? 1 : 0;
+        
+        ovector.increaseTo(definition.regex.getOvecSize());
+        
+        long lineNumber = firstLineNumber;
+        long countedPos = 0;
+        long pos        = 0;
+        
+        while (pos <= length && definition.regex.findMatch(buffer, length, pos, BasicRegex::MatchOptions(), ovector))
+        {
+            long nameBegin = ovector[2 * capture];
+            long nameEnd   = ovector[2 * capture + 1];
+            
+            if (nameBegin >= 0 && nameEnd > nameBegin && memchr(buffer + nameBegin, '\n', nameEnd - nameBegin) == NULL)
+            {
+                for (const char* p = buffer + countedPos; 
+                     (p = (const char*) memchr(p, '\n', nameBegin - (p - buffer))) != NULL; ++p)
+                {
+                    ++lineNumber;
+                }
+                countedPos = nameBegin;
+                
+                symbols.append(Symbol(String(buffer + nameBegin, nameEnd - nameBegin), 
+                                      definition.kind, lineNumber));
+            }
+            pos = (ovector[1] > ovector[0]) ? ovector[1] : ovector[0] + 1;
+        }
+    }
+}
+
+
+void SymbolIndex::setFileSymbols(const String& fileName, const FileStamp& stamp, 
+                                 const ObjectArray<Symbol>& symbols)
+{
+    removeFileSymbols(fileName);
+    
+    FileSymbols::Ptr fileSymbols = FileSymbols::create(fileName, stamp.modificationTime, stamp.fileSize);
+                     fileSymbols->symbols = symbols;
+    files.set(fileName, fileSymbols);
+    
+    for (int i = 0; i < symbols.getLength(); ++i)
+    {
+        ObjectArray< RawPtr<FileSymbols> >& definingFiles = names[symbols[i].name];
+        
+        if (definingFiles.getLength() == 0 || definingFiles.getLast() != fileSymbols) {
+            definingFiles.append(fileSymbols);
+        }
+    }
+    modifiedFlag = true;
+}
+
+
+void SymbolIndex::removeFileSymbols(const String& fileName)
+{
+    HashMap<String,FileSymbols::Ptr>::Value found = files.get(fileName);
+    
+    if (!found.isValid()) {
+        return;
+    }
+    FileSymbols::Ptr fileSymbols = found.get();
+    
+    for (int i = 0; i < fileSymbols->symbols.getLength(); ++i)
+    {
+        NameMap::iterator entry = names.find(fileSymbols->symbols[i].name);
+        
+        if (entry != names.end())
+        {
+            ObjectArray< RawPtr<FileSymbols> >& definingFiles = entry->second;
+            
+            for (int j = 0; j < definingFiles.getLength(); ++j) {
+                if (definingFiles[j] == fileSymbols) {
+                    definingFiles.remove(j);
+                    break;
+                }
+            }
+            if (definingFiles.getLength() == 0) {
+                names.erase(entry);
+            }
+        }
+    }
+    files.remove(fileName);
+    modifiedFlag = true;
+}
+
+
+/**
+ * Takes the symbols of open editor windows from the buffer contents. 
+ * They are extracted again only if the buffer has been changed.
+ */
+void SymbolIndex::updateOpenTextData()
+{
+    if (rules.getLength() == 0 && !isWalking()) {
+        buildRules();
+    }
+    for (int i = 0; i < trackers.getLength();)
+    {
+        if (!trackers[i]->textData.isValid()) {
+            trackers.remove(i);
+        } else {
+            ++i;
+        }
+    }
+    RawPtr<TopWinList> topWins = TopWinList::getInstance();
+    MemArray<int>      ovector;
+
+    for (int w = 0; w < topWins->getNumberOfTopWins(); ++w)
+    {
+        EditorTopWin* topWin = dynamic_cast<EditorTopWin*>(topWins->getTopWin(w));
+        
+        if (topWin == NULL) {
+            continue;
+        }
+        TextData::Ptr textData = topWin->getHilitedText()->getTextData();
+        
+        if (textData->isFileNamePseudo()) {
+            continue;
+        }
+        bool isTracked = false;
+        
+        for (int i = 0; i < trackers.getLength(); ++i) {
+            if (trackers[i]->textData == textData) {
+                isTracked = true;
+                break;
+            }
+        }
+        if (!isTracked)
+        {
+            String fileName = File(textData->getFileName()).getAbsoluteName();
+            
+            if (isInDirectory(fileName, rootDirectory) && findRule(fileName, ovector) != NULL)
+            {
+                trackers.append(TextTracker::create(textData, fileName));
+            }
+        }
+    }
+    for (int i = 0; i < trackers.getLength(); ++i)
+    {
+        TextTracker::Ptr tracker = trackers[i];
+        
+        if (tracker->completeFlag || tracker->changedFlag)
+        {
+            const Rule* rule = findRule(tracker->fileName, ovector);
+            
+            if (rule != NULL) {
+                updateTrackedSymbols(tracker, *rule, ovector);
+            }
+            tracker->completeFlag = false;
+            tracker->changedFlag  = false;
+        }
+    }
+}
+
+
+/**
+ * Extracts the symbols of the changed lines only: the symbols of 
+ * unchanged lines are kept, behind the changed lines their line
+ * numbers are moved by the number of inserted or removed lines.
+ */
+void SymbolIndex::updateTrackedSymbols(RawPtr<TextTracker> tracker, const Rule& rule, MemArray<int>& ovector)
+{
+    RawPtr<TextData> textData = tracker->textData;
+    long             length   = textData->getLength();
+    
+    HashMap<String,FileSymbols::Ptr>::Value found = files.get(tracker->fileName);
+    
+    ObjectArray<Symbol> symbols;
+    
+    if (tracker->completeFlag || !found.isValid() || found.get()->modificationTime >= 0)
+    {
+        const char* buffer = (const char*) textData->getAmount(0, length);
+        
+        extractSymbols(rule, buffer, length, ovector, symbols);
+    }
+    else
+    {
+        long beginPos = textData->getThisLineBegin (util::minimum(tracker->changedBegin, length));
+        long endPos   = textData->getThisLineEnding(util::minimum(tracker->changedEnd,   length));
+        
+        long beginLine = tracker->getLineOfPos(beginPos) + 1;
+        long endLine   = beginLine;
+        
+        const char* buffer = (const char*) textData->getAmount(beginPos, endPos - beginPos);
+        
+        for (const char* p = buffer; (p = (const char*) memchr(p, '\n', endPos - beginPos - (p - buffer))) != NULL; ++p) {
+            ++endLine;
+        }
+        long lineDelta  = textData->getNumberOfLines() - tracker->extractedNumberOfLines;
+        long oldEndLine = endLine - lineDelta;
+        
+        const ObjectArray<Symbol>& oldSymbols = found.get()->symbols;
+        
+        for (int i = 0; i < oldSymbols.getLength(); ++i)
+        {
+            if (oldSymbols[i].lineNumber < beginLine) {
+                symbols.append(oldSymbols[i]);
+            }
+            else if (oldSymbols[i].lineNumber > oldEndLine) {
+                symbols.append(oldSymbols[i]);
+                symbols.getLast().lineNumber += lineDelta;
+            }
+        }
+        extractSymbols(rule, buffer, endPos - beginPos, ovector, symbols, beginLine);
+    }
+    tracker->extractedNumberOfLines = textData->getNumberOfLines();
+    
+    // invalid stamp: file is parsed again when the window is closed
+    
+    setFileSymbols(tracker->fileName, FileStamp(-1, -1), symbols);
+}
+
+
+ObjectArray<SymbolIndex::Definition> SymbolIndex::findDefinitions(const String& name)
+{
+    updateOpenTextData();
+    
+    if (!isWalking() && lastRefreshTime.isValid()
+                      && TimeStamp::now() > lastRefreshTime.get() + Seconds(REFRESH_INTERVAL_SECS))
+    {
+        refresh();
+    }
+    ObjectArray<Definition> rslt;
+    NameMap::const_iterator entry = names.find(name);
+    
+    if (entry != names.end())
+    {
+        const ObjectArray< RawPtr<FileSymbols> >& definingFiles = entry->second;
+        
+        for (int i = 0; i < definingFiles.getLength(); ++i)
+        {
+            RawPtr<FileSymbols> fileSymbols = definingFiles[i];
+            
+            for (int j = 0; j < fileSymbols->symbols.getLength(); ++j)
+            {
+                const Symbol& symbol = fileSymbols->symbols[j];
+                
+                if (symbol.name == name) {
+                    rslt.append(Definition(fileSymbols->fileName, symbol.lineNumber, symbol.kind, symbol.name));
+                }
+            }
+        }
+    }
+    return rslt;
+}
+
+
+ObjectArray<String> SymbolIndex::findSymbolNames(const String& prefix, int maxResults)
+{
+    updateOpenTextData();
+    
+    ObjectArray<String> rslt;
+    
+    for (NameMap::const_iterator entry = names.lower_bound(prefix);
+         entry != names.end() && entry->first.startsWith(prefix) && rslt.getLength() < maxResults;
+         ++entry)
+    {
+        rslt.append(entry->first);
+    }
+    return rslt;
+}
+
+
+void SymbolIndex::refresh()
+{
+    if (isWalking()) {
+        return;
+    }
+    buildRules();
+    updateOpenTextData();
+    
+    knownStamps.clear();
+    openFileNames.clear();
+    seenFileNames.clear();
+    
+    for (HashMap<String,FileSymbols::Ptr>::Iterator i = files.getIterator(); !i.isAtEnd(); i.gotoNext()) {
+        knownStamps.set(i.getKey(), FileStamp(i.getValue()->modificationTime, i.getValue()->fileSize));
+    }
+    for (int i = 0; i < trackers.getLength(); ++i) {
+        openFileNames.set(trackers[i]->fileName, true);
+        seenFileNames.set(trackers[i]->fileName, true);
+    }
+    ObjectArray<String> directories;
+                        directories.append(rootDirectory);
+    startWalk(directories);
+}
+
+
+bool SymbolIndex::shouldProcessFile(const String& fileName, long fileSize)
+{
+    MemArray<int> ovector;
+    
+    return    fileSize <= MAX_FILE_SIZE
+           && !openFileNames.hasKey(fileName)
+           && findRule(fileName, ovector) != NULL;
+}
+
+
+void SymbolIndex::processFile(const String& fileName, long modificationTime, long fileSize)
+{
+    HashMap<String,FileStamp>::Value known = knownStamps.get(fileName);
+    
+    if (   known.isValid() 
+        && known.get().modificationTime == modificationTime
+        && known.get().fileSize         == fileSize)
+    {
+        Mutex::Lock lock(mutex);
+        unchangedFileNames.append(fileName);
+        return;
+    }
+    Result        result(fileName, FileStamp(modificationTime, fileSize));
+    MemArray<int> ovector;
+    const Rule*   rule = findRule(fileName, ovector);
+    MappedFile    mappedFile(fileName, MAX_FILE_SIZE);
+    
+    if (rule != NULL && mappedFile.isValid())
+    {
+        result.stamp = FileStamp(mappedFile.getModificationTime(), mappedFile.getLength());
+
+        if (!mappedFile.isBinary()) {
+            extractSymbols(*rule, mappedFile.getBuffer(), mappedFile.getLength(), ovector, result.symbols);
+        }
+    }
+    Mutex::Lock lock(mutex);
+    results.append(result);
+}
+
+
+void SymbolIndex::handleWalkProgress()
+{
+    ObjectArray<Result> newResults;
+    ObjectArray<String> newUnchangedFileNames;
+    {
+        Mutex::Lock lock(mutex);
+        newResults            = results;
+        newUnchangedFileNames = unchangedFileNames;
+        results.clear();
+        unchangedFileNames.clear();
+    }
+    for (int i = 0; i < newResults.getLength(); ++i)
+    {
+        const Result& result    = newResults[i];
+        bool          isTracked = false;
+        
+        // window opened while the update was running: buffer content wins
+
+        for (int j = 0; j < trackers.getLength(); ++j) {
+            if (trackers[j]->fileName == result.fileName) {
+                isTracked = true;
+                break;
+            }
+        }
+        if (!isTracked) {
+            setFileSymbols(result.fileName, result.stamp, result.symbols);
+        }
+        seenFileNames.set(result.fileName, true);
+    }
+    for (int i = 0; i < newUnchangedFileNames.getLength(); ++i) {
+        seenFileNames.set(newUnchangedFileNames[i], true);
+    }
+}
+
+
+void SymbolIndex::handleWalkFinished()
+{
+    bool wasCancelled = isWalkCancelled();
+
+    handleWalkProgress();
+    
+    if (!wasCancelled)
+    {
+        ObjectArray<String> vanishedFileNames;
+        
+        for (HashMap<String,FileSymbols::Ptr>::Iterator i = files.getIterator(); !i.isAtEnd(); i.gotoNext()) {
+            if (!seenFileNames.hasKey(i.getKey())) {
+                vanishedFileNames.append(i.getKey());
+            }
+        }
+        for (int i = 0; i < vanishedFileNames.getLength(); ++i) {
+            removeFileSymbols(vanishedFileNames[i]);
+        }
+    }
+    knownStamps.clear();
+    openFileNames.clear();
+    seenFileNames.clear();
+    
+    lastRefreshTime = TimeStamp::now();
+    
+    if (modifiedFlag) {
+        save();
+    }
+}
+
+
+/**
+ * Format: header line, root directory line, then for each file 
+ * "F <modificationTime> <fileSize> <fileName>" followed by its
+ * symbols as "S <lineNumber> <kind> <name>".
+ */
+void SymbolIndex::load()
+{
+    ByteBuffer buffer;
+    try
+    {
+        File(indexFileName).loadInto(&buffer);
+    }
+    catch (FileException& ex) {
+        return;
+    }
+    String header = String() << INDEX_FILE_HEADER << rootDirectory << "\n";
+    
+    if (   buffer.getLength() < header.getLength()
+        || memcmp(buffer.getPtr(0), header.toCString(), header.getLength()) != 0)
+    {
+        return;
+    }
+    const char* data   = (const char*) buffer.getPtr(0);
+    long        length = buffer.getLength();
+    long        pos    = header.getLength();
+    
+    String              fileName;
+    FileStamp           stamp;
+    ObjectArray<Symbol> symbols;
+    
+    while (pos < length)
+    {
+        const char* nl      = (const char*) memchr(data + pos, '\n', length - pos);
+        long        lineEnd = (nl != NULL) ? (nl - data) : length;
+        String      line(data + pos, lineEnd - pos);
+        
+        pos = lineEnd + 1;
+        
+        char* p;
+        
+        if (line.startsWith("F "))
+        {
+            if (fileName.getLength() > 0) {
+                setFileSymbols(fileName, stamp, symbols);
+            }
+            stamp.modificationTime = strtol(line.toCString() + 2, &p, 10);
+            stamp.fileSize         = strtol(p, &p, 10);
+            fileName               = String(p + 1);
+            symbols.clear();
+        }
+        else if (line.startsWith("S "))
+        {
+            long        lineNumber = strtol(line.toCString() + 2, &p, 10);
+            const char* kind       = p + 1;
+            const char* name       = strchr(kind, ' ');
+            
+            if (name != NULL) {
+                symbols.append(Symbol(String(name + 1), String(kind, name - kind), lineNumber));
+            }
+        }
+    }
+    if (fileName.getLength() > 0) {
+        setFileSymbols(fileName, stamp, symbols);
+    }
+    modifiedFlag = false;
+}
+
+
+void SymbolIndex::save()
+{
+    ByteBuffer buffer;
+               buffer.appendString(String() << INDEX_FILE_HEADER << rootDirectory << "\n");
+    
+    for (HashMap<String,FileSymbols::Ptr>::Iterator i = files.getIterator(); !i.isAtEnd(); i.gotoNext())
+    {
+        FileSymbols::Ptr fileSymbols = i.getValue();
+        
+        if (fileSymbols->modificationTime < 0) {
+            continue; // symbols from an open window
+        }
+        buffer.appendString(String() << "F " << fileSymbols->modificationTime 
+                                     << " "  << fileSymbols->fileSize 
+                                     << " "  << fileSymbols->fileName << "\n");
+
+        for (int j = 0; j < fileSymbols->symbols.getLength(); ++j)
+        {
+            const Symbol& symbol = fileSymbols->symbols[j];
+            buffer.appendString(String() << "S " << symbol.lineNumber
+                                         << " "  << symbol.kind
+                                         << " "  << symbol.name << "\n");
+        }
+    }
+    File tempFile(String() << indexFileName << ".tmp");
+    try
+    {
+        tempFile.getDir().createDirectory();
+        tempFile.storeData(&buffer);
+        
+        if (rename(tempFile.toString().toCString(), indexFileName.toCString()) == 0) {
+            modifiedFlag = false;
+        }
+    }
+    catch (FileException& ex) {
+        // config directory is not writable: index is kept in memory only
+    }
+}
@@ -0,0 +1,270 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SYMBOL_INDEX_HPP
+#define SYMBOL_INDEX_HPP
+
+#include <map>
+
+#include "config.h"
+
+#include "DirectoryWalker.hpp"
+#include "OwningPtr.hpp"
+#include "WeakPtr.hpp"
+#include "RawPtr.hpp"
+#include "ObjectArray.hpp"
+#include "MemArray.hpp"
+#include "HashMap.hpp"
+#include "String.hpp"
+#include "TimeStamp.hpp"
+#include "Nullable.hpp"
+#include "BasicRegex.hpp"
+#include "TextData.hpp"
+
+namespace LucED
+{
+
+/**
+ * Index of the symbol definitions of all files below a project root.
+ *
+ * The symbols are found by the "definitionPatterns" of the language 
+ * modes: capture 1 of each match is the symbol name. The index is kept
+ * in "<configDir>/.symbols" and is updated in the background by the
+ * workers of the DirectoryWalker: only files with changed size or 
+ * modification time are parsed again. The symbols of open editor windows 
+ * are taken from the buffer contents, they are updated lazily after the
+ * buffer has been changed: only the changed lines are parsed again.
+ */
+class SymbolIndex : public DirectoryWalker
+{
+public:
+    typedef LucED::OwningPtr<SymbolIndex> OwningPtr;
+    typedef LucED::WeakPtr  <SymbolIndex> WeakPtr;
+
+    class Definition
+    {
+    public:
+        Definition(const String& fileName, long lineNumber,
+                   const String& kind,     const String& name)
+            : fileName(fileName), lineNumber(lineNumber),
+              kind(kind),         name(name)
+        {}
+        String fileName;
+        long   lineNumber;
+        String kind;
+        String name;
+    };
+
+    /**
+     * Returns the index for the project containing the given file.
+     * The project root is the nearest directory with a version control
+     * directory or a file ".luced-project", otherwise the directory 
+     * of the file.
+     */
+    static WeakPtr getInstanceForFile(const String& fileName);
+    
+    ~SymbolIndex();
+    
+    /**
+     * Looks up the definitions from the current state of the index,
+     * starts an update if the last one is older than a few seconds.
+     */
+    ObjectArray<Definition> findDefinitions(const String& name);
+    
+    /**
+     * Returns the sorted names of the symbols starting with prefix.
+     */
+    ObjectArray<String> findSymbolNames(const String& prefix, int maxResults);
+    
+    void refresh();
+    
+    bool isUpdating() const {
+        return isWalking();
+    }
+    String getRootDirectory() const {
+        return rootDirectory;
+    }
+
+private:
+    class Symbol
+    {
+    public:
+        Symbol()
+        {}
+        Symbol(const String& name, const String& kind, long lineNumber)
+            : name(name), kind(kind), lineNumber(lineNumber)
+        {}
+        String name;
+        String kind;
+        long   lineNumber;
+    };
+    
+    class FileSymbols : public HeapObject
+    {
+    public:
+        typedef LucED::OwningPtr<FileSymbols> Ptr;
+        
+        static Ptr create(const String& fileName, long modificationTime, long fileSize) {
+            return Ptr(new FileSymbols(fileName, modificationTime, fileSize));
+        }
+        String              fileName;
+        long                modificationTime;
+        long                fileSize;
+        ObjectArray<Symbol> symbols;
+    private:
+        FileSymbols(const String& fileName, long modificationTime, long fileSize)
+            : fileName(fileName), modificationTime(modificationTime), fileSize(fileSize)
+        {}
+    };
+    
+    class FileStamp
+    {
+    public:
+        FileStamp()
+        {}
+        FileStamp(long modificationTime, long fileSize)
+            : modificationTime(modificationTime), fileSize(fileSize)
+        {}
+        long modificationTime;
+        long fileSize;
+    };
+    
+    class DefinitionRule
+    {
+    public:
+        DefinitionRule()
+        {}
+        DefinitionRule(const String& kind, const BasicRegex& regex)
+            : kind(kind), regex(regex)
+        {}
+        String     kind;
+        BasicRegex regex;
+    };
+    
+    class Rule
+    {
+    public:
+        Rule()
+        {}
+        explicit Rule(const BasicRegex& fileNameRegex)
+            : fileNameRegex(fileNameRegex)
+        {}
+        BasicRegex                  fileNameRegex;
+        ObjectArray<DefinitionRule> definitions;
+    };
+    
+    class Result
+    {
+    public:
+        Result()
+        {}
+        Result(const String& fileName, const FileStamp& stamp)
+            : fileName(fileName), stamp(stamp)
+        {}
+        String              fileName;
+        FileStamp           stamp;
+        ObjectArray<Symbol> symbols;
+    };
+    
+    class TextTracker : public HeapObject
+    {
+    public:
+        typedef LucED::OwningPtr<TextTracker> Ptr;
+        
+        static Ptr create(RawPtr<TextData> textData, const String& fileName) {
+            return Ptr(new TextTracker(textData, fileName));
+        }
+        long getLineOfPos(long pos);
+        
+        LucED::WeakPtr<TextData> textData;
+        String                   fileName;
+        
+        /** the symbols must be extracted from the whole buffer */
+        bool                     completeFlag;
+        
+        /** the changed range in the current buffer */
+        bool                     changedFlag;
+        long                     changedBegin;
+        long                     changedEnd;
+        
+        /** number of lines when the symbols were extracted */
+        long                     extractedNumberOfLines;
+        
+        /** position with known line number, moved along with the updates */
+        long                     anchorPos;
+        long                     anchorLine;
+        long                     anchorNumberOfLines;
+        
+    private:
+        TextTracker(RawPtr<TextData> textData, const String& fileName);
+
+        void treatTextDataUpdate(TextData::UpdateInfo update);
+    };
+    
+    typedef std::map< String, ObjectArray< RawPtr<FileSymbols> > > NameMap;
+    
+    explicit SymbolIndex(const String& rootDirectory);
+    
+    void buildRules();
+    const Rule* findRule(const String& fileName, MemArray<int>& ovector) const;
+    static void extractSymbols(const Rule& rule, const char* buffer, long length, 
+                               MemArray<int>& ovector, ObjectArray<Symbol>& symbols,
+                               long firstLineNumber = 1);
+    
+    void setFileSymbols(const String& fileName, const FileStamp& stamp, 
+                        const ObjectArray<Symbol>& symbols);
+    void removeFileSymbols(const String& fileName);
+    void updateOpenTextData();
+    void updateTrackedSymbols(RawPtr<TextTracker> tracker, const Rule& rule, MemArray<int>& ovector);
+    
+    void load();
+    void save();
+
+    virtual bool shouldProcessFile(const String& fileName, long fileSize);
+    virtual void processFile(const String& fileName, long modificationTime, long fileSize);
+    virtual void handleWalkProgress();
+    virtual void handleWalkFinished();
+
+    String                           rootDirectory;
+    String                           indexFileName;
+    
+    HashMap<String,FileSymbols::Ptr> files;
+    NameMap                          names;
+    ObjectArray<TextTracker::Ptr>    trackers;
+    HashMap<String,bool>             seenFileNames;
+    bool                             modifiedFlag;
+    Nullable<TimeStamp>              lastRefreshTime;
+    
+    // following members are read only while an update is running
+    
+    ObjectArray<Rule>                rules;
+    HashMap<String,FileStamp>        knownStamps;
+    HashMap<String,bool>             openFileNames;
+    
+    // following members are protected by mutex
+    
+    ObjectArray<Result>              results;
+    ObjectArray<String>              unchangedFileNames;
+};
+
+} // namespace LucED
+
+#endif // SYMBOL_INDEX_HPP
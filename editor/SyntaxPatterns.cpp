@@ -461,6 +461,9 @@ void SyntaxPatterns::compile(int i)
     if (!first) {
         sp->re = BasicRegex(patStr, BasicRegex::CreateOptions() | BasicRegex::MULTILINE 
                                                                 | BasicRegex::EXTENDED);
+        // the combined alternatives mostly start with few different bytes,
+        // so that plain text between them can be skipped by pcre_exec
+        sp->re.study();
         util::maximize(&maxOvecSize, sp->re.getOvecSize());
 
         for (int ci = 0; ci < sp->childList.getLength(); ++ci)
@@ -149,6 +149,10 @@ public:
     bool hasPatterns() const {
         return allPatterns.getLength() > 0;
     }
+    
+    int getNumberOfPatterns() const {
+        return allPatterns.getLength();
+    }
 
     void updateTextStyles(TextStyleDefinitions::ConstPtr newTextStyleDefinitions);
     
@@ -77,8 +77,11 @@ SyntaxPatterns::Ptr SyntaxPatternsConfig::getSyntaxPatterns(const String&
 }
 
 
-void SyntaxPatternsConfig::refresh(TextStyleDefinitions::Ptr newTextStyleDefinitions)
+void SyntaxPatternsConfig::refresh(TextStyleDefinitions::Ptr             newTextStyleDefinitions,
+                                   const Nullable< ObjectArray<String> >& changedPackageNames)
 {
+    ObjectArray<String> unusedSyntaxNames;
+
     HashMap<String,Entry::Ptr>::Iterator patternIterator = patterns.getIterator();
 
     while (!patternIterator.isAtEnd())
@@ -86,17 +89,70 @@ void SyntaxPatternsConfig::refresh(TextStyleDefinitions::Ptr newTextStyleDefinit
         String     syntaxName = patternIterator.getKey();
         Entry::Ptr entry      = patternIterator.getValue();
 
-        SyntaxPatterns::Ptr oldPatterns = entry->getSyntaxPatterns();
-        SyntaxPatterns::Ptr newPatterns = loadSyntaxPatterns(syntaxName, newTextStyleDefinitions);
-
-        if (!oldPatterns->hasSamePatternStructureThan(newPatterns))
+        if (!entry->isInUse())
         {
-            entry->refreshWithNewSyntaxPatterns(newPatterns);
+            // is loaded again by getSyntaxPatterns when it is needed
+            unusedSyntaxNames.append(syntaxName);
         }
-        else {
-            oldPatterns->updateTextStyles(newTextStyleDefinitions);
+        else if (   changedPackageNames.isValid()
+                 && !isInPackages(syntaxName, changedPackageNames.get()))
+        {
+            entry->getSyntaxPatterns()->updateTextStyles(newTextStyleDefinitions);
+        }
+        else
+        {
+            SyntaxPatterns::Ptr oldPatterns = entry->getSyntaxPatterns();
+            SyntaxPatterns::Ptr newPatterns = loadSyntaxPatterns(syntaxName, newTextStyleDefinitions);
+    
+            if (!oldPatterns->hasSamePatternStructureThan(newPatterns))
+            {
+                entry->refreshWithNewSyntaxPatterns(newPatterns);
+            }
+            else {
+                oldPatterns->updateTextStyles(newTextStyleDefinitions);
+            }
         }
         patternIterator.gotoNext();
     }
+    for (int i = 0; i < unusedSyntaxNames.getLength(); ++i) {
+        patterns.remove(unusedSyntaxNames[i]);
+    }
     textStyleDefinitions = newTextStyleDefinitions;
 }
+
+
+bool SyntaxPatternsConfig::isInPackages(const String& syntaxName, const ObjectArray<String>& packageNames)
+{
+    for (int i = 0; i < packageNames.getLength(); ++i) {
+        if (isInPackage(syntaxName, packageNames[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool SyntaxPatternsConfig::isInPackage(const String& syntaxName, const String& packageName)
+{
+    if (syntaxName.getLength() == 0) {
+        return false;
+    }
+    String qualifier = QualifiedName(syntaxName).getQualifier();
+    
+    return qualifier == packageName || qualifier.startsWith(String() << packageName << ".");
+}
+
+
+bool SyntaxPatternsConfig::dependsOnPackage(const String& packageName) const
+{
+    HashMap<String,Entry::Ptr>::Iterator patternIterator = patterns.getIterator();
+
+    while (!patternIterator.isAtEnd())
+    {
+        if (isInPackage(patternIterator.getKey(), packageName)) {
+            return true;
+        }
+        patternIterator.gotoNext();
+    }
+    return false;
+}
@@ -31,6 +31,7 @@
 #include "CallbackContainer.hpp"
 #include "TextStyleDefinition.hpp"
 #include "TextStyleDefinitions.hpp"
+#include "Nullable.hpp"
 
 namespace LucED
 {
@@ -53,12 +54,23 @@ public:
         return getSyntaxPatterns("", changedCallback);
     }
 
-    void refresh(TextStyleDefinitions::Ptr newTextStyleDefinitions);
+    /**
+     * Loads again the syntax patterns in use. If changedPackageNames is 
+     * given, only the syntax patterns of these packages are loaded again, 
+     * the others only get the new text styles.
+     */
+    void refresh(TextStyleDefinitions::Ptr             newTextStyleDefinitions,
+                 const Nullable< ObjectArray<String> >& changedPackageNames = Null);
+    
+    bool dependsOnPackage(const String& packageName) const;
     
 private:
     SyntaxPatternsConfig()
     {}
 
+    static bool isInPackage (const String& syntaxName, const String&              packageName);
+    static bool isInPackages(const String& syntaxName, const ObjectArray<String>& packageNames);
+
     static SyntaxPatterns::Ptr loadSyntaxPatterns(const String&             syntaxName,
                                                   TextStyleDefinitions::Ptr textStyleDefinitions);
 
@@ -77,6 +89,9 @@ private:
         SyntaxPatterns::Ptr getSyntaxPatterns() const {
             return syntaxPatterns;
         }
+        bool isInUse() {
+            return changedCallbacks.hasEnabledCallbacks();
+        }
         void refreshWithNewSyntaxPatterns(SyntaxPatterns::Ptr syntaxPatterns) {
             this->syntaxPatterns = syntaxPatterns;
             changedCallbacks.invokeAllCallbacks(syntaxPatterns);
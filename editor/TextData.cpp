@@ -20,6 +20,7 @@
 /////////////////////////////////////////////////////////////////////////////////////
 
 #include <limits.h>
+#include <algorithm>
 
 #include "util.hpp"
 #include "TextData.hpp"
@@ -28,6 +29,7 @@
 #include "EncodingConverter.hpp"
 #include "EncodingException.hpp"
 #include "System.hpp"
+#include "MemoryCompactor.hpp"
 
 using namespace std;
 using namespace LucED;
@@ -38,6 +40,7 @@ TextData::TextData()
           modifiedFlag(false),
           viewCounter(0),
           hasHistoryFlag(false),
+          journalEnabledFlag(false),
           isReadOnlyFlag(false),
           modifiedOnDiskFlag(false),
           ignoreModifiedOnDiskFlag(false),
@@ -86,10 +89,17 @@ void TextData::takeOverUtf8Buffer(RawPtr<ByteBuffer> newBufferPtr)
     if (hasHistory() && oldLen > 0) {
         history->rememberDeleteAction(0, oldLen, buffer.getTotalAmount());
     }
+    if (oldLen > 0) {
+        rememberJournalRemove(0, oldLen);
+    }
 
     internalTakeOverBuffer(newBufferPtr);
     
     long newLen = buffer.getLength();
+
+    if (newLen > 0) {
+        rememberJournalInsert(0, buffer.getTotalAmount(), newLen);
+    }
     
     if (hasHistory()) {
         history->rememberInsertAction(0, newLen);
@@ -122,6 +132,7 @@ void TextData::takeOverFileBuffer(const String& filename,
     {
         c.convertInPlace(bufferPtr);
     }
+    discardJournal();
     internalTakeOverBuffer(bufferPtr);
 
     File file(filename);
@@ -190,6 +201,8 @@ void TextData::reloadFile()
         }
     }
     
+    discardJournal();
+
     buffer.clear();
     file.loadInto(&buffer);
 
@@ -287,6 +300,8 @@ void TextData::setPseudoFileName(const String& filename)
 
 void TextData::setToSavedState()
 {
+    discardJournal();
+
     if (hasHistory()) {
         setHistorySeparator();
         history->setPreviousActionToSavedState();
@@ -353,10 +368,13 @@ TextData::TextMark TextData::createNewMark() {
 
 TextData::TextMark TextData::createNewMark(MarkHandle src)
 {
-    TextMarkData& srcMark = marks[src.index];
-    ASSERT(srcMark.inUseCounter > 0);
+    ASSERT(marks[src.index].inUseCounter > 0);
 
     TextMark rslt = createNewMark();
+    
+    // marks may have been reallocated by createNewMark()
+    
+    TextMarkData& srcMark  = marks[src.index];
     TextMarkData& rsltMark = marks[rslt.index];
     rsltMark.pos         = srcMark.pos;
     rsltMark.line        = srcMark.line;
@@ -450,6 +468,8 @@ inline long TextData::internalInsertAtMark(MarkHandle m, const byte* insertBuffe
             long lineNumber = mark.line;
             long pos = mark.pos;
     
+            rememberJournalInsert(pos, insertBuffer, length);
+
             buffer.insert(pos, insertBuffer, length);
 
             this->numberLines += lineCounter;
@@ -698,6 +718,8 @@ inline void TextData::internalRemoveAtMark(MarkHandle m, long amount)
             }
         }
     
+        rememberJournalRemove(mark.pos, amount);
+        
         buffer.removeAmount(mark.pos, amount);
 
         // Affected positions for wchar handling
@@ -711,6 +733,10 @@ inline void TextData::internalRemoveAtMark(MarkHandle m, long amount)
         recalculateChangeMarker(b2, o2, a2);
 
         updateMarks(b2, o2, a2, lineNumber, -lineCounter);
+        
+        if (buffer.needsCompaction()) {
+            MemoryCompactor::getInstance()->requestCompaction();
+        }
     }
 }
 
@@ -743,6 +769,231 @@ void TextData::removeAtMark(MarkHandle m, long amount)
     }
 }
 
+void TextData::EditList::append(long pos, long removeAmount, const byte* insertBuffer, long insertLength)
+{
+    Edit& e = edits.appendAmount(1)[0];
+    
+    e.pos          = pos;
+    e.removeAmount = removeAmount;
+    e.insertIndex  = insertData.getLength();
+    e.insertLength = insertLength;
+    e.number       = edits.getLength() - 1;
+    
+    insertData.append(insertBuffer, insertLength);
+    
+    if (edits.getLength() > 1 && !isBefore(edits[edits.getLength() - 2], e)) {
+        sortedFlag = false;
+    }
+}
+
+bool TextData::EditList::sortByPosition()
+{
+    if (!sortedFlag) {
+        std::sort(edits.getPtr(0), edits.getPtr(0) + edits.getLength(), &isBefore);
+        sortedFlag = true;
+    }
+    for (long i = 1; i < edits.getLength(); ++i)
+    {
+        const Edit& e    = edits[i];
+        const Edit& prev = edits[i - 1];
+        
+        // an insert at the begin of removed text is allowed, it replaces the removed text
+        
+        bool isReplacingInsert = (e.removeAmount == 0 && e.pos == prev.pos);
+        
+        if (e.pos < prev.pos + prev.removeAmount && !isReplacingInsert) {
+            return false;
+        }
+    }
+    return true;
+}
+
+long TextData::applyEdits(const EditList& editList)
+{
+    ASSERT(editList.sortedFlag);
+    
+    if (isReadOnlyFlag || editList.isEmpty()) {
+        return 0;
+    }
+    setHistorySeparator();
+    
+    TextMark m             = createNewMark();
+    long     delta         = 0;
+    long     lineDelta     = 0;
+    bool     wasRemove     = false;
+    long     lastNewEndPos = 0;
+    
+    MemArray<AppliedEdit> appliedEdits;
+    
+    // the marks are not updated while applying, only the 
+    // helper mark m, which is always before the changes
+    
+    for (long i = 0; i < editList.edits.getLength(); ++i)
+    {
+        const EditList::Edit& e = editList.edits[i];
+        
+        // an insert at the begin of the previously removed text 
+        // is joined with the previous edit and follows its insert
+        
+        bool isJoined = (appliedEdits.getLength() > 0 && e.pos < appliedEdits.getLast().oldEndPos);
+        long pos;
+        
+        if (isJoined) {
+            pos = lastNewEndPos;
+            m.moveToPos(pos);
+        }
+        else {
+            pos = util::minimum(e.pos + delta, getLength());
+            m.moveToPos(pos);
+            
+            AppliedEdit& a = appliedEdits.appendAmount(1)[0];
+            
+            a.oldBeginPos  = pos - delta;
+            a.oldEndPos    = a.oldBeginPos;
+            a.newBeginPos  = pos;
+            a.newBeginLine = m.getLine();
+        }
+        AppliedEdit& a = appliedEdits.getLast();
+
+        long removeAmount = util::minimum(e.removeAmount, getLength() - pos);
+        
+        if (removeAmount > 0)
+        {
+            if (hasHistory()) {
+                history->rememberDeleteAction(pos, removeAmount, buffer.getAmount(pos, removeAmount));
+            }
+            long lineCounter = 0;
+            for (long j = 0; j < removeAmount; ++j) {
+                if (buffer[pos + j] == '\n') {
+                    ++lineCounter;
+                }
+            }
+            rememberJournalRemove(pos, removeAmount);
+            
+            buffer.removeAmount(pos, removeAmount);
+            
+            long b2 = getBeginOfWChar(pos);
+            long n2 = getEndOfWChar(pos); 
+            long o2 = n2 + removeAmount;
+            
+            recalculateChangeMarker(b2, o2, -removeAmount);
+            
+            numberLines -= lineCounter;
+            lineDelta   -= lineCounter;
+            delta       -= removeAmount;
+            wasRemove    = true;
+        }
+        a.oldEndPos += removeAmount;
+
+        const byte* insertBuffer = editList.insertData.getPtr(e.insertIndex);
+        long        insertLength = e.insertLength;
+        
+        if (insertLength > 0 && filterCallback.isValid()) {
+            filterCallback->call(&insertBuffer, &insertLength);
+        }
+        if (insertLength > 0)
+        {
+            if (hasHistory()) {
+                history->rememberInsertAction(pos, insertLength);
+            }
+            long lineCounter = 0;
+            for (long j = 0; j < insertLength; ++j) {
+                if (insertBuffer[j] == '\n') {
+                    ++lineCounter;
+                }
+            }
+            rememberJournalInsert(pos, insertBuffer, insertLength);
+
+            buffer.insert(pos, insertBuffer, insertLength);
+            
+            long b2 = getBeginOfWChar(pos);
+            long n2 = getEndOfWChar(pos + insertLength); 
+            long o2 = n2 - insertLength;
+            
+            recalculateChangeMarker(b2, o2, insertLength);
+
+            numberLines += lineCounter;
+            lineDelta   += lineCounter;
+            delta       += insertLength;
+        }
+        a.deltaAfter     = delta;
+        a.lineDeltaAfter = lineDelta;
+        lastNewEndPos    = pos + insertLength;
+    }
+    updateMarksForAppliedEdits(appliedEdits, m);
+    
+    if (wasRemove && buffer.needsCompaction()) {
+        MemoryCompactor::getInstance()->requestCompaction();
+    }
+    setModifiedFlag(true);
+    setHistorySeparator();
+    
+    return delta;
+}
+
+void TextData::updateMarksForAppliedEdits(const MemArray<AppliedEdit>& appliedEdits, MarkHandle ignoredMark)
+{
+    const long numberOfEdits = appliedEdits.getLength();
+    
+    if (numberOfEdits == 0) {
+        return;
+    }
+    const long firstBeginPos = appliedEdits[0].oldBeginPos;
+    
+    for (long i = 0; i < marks.getLength(); ++i)
+    {
+        TextMarkData& mark = marks[i];
+
+        if (mark.inUseCounter <= 0 || i == ignoredMark.index || mark.pos <= firstBeginPos) {
+            continue;
+        }
+        // binary search for the last edit beginning before the mark
+        
+        long low  = 0;
+        long high = numberOfEdits;
+        
+        while (high - low > 1) {
+            long middle = (low + high) / 2;
+            if (appliedEdits[middle].oldBeginPos < mark.pos) {
+                low = middle;
+            } else {
+                high = middle;
+            }
+        }
+        const AppliedEdit& a = appliedEdits[low];
+        
+        if (mark.pos <= a.oldEndPos)
+        {
+            // mark was within or at the end of removed text
+            
+            mark.pos        = a.newBeginPos;
+            mark.line       = a.newBeginLine;
+            mark.byteColumn = mark.pos - getThisLineBegin(mark.pos);
+            mark.wcharColumn = -1;
+        }
+        else
+        {
+            bool isInChangedLine = (a.oldEndPos >= mark.pos - mark.byteColumn);
+
+            mark.pos  += a.deltaAfter;
+            mark.line += a.lineDeltaAfter;
+
+            if (isInChangedLine) {
+                mark.byteColumn  = mark.pos - getThisLineBegin(mark.pos);
+                mark.wcharColumn = -1;
+            }
+        }
+        long wcharBegin = getBeginOfWChar(mark.pos);
+        
+        if (mark.pos != wcharBegin) {
+            mark.byteColumn -= (mark.pos - wcharBegin);
+            mark.pos         = wcharBegin;
+            mark.wcharColumn = -1;
+        }
+        ASSERT(mark.pos <= getLength());
+    }
+}
+
 void TextData::clear()
 {
     TextMark m = createNewMark();
@@ -754,13 +1005,35 @@ void TextData::clearHistory()
 {
     if (hasHistory()) {
         history->clear();
+        if (history->needsCompaction()) {
+            MemoryCompactor::getInstance()->requestCompaction();
+        }
+    }
+}
+
+
+bool TextData::needsMemoryCompaction() const
+{
+    return buffer.needsCompaction() || (history.isValid() && history->needsCompaction());
+}
+
+
+long TextData::compactMemory(bool releaseAll)
+{
+    long rslt = buffer.compact(releaseAll);
+    
+    if (history.isValid()) {
+        rslt += history->compact(releaseAll);
     }
+    return rslt;
 }
 
 void TextData::reset()
 {
     int oldLength = getLength();
     if (oldLength > 0) {
+        rememberJournalRemove(0, oldLength);
+
         int oldNumberLines = numberLines;
         this->buffer.clear();
         this->numberLines = 1;
@@ -773,11 +1046,93 @@ void TextData::reset()
     if (hasHistory()) {
         history->clear();
     }
+    if (needsMemoryCompaction()) {
+        MemoryCompactor::getInstance()->requestCompaction();
+    }
 
     setModifiedFlag(true);
 }
 
 
+inline void TextData::rememberJournalInsert(long pos, const byte* data, long length)
+{
+    if (journal.isInvalid() && journalEnabledFlag && !modifiedFlag && hasHistory() 
+                            && !fileNamePseudoFlag && EditJournal::isEnabled())
+    {
+        // first change after loading or saving
+        journal = EditJournal::create(fileName, fileInfo, buffer.getLength());
+    }
+    if (journal.isValid()) {
+        journal->rememberInsert(pos, data, length);
+    }
+}
+
+
+inline void TextData::rememberJournalRemove(long pos, long length)
+{
+    if (journal.isInvalid() && journalEnabledFlag && !modifiedFlag && hasHistory() 
+                            && !fileNamePseudoFlag && EditJournal::isEnabled())
+    {
+        journal = EditJournal::create(fileName, fileInfo, buffer.getLength());
+    }
+    if (journal.isValid()) {
+        journal->rememberRemove(pos, length);
+    }
+}
+
+
+long TextData::recoverFromJournal()
+{
+    if (journal.isValid() || !journalEnabledFlag || modifiedFlag || isReadOnlyFlag || !hasHistory() 
+                          || fileNamePseudoFlag || !EditJournal::isEnabled())
+    {
+        return 0;
+    }
+    EditJournal::Ptr recoveredJournal = EditJournal::createForRecovery(fileName, fileInfo, buffer.getLength());
+    
+    if (recoveredJournal.isInvalid()) {
+        return 0;
+    }
+    journal = recoveredJournal;  // ignores the replayed changes
+
+    long               rslt = 0;
+    TextMark           m    = createNewMark();
+    EditJournal::Record record;
+
+    while (journal->getNextRecoveredRecord(&record))
+    {
+        m.moveToPos(record.pos);
+
+        if (record.type == EditJournal::INSERT_RECORD) {
+            history->rememberInsertAction(record.pos, record.length);
+            internalInsertAtMark(m, record.data, record.length);
+        } else {
+            history->rememberDeleteAction(record.pos, record.length, buffer.getAmount(record.pos, record.length));
+            internalRemoveAtMark(m, record.length);
+        }
+        ++rslt;
+    }
+    journal->finishRecovery();
+    
+    if (rslt > 0) {
+        setHistorySeparator();
+        setModifiedFlag(true);
+    } else {
+        discardJournal();
+    }
+    return rslt;
+}
+
+
+void TextData::discardJournal()
+{
+    if (journal.isValid()) {
+        journal->discard();
+        journal.invalidate();
+    }
+}
+
+
 void TextData::moveMarkToBeginOfLine(MarkHandle m, long newLine)
 {
     if (newLine >= numberLines) {
@@ -30,6 +30,7 @@
 #include "CallbackContainer.hpp"
 #include "OwningPtr.hpp"
 #include "EditingHistory.hpp"
+#include "EditJournal.hpp"
 #include "TimeStamp.hpp"
 #include "File.hpp"
 #include "RawPtr.hpp"
@@ -57,6 +58,57 @@ public:
         {}
     };
 
+    /**
+     * Collects edits whose positions all refer to the unmodified text, 
+     * so that they can be applied in one pass by TextData::applyEdits().
+     */
+    class EditList
+    {
+    public:
+        EditList()
+            : sortedFlag(true)
+        {}
+        void append(long pos, long removeAmount, const byte* insertBuffer, long insertLength);
+        
+        void append(long pos, long removeAmount, const String& insertString) {
+            append(pos, removeAmount, (const byte*) insertString.toCString(), insertString.getLength());
+        }
+        bool isEmpty() const {
+            return edits.getLength() == 0;
+        }
+        long getLength() const {
+            return edits.getLength();
+        }
+        void clear() {
+            edits.clear();
+            insertData.clear();
+            sortedFlag = true;
+        }
+        /**
+         * Sorts the edits by position, edits at the same position 
+         * keep their order. Returns false if edits are overlapping.
+         */
+        bool sortByPosition();
+        
+    private:
+        friend class TextData;
+        
+        struct Edit
+        {
+            long pos;
+            long removeAmount;
+            long insertIndex;
+            long insertLength;
+            long number;
+        };
+        static bool isBefore(const Edit& e1, const Edit& e2) {
+            return e1.pos < e2.pos || (e1.pos == e2.pos && e1.number < e2.number);
+        }
+        MemArray<Edit> edits;
+        MemArray<byte> insertData;
+        bool           sortedFlag;
+    };
+
     class MarkHandle
     {
     protected:
@@ -183,6 +235,9 @@ public:
     void setEncoding(const String& encodingName) {
         this->fileContentEncoding = encodingName;
     }
+    String getEncoding() const {
+        return fileContentEncoding;
+    }
 
     void takeOverFileBuffer(const String& filename, 
                             const String& encoding,
@@ -200,10 +255,52 @@ public:
     void setRealFileName(const String& filename);
     void setPseudoFileName(const String& filename);
     void save();
+    
+    /**
+     * Lets the changes of this buffer be journaled, if it has a real
+     * file name. Called for the buffers of files opened for editing,
+     * not e.g. for the buffers of input fields.
+     */
+    void enableJournal() {
+        journalEnabledFlag = true;
+    }
+    
+    /**
+     * Replays the edit journal left by a previous editor process onto
+     * the freshly loaded file. Returns the number of recovered changes.
+     */
+    long recoverFromJournal();
+    
+    /**
+     * Removes the edit journal, because the user has given up the
+     * unsaved changes.
+     */
+    void discardJournal();
 
     long getLength() const {
         return buffer.getLength();
     }
+    
+    long getAllocatedBufferBytes() const {
+        return buffer.getCapacityInBytes();
+    }
+    long getNumberOfMarks() const {
+        return marks.getLength();
+    }
+    long getAllocatedMarkBytes() const {
+        return marks.getCapacityInBytes();
+    }
+    RawPtr<const EditingHistory> getEditingHistory() const {
+        return history;
+    }
+    
+    bool needsMemoryCompaction() const;
+    
+    /**
+     * Shrinks text buffer and history after big removals, returns 
+     * the number of released bytes.
+     */
+    long compactMemory(bool releaseAll = false);
 
     long getNumberOfLines() const {
         return numberLines;
@@ -218,6 +315,12 @@ public:
     byte* getAmount(long pos, long amount) {
         return buffer.getAmount(pos, amount);
     }
+    long getContiguousLength(long pos) const {
+        return buffer.getContiguousLength(pos);
+    }
+    const byte* getContiguousPtr(long pos) const {
+        return buffer.getContiguousPtr(pos);
+    }
     String getSubstring(Pos pos, Len amount) {
         return String((const char*) getAmount(pos, amount), amount);
     }
@@ -380,6 +483,15 @@ public:
     long redo(MarkHandle m);
 
     void removeAtMark(MarkHandle m, long amount);
+
+    /**
+     * Applies the sorted edits from left to right, i.e. the gap is
+     * only moved forward through the text, and makes them one
+     * history section. Marks are updated once after all edits
+     * instead of after each edit. Returns the change of the text length.
+     */
+    long applyEdits(const EditList& editList);
+
     void clear();
     void reset();
     
@@ -611,6 +723,9 @@ private:
     void internalTakeOverBuffer(RawPtr<ByteBuffer> bufferPtr);
     void setToSavedState();
     
+    void rememberJournalInsert(long pos, const byte* data, long length);
+    void rememberJournalRemove(long pos, long length);
+    
     ByteBuffer             buffer;
     Utf8Parser<ByteBuffer> utf8Parser;
     
@@ -623,6 +738,17 @@ private:
     void updateMarks(
         long beginChangedPos, long oldEndChangedPos, long changedAmount,
         long beginLineNumber, long changedLineNumberAmount);
+    
+    struct AppliedEdit
+    {
+        long oldBeginPos;
+        long oldEndPos;
+        long newBeginPos;
+        long newBeginLine;
+        long deltaAfter;
+        long lineDeltaAfter;
+    };
+    void updateMarksForAppliedEdits(const MemArray<AppliedEdit>& appliedEdits, MarkHandle ignoredMark);
         
     CallbackContainer<UpdateInfo> updateListeners;
     CallbackContainer<const String&> fileNameListeners;
@@ -639,6 +765,8 @@ private:
     int viewCounter;
     bool hasHistoryFlag;
     EditingHistory::Ptr history;
+    EditJournal::Ptr journal;
+    bool journalEnabledFlag;
     bool isReadOnlyFlag;
     bool modifiedOnDiskFlag;
     bool ignoreModifiedOnDiskFlag;
@@ -28,6 +28,7 @@
 #include "Clipboard.hpp"
 #include "CharUtil.hpp"
 #include "ViewLuaInterface.hpp"
+#include "KeyboardMacro.hpp"
 
 using namespace LucED;
 
@@ -129,26 +130,46 @@ public:
         w->textData->setMergableHistorySeparator();
         TextData::HistorySection::Ptr historySectionHolder = w->textData->getHistorySectionHolder();
 
-        bool rslt = KeyActionHandler::invokeActionMethod(actionId);
+        bool rslt;
+        ++nestingLevel;
+        try {
+            rslt = KeyActionHandler::invokeActionMethod(actionId);
+        }
+        catch (...) {
+            --nestingLevel;
+            throw;
+        }
+        --nestingLevel;
     
         if (!rslt) {
             w->lastActionCategory    = oldLastActionCategory;
             w->currentActionCategory = oldCurrentActionCategory;
         }
+        else if (w->recordsKeyboardMacro && nestingLevel == 0) {
+            // actions invoked by other actions, e.g. from Lua, are not recorded
+            KeyboardMacro::getInstance()->recordAction(actionId);
+        }
         return rslt;
     }
     
     virtual bool handleLowPriorityKeyPress(const KeyPressEvent& keyPressEvent)
     {
-        return w->handleLowPriorityKeyPress(keyPressEvent);
+        bool rslt = w->handleLowPriorityKeyPress(keyPressEvent);
+        
+        if (rslt && w->recordsKeyboardMacro && keyPressEvent.hasInputString()) {
+            KeyboardMacro::getInstance()->recordInsertedText(keyPressEvent.getInputString());
+        }
+        return rslt;
     }
     
 private:
     MyKeyActionHandler(RawPtr<TextEditorWidget> w)
-        : w(w)
+        : w(w),
+          nestingLevel(0)
     {}
     
     RawPtr<TextEditorWidget> w;
+    int                      nestingLevel;
 };
 
 TextEditorWidget::TextEditorWidget(HilitedText::Ptr hilitedText, 
@@ -168,7 +189,8 @@ TextEditorWidget::TextEditorWidget(HilitedText::Ptr hilitedText,
         isSelectionPersistent(false),
         textData(getTextData()),
         readOnlyFlag(options.isSet(READ_ONLY)),
-        boundCursorFlag(true)
+        boundCursorFlag(true),
+        recordsKeyboardMacro(options.isSet(RECORD_KEYBOARD_MACRO))
 
 {
     setKeyActionHandler(MyKeyActionHandler::create(this));
@@ -452,6 +474,19 @@ GuiWidget::ProcessingResult TextEditorWidget::processGuiWidgetEvent(const XEvent
                         int x = event->xbutton.x;
                         int y = event->xbutton.y;
                         
+                        if ((event->xbutton.state & (ControlMask|ShiftMask)) == ControlMask && !isReadOnly())
+                        {
+                            // Ctrl+Click adds an additional cursor
+                            
+                            TextData::TextMark m = createNewMarkFromCursor();
+                            m.moveToPos(getTextPosFromPixXY(x, y));
+                            addAdditionalCursor(m);
+                            
+                            buttonPressedCounter = 0;
+                            return GuiWidget::EVENT_PROCESSED;
+                        }
+                        removeAdditionalCursors();
+
                         TextWidget::FreePos freePos = getFreePosFromPixXY(x, y);
                         
                         long newCursorPos = freePos.pos;
@@ -852,66 +887,132 @@ bool TextEditorWidget::handleLowPriorityKeyPress(const KeyPressEvent& keyPressEv
 
     {
         if (keyPressEvent.hasInputString()) {
-            if (!cursorChangesDisabled && !isReadOnly())
+            insertInputString(keyPressEvent.getInputString());
+            return GuiWidget::EVENT_PROCESSED;
+        } else {
+            return GuiWidget::NOT_PROCESSED;
+        }
+    }
+}
+
+void TextEditorWidget::insertInputString(const String& inputString)
+{
+    if (!cursorChangesDisabled && !isReadOnly())
+    {
+        lastActionCategory = currentActionCategory;
+        currentActionCategory = ACTION_KEYBOARD_INPUT;
+        
+        if (hasAdditionalCursors())
+        {
+            hideCursor();
+            releaseSelection();
+            insertAtAllCursors(inputString);
+            assureCursorVisible();
+            showCursor();
+            rememberedCursorPixX = getCursorPixX();
+            return;
+        }
+        textData->setMergableHistorySeparator();
+        TextData::HistorySection::Ptr historySectionHolder = textData->getHistorySectionHolder();
+        
+        hideCursor();
+        if (hasPrimarySelection())
+        {
+            long selBegin  = getBeginSelectionPos();
+            long selLength = getEndSelectionPos() - selBegin;
+            moveCursorToTextPosition(selBegin);
+            removeAtCursor(selLength);
+            releaseSelection();
+        }
+        else if (hasPseudoSelection())
+        {
+            if (   (lastActionCategory != ACTION_KEYBOARD_INPUT && lastActionCategory != ACTION_TABULATOR)
+                || getCursorTextPosition() != getBackliteBuffer()->getEndSelectionPos())
             {
-                lastActionCategory = currentActionCategory;
-                currentActionCategory = ACTION_KEYBOARD_INPUT;
-                
-                textData->setMergableHistorySeparator();
-                TextData::HistorySection::Ptr historySectionHolder = textData->getHistorySectionHolder();
-                
-                hideCursor();
-                if (hasPrimarySelection())
-                {
-                    long selBegin  = getBeginSelectionPos();
-                    long selLength = getEndSelectionPos() - selBegin;
-                    moveCursorToTextPosition(selBegin);
-                    removeAtCursor(selLength);
-                    releaseSelection();
-                }
-                else if (hasPseudoSelection())
-                {
-                    if (   (lastActionCategory != ACTION_KEYBOARD_INPUT && lastActionCategory != ACTION_TABULATOR)
-                        || getCursorTextPosition() != getBackliteBuffer()->getEndSelectionPos())
-                    {
-                        releaseSelection();
-                    }
-                }
-                if (!getBackliteBuffer()->hasActiveSelection())
-                {
-                    getBackliteBuffer()->activateSelection(getCursorTextPosition());
-                    getBackliteBuffer()->makeSelectionToSecondarySelection();
-                }
-                {
-                    long oldPos         = getCursorTextPosition();
-                    long insertedLength = insertAtCursor(keyPressEvent.getInputString());
-                    long newPos         = textData->getEndOfWChar(oldPos + insertedLength);
-                    moveCursorToTextPosition(newPos);
-                }
-                getBackliteBuffer()->extendSelectionTo(getCursorTextPosition());
+                releaseSelection();
+            }
+        }
+        if (!getBackliteBuffer()->hasActiveSelection())
+        {
+            getBackliteBuffer()->activateSelection(getCursorTextPosition());
+            getBackliteBuffer()->makeSelectionToSecondarySelection();
+        }
+        {
+            long oldPos         = getCursorTextPosition();
+            long insertedLength = insertAtCursor(inputString);
+            long newPos         = textData->getEndOfWChar(oldPos + insertedLength);
+            moveCursorToTextPosition(newPos);
+        }
+        getBackliteBuffer()->extendSelectionTo(getCursorTextPosition());
 
-                if (getCursorLineNumber() < getTopLineNumber()) {
-                    setTopLineNumber(getCursorLineNumber());
-                } else if ((getCursorLineNumber() - getTopLineNumber() + 1) * getLineHeight() > getHeightPix()) {
-                    setTopLineNumber(getCursorLineNumber() - getNumberOfVisibleLines() + 1);
-                }
-                long cursorPixX = getCursorPixX();
-                int spaceWidth = getDefaultTextStyle()->getSpaceWidth();
+        if (getCursorLineNumber() < getTopLineNumber()) {
+            setTopLineNumber(getCursorLineNumber());
+        } else if ((getCursorLineNumber() - getTopLineNumber() + 1) * getLineHeight() > getHeightPix()) {
+            setTopLineNumber(getCursorLineNumber() - getNumberOfVisibleLines() + 1);
+        }
+        long cursorPixX = getCursorPixX();
+        int spaceWidth = getDefaultTextStyle()->getSpaceWidth();
+
+        if (cursorPixX < getLeftPix()) {
+            setLeftPix(cursorPixX - spaceWidth);
+        } else if (cursorPixX >= getRightPix() - spaceWidth) {
+            setLeftPix(cursorPixX - (getRightPix() - getLeftPix()) + 2 * spaceWidth);
+        }
+        showCursor();
+    }
+    assureCursorVisible();
+    rememberedCursorPixX = getCursorPixX();
+}
 
-                if (cursorPixX < getLeftPix()) {
-                    setLeftPix(cursorPixX - spaceWidth);
-                } else if (cursorPixX >= getRightPix() - spaceWidth) {
-                    setLeftPix(cursorPixX - (getRightPix() - getLeftPix()) + 2 * spaceWidth);
+long TextEditorWidget::replayKeyboardMacro(long count)
+{
+    RawPtr<KeyboardMacro> macro = KeyboardMacro::getInstance();
+    
+    if (!macro->hasSteps() || cursorChangesDisabled || isReadOnly()) {
+        return 0;
+    }
+    TextData::HistorySection::Ptr historySection = textData->createHistorySection();
+
+    long rslt = 0;
+    
+    suspendScreenUpdates();
+    macro->setReplaying(true);
+    try
+    {
+        while (count <= 0 || rslt < count)
+        {
+            long distanceToEnd = textData->getLength() - getCursorTextPosition();
+            
+            if (count <= 0 && distanceToEnd == 0) {
+                break;
+            }
+            for (int i = 0, n = macro->getNumberOfSteps(); i < n; ++i)
+            {
+                const KeyboardMacro::Step& step = macro->getStep(i);
+                
+                if (step.isAction()) {
+                    getKeyActionHandler()->invokeActionMethod(step.getActionId());
+                } else {
+                    insertInputString(step.getInsertedText());
                 }
-                showCursor();
             }
-            assureCursorVisible();
-            rememberedCursorPixX = getCursorPixX();
-            return GuiWidget::EVENT_PROCESSED;
-        } else {
-            return GuiWidget::NOT_PROCESSED;
+            ++rslt;
+            
+            if (count <= 0 && textData->getLength() - getCursorTextPosition() >= distanceToEnd) {
+                break; // no progress towards the end
+            }
         }
     }
+    catch (...) {
+        macro->setReplaying(false);
+        resumeScreenUpdates();
+        throw;
+    }
+    macro->setReplaying(false);
+    resumeScreenUpdates();
+    assureCursorVisible();
+    
+    return rslt;
 }
 
 void TextEditorWidget::disableCursorChanges()
@@ -1139,3 +1240,131 @@ void TextEditorWidget::replaceSelection(const String& newContent)
     }
 }
 
+
+void TextEditorWidget::addAdditionalCursor(const TextData::TextMark& m)
+{
+    getMultiCursorBuffer()->addCursor(m);
+    getMultiCursorBuffer()->treatMovedCursors(getCursorTextPosition());
+}
+
+
+void TextEditorWidget::addAdditionalCursors(const ObjectArray<TextData::TextMark>& marks)
+{
+    getMultiCursorBuffer()->addCursors(marks);
+    getMultiCursorBuffer()->treatMovedCursors(getCursorTextPosition());
+}
+
+
+void TextEditorWidget::removeAdditionalCursors()
+{
+    getMultiCursorBuffer()->clear();
+}
+
+
+void TextEditorWidget::insertAtAllCursors(const String& s)
+{
+    RawPtr<MultiCursorBuffer> cursors = getMultiCursorBuffer();
+    
+    cursors->treatMovedCursors(getCursorTextPosition());
+    
+    TextData::EditList edits;
+    
+    edits.append(getCursorTextPosition(), 0, s);
+
+    for (long i = 0, n = cursors->getNumberOfCursors(); i < n; ++i) {
+        edits.append(cursors->getCursorPos(i), 0, s);
+    }
+    edits.sortByPosition();
+    
+    long insertedLength = textData->applyEdits(edits) / edits.getLength();
+
+    // all cursors stay before the inserted text
+    
+    moveCursorToTextPosition(getCursorTextPosition() + insertedLength);
+    
+    for (long i = 0, n = cursors->getNumberOfCursors(); i < n; ++i) {
+        TextData::TextMark m = cursors->getCursorMark(i);
+        m.moveToPos(m.getPos() + insertedLength);
+    }
+    cursors->treatMovedCursors(getCursorTextPosition());
+}
+
+
+void TextEditorWidget::removeAtAllCursors(bool backward)
+{
+    RawPtr<MultiCursorBuffer> cursors = getMultiCursorBuffer();
+    
+    cursors->treatMovedCursors(getCursorTextPosition());
+    
+    TextData::EditList edits;
+    long               primaryPos = getCursorTextPosition();
+    
+    for (long i = -1, n = cursors->getNumberOfCursors(); i < n; ++i)
+    {
+        long pos = (i < 0) ? primaryPos : cursors->getCursorPos(i);
+        
+        if (backward && pos > 0) {
+            long prevPos = textData->getPrevWCharPos(pos);
+            edits.append(prevPos, pos - prevPos, String());
+        }
+        else if (!backward && pos < textData->getLength()) {
+            long nextPos = textData->getNextWCharPos(pos);
+            edits.append(pos, nextPos - pos, String());
+        }
+    }
+    if (edits.sortByPosition()) {
+        textData->applyEdits(edits);
+    }
+    moveCursorToTextPosition(getCursorTextPosition());
+    
+    cursors->treatMovedCursors(getCursorTextPosition());
+}
+
+
+void TextEditorWidget::moveAdditionalCursors(CursorMovement movement)
+{
+    RawPtr<MultiCursorBuffer> cursors = getMultiCursorBuffer();
+    
+    for (long i = 0, n = cursors->getNumberOfCursors(); i < n; ++i)
+    {
+        TextData::TextMark m   = cursors->getCursorMark(i);
+        long               pos = m.getPos();
+        
+        switch (movement)
+        {
+            case CURSOR_LEFT: {
+                if (pos > 0) {
+                    m.moveToPos(textData->getPrevWCharPos(pos));
+                }
+                break;
+            }
+            case CURSOR_RIGHT: {
+                if (pos < textData->getLength()) {
+                    m.moveToPos(textData->getNextWCharPos(pos));
+                }
+                break;
+            }
+            case CURSOR_UP: {
+                if (m.getLine() > 0) {
+                    m.moveToLineAndWCharColumn(m.getLine() - 1, m.getWCharColumn());
+                }
+                break;
+            }
+            case CURSOR_DOWN: {
+                if (m.getLine() + 1 < textData->getNumberOfLines()) {
+                    m.moveToLineAndWCharColumn(m.getLine() + 1, m.getWCharColumn());
+                }
+                break;
+            }
+            case CURSOR_BEGIN_OF_LINE: {
+                m.moveToBeginOfLine();
+                break;
+            }
+            case CURSOR_END_OF_LINE: {
+                m.moveToEndOfLine();
+                break;
+            }
+        }
+    }
+    cursors->treatMovedCursors(getCursorTextPosition());
+}
@@ -57,6 +57,16 @@ public:
         CURSOR_TO_BEGIN_OF_PASTED_DATA,
         CURSOR_TO_END_OF_PASTED_DATA
     };
+    
+    enum CursorMovement
+    {
+        CURSOR_LEFT,
+        CURSOR_RIGHT,
+        CURSOR_UP,
+        CURSOR_DOWN,
+        CURSOR_BEGIN_OF_LINE,
+        CURSOR_END_OF_LINE
+    };
 
     static Ptr create(HilitedText::Ptr hilitedText,
                       CreateOptions    options = CreateOptions())
@@ -225,6 +235,35 @@ public:
 
     void replaceTextWithPrimarySelection();
     void replaceSelection(const String& newContent);
+
+    bool hasAdditionalCursors() {
+        return getMultiCursorBuffer()->hasCursors();
+    }
+    void addAdditionalCursor(const TextData::TextMark& m);
+    void addAdditionalCursors(const ObjectArray<TextData::TextMark>& marks);
+    void removeAdditionalCursors();
+    
+    /**
+     * Edits at the primary and all additional cursors are applied 
+     * in one pass through the text and are one undo step.
+     */
+    void insertAtAllCursors(const String& s);
+    void removeAtAllCursors(bool backward);
+
+    void moveAdditionalCursors(CursorMovement movement);
+    
+    /**
+     * Inserts keyboard input like typed by the user.
+     */
+    void insertInputString(const String& inputString);
+    
+    /**
+     * Replays the recorded keyboard macro count times or, if count is 0, 
+     * until it stops approaching the end of the text. Nothing is drawn 
+     * before the last repetition is finished and all repetitions are 
+     * one undo step. Returns the number of repetitions.
+     */
+    long replayKeyboardMacro(long count = 0);
     
     void registerListenerForNextSelectionChange(Callback<>::Ptr callback) {
         getBackliteBuffer()->registerListenerForNextChange(callback);
@@ -293,6 +332,8 @@ private:
     bool readOnlyFlag;
 
     bool boundCursorFlag;
+    
+    bool recordsKeyboardMacro;
 
     OwningPtr<ViewLuaInterface> viewLuaInterface;
 };
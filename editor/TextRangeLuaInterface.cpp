@@ -0,0 +1,369 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2011 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "TextRangeLuaInterface.hpp"
+#include "MatchLuaInterface.hpp"
+#include "LuaCClosure.hpp"
+#include "LuaCMethodArgChecker.hpp"
+#include "LuaArgException.hpp"
+#include "LuaException.hpp"
+#include "RegexException.hpp"
+#include "util.hpp"
+
+using namespace LucED;
+
+namespace // anonymous namespace
+{
+
+const long DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+} // anonymous namespace
+
+bool TextRangeLuaInterface::clipToTextLength()
+{
+    if (!textData.isValid() || !e.isValid()) {
+        return false;
+    }
+    const long length = textData->getLength();
+    
+    if (beginPos < 0) {
+        beginPos = 0;
+    }
+    if (endPos > length) {
+        endPos = length;
+    }
+    if (beginPos > endPos) {
+        beginPos = endPos;
+    }
+    if (iteratorPos < beginPos) {
+        iteratorPos = beginPos;
+    }
+    if (iteratorPos > endPos) {
+        iteratorPos = endPos;
+    }
+    return true;
+}
+
+
+LuaVar TextRangeLuaInterface::toLuaString(const LuaAccess& luaAccess, long pos, long amount)
+{
+    if (amount <= 0) {
+        return luaAccess.toLua("");
+    }
+    long contiguousLength = textData->getContiguousLength(pos);
+    
+    if (amount <= contiguousLength) {
+        return luaAccess.toLua((const char*)(textData->getContiguousPtr(pos)), amount);
+    }
+    else {
+        // amount spans the gap: assemble the parts in the reused
+        // buffer instead of moving the gap
+        lineBuffer.clear();
+        
+        while (amount > 0) {
+            long n = util::minimum(amount, textData->getContiguousLength(pos));
+            lineBuffer.append(textData->getContiguousPtr(pos), n);
+            pos    += n;
+            amount -= n;
+        }
+        return luaAccess.toLua((const char*)(lineBuffer.getPtr(0)), lineBuffer.getLength());
+    }
+}
+
+
+const char* TextRangeLuaInterface::getMatchSubject(long* length)
+{
+    if (!clipToTextLength()) {
+        return NULL;
+    }
+    *length = endPos - beginPos;
+    
+    // moves the gap only if it lies inside of the range, 
+    // subsequent matches on an unmodified text are gap free
+    
+    return (const char*)(textData->getAmount(beginPos, *length));
+}
+
+
+const char* TextRangeLuaInterface::readLpegSubject(lua_State* L, int stackIndex, size_t* length)
+{
+    LuaAccess::UserData* userDataPtr = static_cast<LuaAccess::UserData*>(lua_touserdata(L, stackIndex));
+
+    if (   userDataPtr == NULL
+        || userDataPtr->magic != LuaAccess::MAGIC
+        || !userDataPtr->isOwningPtr)
+    {
+        return NULL;
+    }
+    HeapObject* object = static_cast<OwningPtr<HeapObject>*>(static_cast<void*>(userDataPtr + 1))
+                         ->getRawPtr();
+
+    TextRangeLuaInterface* range = dynamic_cast<TextRangeLuaInterface*>(object);
+    
+    if (range == NULL) {
+        return NULL;
+    }
+    long        subjectLength;
+    const char* subject = range->getMatchSubject(&subjectLength);
+    
+    if (subject == NULL) {
+        return NULL;
+    }
+    // Lua captures (e.g. lpeg.Cmt) may modify the text during the match,
+    // which moves the gap. lpeg therefore gets a copy that is anchored on
+    // the Lua stack in place of the range object.
+
+    lua_pushlstring(L, subject, subjectLength);
+    lua_replace(L, stackIndex);
+
+    return lua_tolstring(L, stackIndex, length);
+}
+
+
+LuaCFunctionResult TextRangeLuaInterface::getBeginPos(const LuaCFunctionArguments& args)
+{
+    clipToTextLength();
+    return LuaCFunctionResult(args.getLuaAccess()) << beginPos;
+}
+
+
+LuaCFunctionResult TextRangeLuaInterface::getEndPos(const LuaCFunctionArguments& args)
+{
+    clipToTextLength();
+    return LuaCFunctionResult(args.getLuaAccess()) << endPos;
+}
+
+
+LuaCFunctionResult TextRangeLuaInterface::getLength(const LuaCFunctionArguments& args)
+{
+    clipToTextLength();
+    return LuaCFunctionResult(args.getLuaAccess()) << (endPos - beginPos);
+}
+
+
+LuaCFunctionResult TextRangeLuaInterface::getBytes(const LuaCFunctionArguments& args)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+    
+    long spos = beginPos;
+    long epos = endPos;
+
+    if (args.getLength() > 0) {
+        LuaCMethodArgChecker<long,long>::check(args);
+        spos = args[0].toLong();
+        epos = args[1].toLong();
+    }
+    if (!clipToTextLength()) {
+        return LuaCFunctionResult(luaAccess);
+    }
+    spos = util::maximum(spos, beginPos);
+    epos = util::minimum(epos, endPos);
+    
+    return LuaCFunctionResult(luaAccess) << toLuaString(luaAccess, spos, epos - spos);
+}
+
+
+LuaCFunctionResult TextRangeLuaInterface::getSubRange(const LuaCFunctionArguments& args)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+
+    LuaCMethodArgChecker<long,long>::check(args);
+
+    if (!clipToTextLength()) {
+        return LuaCFunctionResult(luaAccess);
+    }
+    long spos = util::maximum(args[0].toLong(), beginPos);
+    long epos = util::minimum(args[1].toLong(), endPos);
+    
+    if (epos < spos) {
+        epos = spos;
+    }
+    return LuaCFunctionResult(luaAccess) << create(e, spos, epos);
+}
+
+
+LuaCFunctionResult TextRangeLuaInterface::nextLineFunction(const LuaCFunctionArguments& args, 
+                                                           LuaVarRef rangeVar)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+    
+    Ptr range = rangeVar.toOwningPtr<TextRangeLuaInterface>();
+
+    if (!range.isValid() || !range->clipToTextLength() || range->iteratorPos >= range->endPos) {
+        return LuaCFunctionResult(luaAccess);
+    }
+    RawPtr<TextData> textData  = range->textData;
+    const long       lineBegin = range->iteratorPos;
+    const long       endPos    = range->endPos;
+    long             lineEnd   = lineBegin;
+    
+    while (lineEnd < endPos)
+    {
+        long        n = util::minimum(textData->getContiguousLength(lineEnd), endPos - lineEnd);
+        const byte* p = textData->getContiguousPtr(lineEnd);
+        const byte* q = static_cast<const byte*>(memchr(p, '\n', n));
+        
+        if (q != NULL) {
+            lineEnd += q - p;
+            break;
+        } else {
+            lineEnd += n;
+        }
+    }
+    range->iteratorPos = (lineEnd < endPos) ? lineEnd + 1 : endPos;
+    
+    return LuaCFunctionResult(luaAccess) << range->toLuaString(luaAccess, lineBegin, lineEnd - lineBegin)
+                                         << lineBegin;
+}
+
+
+LuaCFunctionResult TextRangeLuaInterface::lines(const LuaCFunctionArguments& args)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+
+    if (!clipToTextLength()) {
+        return LuaCFunctionResult(luaAccess);
+    }
+    Ptr iteratorRange = create(e, beginPos, endPos);
+    
+    return LuaCFunctionResult(luaAccess) << LuaCClosure::create<nextLineFunction>(luaAccess.toLua(iteratorRange));
+}
+
+
+LuaCFunctionResult TextRangeLuaInterface::nextChunkFunction(const LuaCFunctionArguments& args, 
+                                                            LuaVarRef rangeVar,
+                                                            LuaVarRef chunkSizeVar)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+    
+    Ptr range = rangeVar.toOwningPtr<TextRangeLuaInterface>();
+
+    if (!range.isValid() || !range->clipToTextLength() || range->iteratorPos >= range->endPos) {
+        return LuaCFunctionResult(luaAccess);
+    }
+    RawPtr<TextData> textData   = range->textData;
+    const long       chunkBegin = range->iteratorPos;
+    
+    // chunks never span the gap and can be pushed without copying
+    
+    long amount = util::minimum(range->endPos - chunkBegin, chunkSizeVar.toLong());
+         amount = util::minimum(amount, textData->getContiguousLength(chunkBegin));
+    
+    range->iteratorPos += amount;
+
+    return LuaCFunctionResult(luaAccess) << luaAccess.toLua((const char*)(textData->getContiguousPtr(chunkBegin)), 
+                                                            amount)
+                                         << chunkBegin;
+}
+
+
+LuaCFunctionResult TextRangeLuaInterface::chunks(const LuaCFunctionArguments& args)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+    
+    long chunkSize = DEFAULT_CHUNK_SIZE;
+    
+    if (args.getLength() > 0) {
+        LuaCMethodArgChecker<long>::check(args);
+        chunkSize = args[0].toLong();
+        if (chunkSize <= 0) {
+            throw LuaArgException(luaAccess, "chunk size must be positive");
+        }
+    }
+    if (!clipToTextLength()) {
+        return LuaCFunctionResult(luaAccess);
+    }
+    Ptr iteratorRange = create(e, beginPos, endPos);
+    
+    return LuaCFunctionResult(luaAccess) << LuaCClosure::create<nextChunkFunction>(luaAccess.toLua(iteratorRange),
+                                                                                  luaAccess.toLua(chunkSize));
+}
+
+
+LuaCFunctionResult TextRangeLuaInterface::internFindMatch(const LuaCFunctionArguments& args,
+                                                          BasicRegex::MatchOptions matchOptions)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+
+    if (   args.getLength() < 1 || args.getLength() > 2 
+        || !args[0].isString() 
+        || (args.getLength() == 2 && !args[1].isNumber()))
+    {
+        throw LuaArgException(luaAccess);
+    }
+    String expression = args[0].toString();
+    
+    if (!regex.isValid() || expression != regexString)
+    {
+        try {
+            regex       = BasicRegex(expression, BasicRegex::MULTILINE);
+            regexString = expression;
+            ovector.clear();
+            ovector.increaseTo(regex.getOvecSize());
+        } catch (RegexException& ex) {
+            throw LuaException(luaAccess,
+                               String() << "Invalid Regex '" << expression 
+                                        << "': " << ex.getMessage()); 
+        }
+    }
+    long        length;
+    const char* subject = getMatchSubject(&length);
+    
+    if (subject == NULL) {
+        return LuaCFunctionResult(luaAccess);
+    }
+    long startPos = (args.getLength() == 2) ? args[1].toLong() : beginPos;
+    
+    if (startPos < beginPos || startPos > endPos) {
+        return LuaCFunctionResult(luaAccess);
+    }
+    if (beginPos > 0 && textData->getByte(beginPos - 1) != '\n') {
+        matchOptions.set(BasicRegex::NOTBOL);
+    }
+    if (endPos < textData->getLength() && textData->getByte(endPos) != '\n') {
+        matchOptions.set(BasicRegex::NOTEOL);
+    }
+    if (regex.findMatch(subject, length, startPos - beginPos, matchOptions, ovector))
+    {
+        for (int i = 0, n = 2 * (regex.getNumberOfCapturingSubpatterns() + 1); i < n; ++i) {
+            if (ovector[i] >= 0) {
+                ovector[i] += beginPos;
+            }
+        }
+        return LuaCFunctionResult(luaAccess) << MatchLuaInterface::create(e, regex, &ovector);
+    }
+    else {
+        return LuaCFunctionResult(luaAccess);
+    }
+}
+
+
+LuaCFunctionResult TextRangeLuaInterface::findMatch(const LuaCFunctionArguments& args)
+{
+    return internFindMatch(args, BasicRegex::MatchOptions());
+}
+
+
+LuaCFunctionResult TextRangeLuaInterface::match(const LuaCFunctionArguments& args)
+{
+    return internFindMatch(args, BasicRegex::ANCHORED);
+}
+
@@ -28,31 +28,17 @@ SingletonInstance<TextStyleCache> TextStyleCache::instance;
 
 TextStyle::Ptr TextStyleCache::getTextStyle(const String& fontname, const String& colorName)
 {
-    TextStyle::Ptr rslt;
-    
-    for (int i = 0; i < list.getLength();)
+    for (int i = 0; i < list.getLength(); ++i)
     {
         if (   list[i]->getFontName() == fontname
             && list[i]->getColorName() == colorName)
         {
-            rslt = list[i];
-            ++i;
+            return list[i];
         }
-        else
-        { 
-            if (list[i].getRefCounter() == 1) {
-                list.remove(i);
-            }
-            else {
-                ++i;
-            }
-        }
-    }
-    if (!rslt.isValid())
-    {
-        rslt = TextStyle::CacheAccess::create(getFontInfo(fontname), colorName);
-        list.append(rslt);
     }
+    TextStyle::Ptr rslt = TextStyle::CacheAccess::create(getFontInfo(fontname), colorName);
+    list.append(rslt);
+
     ASSERT(rslt.isValid());
     return rslt;
 }
@@ -60,28 +46,93 @@ TextStyle::Ptr TextStyleCache::getTextStyle(const String& fontname, const String
 
 FontInfo::Ptr TextStyleCache::getFontInfo(const String& fontname)
 {
+    for (int i = 0; i < fontInfos.getLength(); ++i)
+    {
+        if (fontInfos[i]->getFontName() == fontname) {
+            return fontInfos[i];
+        }
+    }
     FontInfo::Ptr rslt;
+
+    HashMap<String,Font>::Value preloadedFont = preloadedFonts.get(fontname);
+    if (preloadedFont.isValid()) {
+        preloadedFonts.remove(fontname);
+        rslt = FontInfo::CacheAccess::create(fontname, preloadedFont.get());
+    } else {
+        rslt = FontInfo::CacheAccess::create(fontname);
+    }
+    fontInfos.append(rslt);
+
+    ASSERT(rslt.isValid());
+    return rslt;
+}
+
+
+void TextStyleCache::preloadFonts(const ObjectArray<String>& fontNames)
+{
+    if (!GuiRoot::isInstanceValid()) {
+        return;
+    }
+    Display*      display     = GuiRoot::getInstance()->getDisplay();
+    unsigned long firstSerial = NextRequest(display);
     
-    for (int i = 0; i < fontInfos.getLength();)
+    for (int i = 0; i < fontNames.getLength(); ++i)
     {
-        if (fontInfos[i]->getFontName() == fontname) {
-            rslt = fontInfos[i];
+        bool isLoaded = preloadedFonts.hasKey(fontNames[i]);
+        
+        for (int j = 0; !isLoaded && j < fontInfos.getLength(); ++j) {
+            isLoaded = (fontInfos[j]->getFontName() == fontNames[i]);
+        }
+        if (!isLoaded) {
+            preloadedFonts.set(fontNames[i], XLoadFont(display, fontNames[i].toCString()));
+        }
+    }
+    unsigned long lastSerial = NextRequest(display) - 1;
+    
+    if (lastSerial >= firstSerial) {
+        GuiRoot::getInstance()->ignoreX11ErrorsForRequests(firstSerial, lastSerial);
+        XFlush(display);
+    }
+}
+
+
+void TextStyleCache::removeUnusedEntries()
+{
+    for (int i = 0; i < list.getLength();)
+    {
+        if (list[i].getRefCounter() == 1) {
+            list.remove(i);
+        } else {
             ++i;
         }
-        else
-        {
-            if (fontInfos[i].getRefCounter() == 1) {
-                fontInfos.remove(i);
-            } else {
-                ++i;
-            }
+    }
+    for (int i = 0; i < fontInfos.getLength();)
+    {
+        if (fontInfos[i].getRefCounter() == 1) {
+            fontInfos.remove(i);
+        } else {
+            ++i;
         }
     }
-    if (!rslt.isValid())
+    if (!preloadedFonts.isEmpty())
     {
-        rslt = FontInfo::CacheAccess::create(fontname);
-        fontInfos.append(rslt);
+        Display*      display     = GuiRoot::getInstance()->getDisplay();
+        unsigned long firstSerial = NextRequest(display);
+        
+        for (HashMap<String,Font>::Iterator i = preloadedFonts.getIterator(); !i.isAtEnd(); i.gotoNext()) {
+            XUnloadFont(display, i.getValue());
+        }
+        GuiRoot::getInstance()->ignoreX11ErrorsForRequests(firstSerial, NextRequest(display) - 1);
+        preloadedFonts.clear();
+    }
+}
+
+
+long TextStyleCache::getAllocatedFontInfoBytes() const
+{
+    long rslt = 0;
+    for (int i = 0; i < fontInfos.getLength(); ++i) {
+        rslt += fontInfos[i]->getAllocatedBytes();
     }
-    ASSERT(rslt.isValid());
     return rslt;
 }
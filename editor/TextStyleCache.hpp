@@ -29,6 +29,7 @@
 #include "ObjectArray.hpp"
 #include "WeakPtr.hpp"
 #include "TextStyleDefinition.hpp"
+#include "HashMap.hpp"
 
 namespace LucED
 {
@@ -48,6 +49,27 @@ public:
     }
 
     FontInfo::Ptr getFontInfo(const String& fontname);
+    
+    /**
+     * Sends the load requests for the given fonts without waiting for
+     * the server, so that the fonts are loaded while the configuration
+     * is processed further.
+     */
+    void preloadFonts(const ObjectArray<String>& fontNames);
+    
+    /**
+     * Text styles and fonts are kept after the last window using them
+     * has been closed, unused entries are only removed by this method.
+     */
+    void removeUnusedEntries();
+    
+    long getNumberOfTextStyles() const {
+        return list.getLength();
+    }
+    long getNumberOfFontInfos() const {
+        return fontInfos.getLength();
+    }
+    long getAllocatedFontInfoBytes() const;
 
 private:
     friend class SingletonInstance<TextStyleCache>;
@@ -59,6 +81,7 @@ private:
     
     ObjectArray<TextStyle::Ptr> list;
     ObjectArray<FontInfo::Ptr> fontInfos;
+    HashMap<String,Font>       preloadedFonts;
 };
 
 } // namespace LucED
@@ -130,6 +130,11 @@ TextWidget::TextWidget(HilitedText::Ptr hilitedText, int border,
       cursorIsActive(false),
       updateVerticalScrollBar(false),
       updateHorizontalScrollBar(false),
+      hasPendingRedraw(false),
+      pendingRedrawBeginPos(0),
+      pendingRedrawEndPos(0),
+      needsTotalPixWidthCalculation(false),
+      screenUpdatesSuspendedCounter(0),
       
       hasPosition(false),
       hilitedText(hilitedText),
@@ -140,6 +145,8 @@ TextWidget::TextWidget(HilitedText::Ptr hilitedText, int border,
       rawTextStylePtrs(textStyles),
       hilitingBuffer(HilitingBuffer::create(hilitedText)),
       backliteBuffer(BackliteBuffer::create(textData)),
+      matchBackliteBuffer(MatchBackliteBuffer::create(textData)),
+      multiCursorBuffer(MultiCursorBuffer::create(textData)),
       lineInfos(),
       topMarkId(textData->createNewMark()),
       cursorMarkId(textData->createNewMark()),
@@ -162,6 +169,8 @@ TextWidget::TextWidget(HilitedText::Ptr hilitedText, int border,
       
       primarySelectionColor(  getGuiRoot()->getGuiColor(GlobalConfig::getConfigData()->getGeneralConfig()->getPrimarySelectionColor())),
       secondarySelectionColor(getGuiRoot()->getGuiColor(GlobalConfig::getConfigData()->getGeneralConfig()->getPseudoSelectionColor())),
+      matchHighlightColor(    getGuiRoot()->getGuiColor(GlobalConfig::getConfigData()->getGeneralConfig()->getMatchHighlightColor())),
+      additionalCursorColor(  getGuiRoot()->getGuiColor(GlobalConfig::getConfigData()->getGeneralConfig()->getAdditionalCursorColor())),
       backgroundColor(        getGuiRoot()->getWhiteColor()),
       textWidget_gcid(TextWidgetSingletonData::getInstance()->getGcId()),
       
@@ -211,6 +220,8 @@ TextWidget::TextWidget(HilitedText::Ptr hilitedText, int border,
     hilitingBuffer->registerTextStylesChangedListeners (newCallback(this, &TextWidget::treatTextStylesChanged));
     hilitingBuffer->registerUpdateListener             (newCallback(this, &TextWidget::treatHilitingUpdate));
     backliteBuffer->registerUpdateListener             (newCallback(this, &TextWidget::treatHilitingUpdate));
+    matchBackliteBuffer->registerUpdateListener        (newCallback(this, &TextWidget::treatHilitingUpdate));
+    multiCursorBuffer->registerUpdateListener          (newCallback(this, &TextWidget::treatHilitingUpdate));
     
     redrawRegion = XCreateRegion();
 }
@@ -279,10 +290,8 @@ printf("treatHilitingUpdate %d ... %d\n", update.beginPos, update.endPos);
 #endif
     if (update.endPos >= getTopLeftTextPosition() && update.beginPos < this->endPos)
     {
-        redrawChanged(update.beginPos, update.endPos);
-        totalPixWidth = 0;
-        calcTotalPixWidth();
-        updateHorizontalScrollBar = true;
+        addPendingRedraw(update.beginPos, update.endPos);
+        needsTotalPixWidthCalculation = true;
     }
 }
 
@@ -296,6 +305,8 @@ public:
     TextWidgetFillLineInfoIterator(RawPtr<const TextData>                  textData, 
                                    RawPtr<HilitingBuffer>                  hilitingBuffer, 
                                    RawPtr<BackliteBuffer>                  backliteBuffer,
+                                   RawPtr<MatchBackliteBuffer>             matchBackliteBuffer,
+                                   RawPtr<MultiCursorBuffer>               multiCursorBuffer,
                                    RawPtr<const ObjectArray< RawPtr<TextStyle> > > 
                                                                            textStyles,
                                    RawPtr<TextStyle>                       defaultTextStyle,
@@ -303,6 +314,8 @@ public:
         : textData(textData),
           hilitingBuffer(hilitingBuffer),
           backliteBuffer(backliteBuffer),
+          matchBackliteBuffer(matchBackliteBuffer),
+          multiCursorBuffer(multiCursorBuffer),
           textStyles(textStyles),
           defaultTextStyle(defaultTextStyle),
           pixelPos(0),
@@ -315,7 +328,7 @@ public:
           tabWidth(hilitingBuffer->getLanguageMode()->getHardTabWidth() * defaultTextStyle->getSpaceWidth()),
           charWidth(isEndOfLineFlag ? 0 : style->getCharWidth(c)),
           doBackgroundFlag(true),
-          background(backliteBuffer->getBackground(textPos)),
+          background(getBackgroundAt(textPos)),
           numberWChars(0),
           maxCharAscent (isEndOfLineFlag ? 0 : style->getCharAscent(c)),
           maxCharDescent(isEndOfLineFlag ? 0 : style->getCharDescent(c))
@@ -329,13 +342,25 @@ public:
     int getSpaceWidth()  const { return spaceWidth; }
     int getBackground()  const { ASSERT(doBackgroundFlag == true); return background; }
 
+    int getBackgroundAt(long textPos) const
+    {
+        int rslt = multiCursorBuffer->getBackground(textPos);
+        if (rslt == 0) {
+            rslt = backliteBuffer->getBackground(textPos);
+        }
+        if (rslt == 0) {
+            rslt = matchBackliteBuffer->getBackground(textPos);
+        }
+        return rslt;
+    }
+
     long getNumberOfIteratedWChars() const { return numberWChars; }
 
     void setDoBackground(bool flag)
     {
         doBackgroundFlag = flag; 
         if (flag) {
-            background = backliteBuffer->getBackground(textPos);
+            background = getBackgroundAt(textPos);
         }
     }
 
@@ -383,7 +408,7 @@ public:
             charWidth  = 0;
         }
         if (doBackgroundFlag == true) {
-            background = backliteBuffer->getBackground(textPos);
+            background = getBackgroundAt(textPos);
         }
     }
 
@@ -391,6 +416,8 @@ private:
     RawPtr<const TextData>             const textData;
     RawPtr<HilitingBuffer>             const hilitingBuffer;
     RawPtr<BackliteBuffer>             const backliteBuffer;
+    RawPtr<MatchBackliteBuffer>        const matchBackliteBuffer;
+    RawPtr<MultiCursorBuffer>          const multiCursorBuffer;
     RawPtr<TextStyle>                  const defaultTextStyle;
     RawPtr<const ObjectArray< RawPtr<TextStyle> > >  textStyles;
     long pixelPos;
@@ -476,7 +503,9 @@ private:
 
 void TextWidget::fillLineInfo(long beginOfLinePos, RawPtr<LineInfo> li)
 {
-    TextWidgetFillLineInfoIterator i(textData, hilitingBuffer, backliteBuffer, &rawTextStylePtrs, defaultTextStyle, beginOfLinePos);
+    matchBackliteBuffer->prepareVisibleRange(beginOfLinePos, lineInfos.getLength());
+
+    TextWidgetFillLineInfoIterator i(textData, hilitingBuffer, backliteBuffer, matchBackliteBuffer, multiCursorBuffer, &rawTextStylePtrs, defaultTextStyle, beginOfLinePos);
     TextWidgetFragmentFiller       f(&li->fragments);
     
     int  print = 0;
@@ -688,6 +717,10 @@ inline GuiColor TextWidget::getColorForBackground(byte background)
         case 0:  return backgroundColor;
         case 1:  return primarySelectionColor;
         case 2:  return secondarySelectionColor;
+        case MatchBackliteBuffer::MATCH_BACKGROUND:
+                 return matchHighlightColor;
+        case MultiCursorBuffer::CURSOR_BACKGROUND:
+                 return additionalCursorColor;
         default: ASSERT(false);
                  return backgroundColor;
     }
@@ -1504,6 +1537,41 @@ void TextWidget::redrawChanged(long spos, long epos)
 
 
 
+void TextWidget::addPendingRedraw(long spos, long epos)
+{
+    if (hasPendingRedraw) {
+        MINIMIZE(&pendingRedrawBeginPos, spos);
+        MAXIMIZE(&pendingRedrawEndPos,   epos);
+    } else {
+        pendingRedrawBeginPos = spos;
+        pendingRedrawEndPos   = epos;
+        hasPendingRedraw      = true;
+    }
+}
+
+
+void TextWidget::processPendingRedraw()
+{
+    if (screenUpdatesSuspendedCounter > 0) {
+        if (hasPendingRedraw) {
+            hasPendingRedraw = false;
+            lineInfos.setAllInvalid();
+        }
+        return;
+    }
+    if (hasPendingRedraw) {
+        hasPendingRedraw = false;
+        redrawChanged(pendingRedrawBeginPos, pendingRedrawEndPos);
+    }
+    if (needsTotalPixWidthCalculation) {
+        needsTotalPixWidthCalculation = false;
+        totalPixWidth = 0;
+        calcTotalPixWidth();
+        updateHorizontalScrollBar = true;
+    }
+}
+
+
 inline void TextWidget::redraw() {
     drawArea(0, getHeight());
 }
@@ -1536,7 +1604,11 @@ RawPtr<LineInfo> TextWidget::getValidLineInfo(long line)
 
 void TextWidget::drawCursor(long cursorPos)
 {
+    if (screenUpdatesSuspendedCounter > 0) {
+        return;
+    }
     textData->flushPendingUpdates();
+    processPendingRedraw();
 
     int y = 0;
     int line = 0;
@@ -1578,12 +1650,13 @@ void TextWidget::drawCursor(long cursorPos)
 long TextWidget::getCursorPixX()
 {
     textData->flushPendingUpdates();
+    processPendingRedraw();
     
     long cursorPos = getCursorTextPosition();
     int line = getCursorLineNumber() - getTopLineNumber();
     long lineBegin;
     
-    if (0 <= line && line < visibleLines)
+    if (0 <= line && line < visibleLines && screenUpdatesSuspendedCounter == 0)
     {
         RawPtr<LineInfo> li = getValidLineInfo(line);
     
@@ -1664,8 +1737,11 @@ void TextWidget::calcTotalPixWidth()
 void TextWidget::setTopLineNumber(long n)
 {
     textData->flushPendingUpdates();
+    processPendingRedraw();
     
-    calcTotalPixWidth();
+    if (screenUpdatesSuspendedCounter == 0) {
+        calcTotalPixWidth();
+    }
 
     long oldTopLineNumber = getTopLineNumber();
     
@@ -1677,7 +1753,15 @@ void TextWidget::setTopLineNumber(long n)
     if (n < 0) 
         n = 0;
         
-    if (n != oldTopLineNumber)
+    if (n != oldTopLineNumber && screenUpdatesSuspendedCounter > 0)
+    {
+        lineInfos.moveFirst(n - oldTopLineNumber);
+        lineInfos.setAllInvalid();
+        textData->moveMarkToLineAndWCharColumn(topMarkId, n, 0);
+        updateVerticalScrollBar       = true;
+        needsTotalPixWidthCalculation = true;
+    }
+    else if (n != oldTopLineNumber)
     {
         bool redrawTopLinePart    = false;
         int  redrawTopLineDeltaY = 0;
@@ -1789,6 +1873,7 @@ TextWidget::FreePos TextWidget::getFreePosForPixX(long pixX, long beginOfLinePos
 TextWidget::FreePos TextWidget::getFreePosFromPixXY(int pixX, int pixY, bool optimizeForThinCursor)
 {
     textData->flushPendingUpdates();
+    processPendingRedraw();
 
     int screenLine = pixY / lineHeight;
     if (screenLine >= getNumberOfVisibleLines()) {
@@ -1966,8 +2051,20 @@ void TextWidget::internSetLeftPix(long newLeftPix)
 void TextWidget::setLeftPix(long newLeftPix)
 {
     textData->flushPendingUpdates();
+    processPendingRedraw();
     
-    internSetLeftPix(newLeftPix);
+    if (screenUpdatesSuspendedCounter > 0) {
+        if (newLeftPix < 0) {
+            newLeftPix = 0;
+        }
+        if (newLeftPix != leftPix) {
+            leftPix = newLeftPix;
+            lineInfos.setAllInvalid();
+            needsTotalPixWidthCalculation = true;
+        }
+    } else {
+        internSetLeftPix(newLeftPix);
+    }
     updateHorizontalScrollBar= true;
 }
 
@@ -2002,6 +2099,7 @@ void TextWidget::processGuiWidgetNewPositionEvent(const Position& p)
             hasPosition       = true;
         }
         textData->flushPendingUpdates();
+        processPendingRedraw();
         
         long oldTopLineNumber = getTopLineNumber();
         
@@ -2251,6 +2349,24 @@ void TextWidget::showCursor()
     }
 }
 
+void TextWidget::resumeScreenUpdates()
+{
+    ASSERT(screenUpdatesSuspendedCounter > 0);
+
+    if (--screenUpdatesSuspendedCounter == 0)
+    {
+        textData->flushPendingUpdates();
+        
+        hasPendingRedraw = false;
+        lineInfos.setAllInvalid();
+        needsTotalPixWidthCalculation = true;
+        processPendingRedraw();
+        redraw();
+        
+        updateVerticalScrollBar = true;
+    }
+}
+
 void TextWidget::stopCursorBlinking()
 {
     if (!neverShowCursorFlag)
@@ -2499,6 +2615,8 @@ GuiWidget::ProcessingResult TextWidget::processGuiWidgetEvent(const XEvent* even
 
 void TextWidget::processGuiWidgetRedrawEvent(Region redrawRegion)
 {
+    processPendingRedraw();
+
     GuiClipping::Holder clippingHolder(TextWidgetSingletonData::getInstance()->getClipping(),
                                        redrawRegion);
     redraw();
@@ -2521,6 +2639,8 @@ static inline bool adjustLineInfoPosition(long* pos, long beginChangedPos, long
 
 void TextWidget::treatTextDataUpdate(TextData::UpdateInfo u)
 {
+    matchBackliteBuffer->treatTextDataUpdate(u);
+
     if (cursorColumnsBehindEndOfLine > 0 && !cursorMarkId.isAtEndOfLine())
     {
         long p = cursorMarkId.getPos();
@@ -2570,13 +2690,31 @@ void TextWidget::treatTextDataUpdate(TextData::UpdateInfo u)
         }
     }
 
+    if (hasPendingRedraw) {
+        // pending range must follow the change, otherwise lines touched by
+        // earlier updates could be missed in processPendingRedraw()
+        if (pendingRedrawBeginPos > u.oldEndChangedPos) {
+            pendingRedrawBeginPos += u.changedAmount;
+        } else if (pendingRedrawBeginPos > u.beginChangedPos) {
+            pendingRedrawBeginPos = u.beginChangedPos;
+        }
+        if (pendingRedrawEndPos > u.oldEndChangedPos) {
+            pendingRedrawEndPos += u.changedAmount;
+        } else if (pendingRedrawEndPos >= u.beginChangedPos) {
+            pendingRedrawEndPos = util::maximum(u.beginChangedPos, newEndChangedPos);
+        }
+        redraw = true;
+    }
+    if (endPos > u.oldEndChangedPos) {
+        endPos += u.changedAmount;
+    } else if (endPos > u.beginChangedPos) {
+        endPos = util::maximum(u.beginChangedPos, newEndChangedPos);
+    }
     if (redraw) {
-        redrawChanged(u.beginChangedPos, u.oldEndChangedPos);
+        addPendingRedraw(u.beginChangedPos, util::maximum(u.oldEndChangedPos, newEndChangedPos));
     }
     updateVerticalScrollBar = true;
-    totalPixWidth = 0;
-    calcTotalPixWidth();
-    updateHorizontalScrollBar = true;
+    needsTotalPixWidthCalculation = true;
 }
 
 
@@ -2617,6 +2755,9 @@ long TextWidget::getOpticalColumn(long pos) const
 
 void TextWidget::flushPendingUpdates()
 {
+    textData->flushPendingUpdates();
+    processPendingRedraw();
+
     if (updateVerticalScrollBar) {
         scrollBarVerticalValueRangeChangedCallback->call(
                     getNumberOfLines(),
@@ -29,6 +29,8 @@
 #include "TimeStamp.hpp"
 #include "HilitingBuffer.hpp"
 #include "BackliteBuffer.hpp"
+#include "MatchBackliteBuffer.hpp"
+#include "MultiCursorBuffer.hpp"
 #include "CallbackContainer.hpp"
 #include "OwningPtr.hpp"
 #include "GuiColor.hpp"
@@ -50,7 +52,8 @@ public:
     enum CreateOption
     {
         READ_ONLY,
-        NEVER_SHOW_CURSOR
+        NEVER_SHOW_CURSOR,
+        RECORD_KEYBOARD_MACRO
     };
     typedef Flags<CreateOption> CreateOptions;
     
@@ -143,6 +146,21 @@ public:
     HilitedText::Ptr getHilitedText() const {
         return hilitingBuffer->getHilitedText();
     }
+    
+    MatchBackliteBuffer* getMatchBackliteBuffer() {
+        return matchBackliteBuffer.getRawPtr();
+    }
+    
+    MultiCursorBuffer* getMultiCursorBuffer() {
+        return multiCursorBuffer.getRawPtr();
+    }
+    
+    long getAllocatedStyleBufferBytes() const {
+        return hilitingBuffer->getAllocatedBytes();
+    }
+    long getAllocatedLineInfoBytes() const {
+        return lineInfos.getAllocatedBytes();
+    }
 
     long getTopLeftTextPosition() const {
         return textData->getTextPositionOfMark(topMarkId);
@@ -250,6 +268,18 @@ public:
     void hideCursor();
     void showCursor();
 
+    /**
+     * Suspends all drawing until the matching resumeScreenUpdates(),
+     * which redraws the whole widget once. Calls may be nested.
+     */
+    void suspendScreenUpdates() {
+        ++screenUpdatesSuspendedCounter;
+    }
+    void resumeScreenUpdates();
+    bool areScreenUpdatesSuspended() const {
+        return screenUpdatesSuspendedCounter > 0;
+    }
+
     void registerCursorPositionDataListener(Callback<CursorPositionData>::Ptr listener);
 
     void treatNotificationOfHotKeyEventForOtherWidget();
@@ -276,6 +306,8 @@ private:
     void fillLineInfo(long beginOfLinePos, RawPtr<LineInfo> li);
     RawPtr<LineInfo> getValidLineInfo(long line);
     void redrawChanged(long spos, long epos);
+    void addPendingRedraw(long spos, long epos);
+    void processPendingRedraw();
     void redraw();
     void drawPartialArea(int minY, int maxY, int x1, int x2);
     void drawArea(int minY, int maxY);
@@ -318,6 +350,8 @@ private:
     
     HilitingBuffer::Ptr hilitingBuffer;
     BackliteBuffer::Ptr backliteBuffer;
+    MatchBackliteBuffer::Ptr matchBackliteBuffer;
+    MultiCursorBuffer::Ptr multiCursorBuffer;
 
     TextData::TextMark topMarkId; // first column of the first displayed textline
     TextData::TextMark cursorMarkId;
@@ -342,6 +376,15 @@ private:
     bool updateVerticalScrollBar;
     bool updateHorizontalScrollBar;
 
+    // text changes are collected and redrawn once per event loop iteration
+    bool hasPendingRedraw;
+    long pendingRedrawBeginPos;
+    long pendingRedrawEndPos;
+    bool needsTotalPixWidthCalculation;
+
+    // while suspended nothing is drawn, line infos are only invalidated
+    int  screenUpdatesSuspendedCounter;
+
     Region redrawRegion; // collects Rectangles for redraw events
     
     CallbackContainer<CursorPositionData> lineAndColumnListeners;
@@ -363,6 +406,8 @@ private:
     bool isMousePointerHidden;
     GuiColor primarySelectionColor;
     GuiColor secondarySelectionColor;
+    GuiColor matchHighlightColor;
+    GuiColor additionalCursorColor;
     GuiColor backgroundColor;
     GC textWidget_gcid;
 
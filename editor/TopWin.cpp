@@ -36,6 +36,7 @@
 #include "File.hpp"
 #include "ProgramName.hpp"
 #include "EncodingConverter.hpp"
+#include "StartupTiming.hpp"
 
 
 #define KEYSYM2UCS_INCLUDED
@@ -54,6 +55,7 @@ TopWin::TopWin()
       isClosingFlag(false),
       position(0,0,1,1),
       isVisibleFlag(false),
+      iconicHintFlag(false),
       sizeHints(NULL),
       initialWidth(-1),
       initialHeight(-1),
@@ -69,14 +71,13 @@ void TopWin::createWidget()
 
     guiWidget = GuiWidget::create(Null, this, getPosition());
     
-    raiseWindowAtom = XInternAtom(guiWidget->getDisplay(), "_NET_ACTIVE_WINDOW", False),
+    raiseWindowAtom = GuiRoot::getInstance()->getX11Atom("_NET_ACTIVE_WINDOW");
 
-    x11InternAtomForDeleteWindow = XInternAtom(GuiRoot::getInstance()->getDisplay(), 
-            "WM_DELETE_WINDOW", False);
+    x11InternAtomForDeleteWindow = GuiRoot::getInstance()->getX11Atom("WM_DELETE_WINDOW");
 //    x11InternAtomForTakeFocus = XInternAtom(getDisplay(), 
 //            "WM_TAKE_FOCUS", False);
 
-    x11InternAtomForUtf8WindowTitle = XInternAtom(guiWidget->getDisplay(), "_NET_WM_NAME", False);
+    x11InternAtomForUtf8WindowTitle = GuiRoot::getInstance()->getX11Atom("_NET_WM_NAME");
                         
     setTitle(title);
 
@@ -226,12 +227,22 @@ void TopWin::requestFocus()
     }
 }
 
-void TopWin::repeatKeyPress(unsigned int keycode, const XEvent* event)
+/**
+ * Processes count overdue repeats at once and synchronizes with the
+ * X server only once afterwards.
+ */
+void TopWin::repeatKeyPress(unsigned int keycode, const XEvent* event, long count)
 {
-    KeyPressRepeater::getInstance()->triggerNextRepeatEventFor(keycode, event, this);
-    
-    processKeyboardEvent(event);
-    
+    XEvent repeatedEvent = *event;
+
+    for (long i = 0; i < count; ++i)
+    {
+        processKeyboardEvent(&repeatedEvent);
+        
+        if (!KeyPressRepeater::getInstance()->isRepeatingFor(this)) {
+            break;
+        }
+    }
     XSync(GuiRoot::getInstance()->getDisplay(), False); // prevent too fast key press event for slow XServer
 }
 
@@ -243,6 +254,10 @@ GuiWidget::ProcessingResult TopWin::processGuiWidgetEvent(const XEvent* event)
         case MapNotify: {
             if (event->xmap.window == guiWidget->getWid()) {
                 mapped = true;
+                if (iconicHintFlag) {
+                    setInitialWindowState(NormalState);
+                    iconicHintFlag = false;
+                }
                 if (requestFocusAfterMapped) {
                     XSetInputFocus(guiWidget->getDisplay(), guiWidget->getWid(), RevertToNone, EventDispatcher::getInstance()->getLastX11Timestamp());
                     requestFocusAfterMapped = false;
@@ -827,6 +842,45 @@ void TopWin::show()
     }
     guiWidget->show();
     isVisibleFlag = true;
+    
+    StartupTiming::finish("first window shown");
+}
+
+
+void TopWin::showIconified()
+{
+    if (!guiWidget.isValid())
+    {
+        createWidget();
+    }
+    if (!isVisibleFlag)
+    {
+        // the initial state is only regarded if the window is not mapped yet
+        setInitialWindowState(IconicState);
+        iconicHintFlag = true;
+        show();
+    }
+    else if (mapped)
+    {
+        XIconifyWindow(getDisplay(), guiWidget->getWid(), GuiRoot::getInstance()->getScreenId());
+    }
+}
+
+
+void TopWin::setInitialWindowState(int state)
+{
+    XWMHints* hints = XGetWMHints(getDisplay(), guiWidget->getWid());
+    
+    if (hints == NULL) {
+        hints = XAllocWMHints();
+    }
+    if (hints != NULL) {
+        hints->flags        |= StateHint;
+        hints->initial_state = state;
+        XSetWMHints(getDisplay(), guiWidget->getWid(), hints);
+        
+        XFree(hints);
+    }
 }
 
 
@@ -67,10 +67,23 @@ public:
     virtual void show();
     virtual void hide();
 
+    /**
+     * Shows the window iconified: it is mapped by the window manager
+     * not before the user opens it.
+     */
+    void showIconified();
+
     bool isVisible() const {
         return isVisibleFlag;
     }
     
+    /**
+     * Shown, but not mapped, because the window is iconified.
+     */
+    bool isIconified() const {
+        return isVisibleFlag && !mapped;
+    }
+    
     void setTitle(const String& title);
 
     virtual void raise();
@@ -97,8 +110,8 @@ public:
     {
         friend class KeyPressRepeater;
         
-        static void repeat(TopWin* topWin, unsigned int keycode, const XEvent* event) {
-            topWin->repeatKeyPress(keycode, event);
+        static void repeat(TopWin* topWin, unsigned int keycode, const XEvent* event, long count) {
+            topWin->repeatKeyPress(keycode, event, count);
         }
     };
     
@@ -172,9 +185,10 @@ private:
     void internalSetSizeHints();
     
     void setWindowManagerHints();
+    void setInitialWindowState(int state);
     void handleConfigChanged();
     
-    void repeatKeyPress(unsigned int keycode, const XEvent* event);
+    void repeatKeyPress(unsigned int keycode, const XEvent* event, long count);
     
     RawPtr<OwnedTopWins> getOwnedTopWins() {
         return ownedTopWins;
@@ -201,6 +215,7 @@ private:
     Position position;
 
     bool isVisibleFlag;
+    bool iconicHintFlag;
 
     GuiWidget::Ptr guiWidget;
 
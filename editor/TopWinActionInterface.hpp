@@ -22,6 +22,10 @@
 #ifndef TOP_WIN_ACTION_INTERFACE_HPP
 #define TOP_WIN_ACTION_INTERFACE_HPP
 
+#include "HeapObject.hpp"
+#include "OwningPtr.hpp"
+#include "String.hpp"
+
 namespace LucED
 {
 
@@ -35,6 +39,11 @@ public:
     virtual void handleSaveAsKey()          = 0;
     virtual void createEmptyWindow()        = 0;
     virtual void createCloneWindow()        = 0;
+    
+    /**
+     * Shows a message in the status line, an empty message clears it.
+     */
+    virtual void setStatusMessage(const String& message) = 0;
 
 protected:
     TopWinActionInterface()
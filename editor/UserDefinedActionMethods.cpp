@@ -67,8 +67,28 @@ LuaVar UserDefinedActionMethods::getLuaActionFunction(ActionId actionId)
     return rslt;
 }
 
+bool UserDefinedActionMethods::cancelAsyncActions()
+{
+    bool wasCancelled = false;
+    
+    for (int i = 0; i < asyncActions.getLength(); ++i)
+    {
+        if (asyncActions[i].isValid() && asyncActions[i]->isRunning()) {
+            asyncActions[i]->cancel();
+            wasCancelled = true;
+        }
+    }
+    asyncActions.clear();
+    
+    return wasCancelled;
+}
+
+
 bool UserDefinedActionMethods::hasActionMethod(ActionId actionId)
 {
+    if (actionId == ActionId::CANCEL_ASYNC_ACTIONS) {
+        return true;
+    }
     if (actionId.isBuiltin()) {
         return false;
     }
@@ -85,6 +105,9 @@ bool UserDefinedActionMethods::hasActionMethod(ActionId actionId)
 
 bool UserDefinedActionMethods::UserDefinedActionMethods::invokeActionMethod(ActionId actionId)
 {
+    if (actionId == ActionId::CANCEL_ASYNC_ACTIONS) {
+        return cancelAsyncActions();
+    }
     if (actionId.isBuiltin() || !textEditor.isValid()) {
         return false;
     }
@@ -103,11 +126,27 @@ bool UserDefinedActionMethods::UserDefinedActionMethods::invokeActionMethod(Acti
     }
     else if (luaActionFunction.isTable())
     {
-        LuaVar shellScript = luaActionFunction["shellScript"];
-        LuaVar shellFilter = luaActionFunction["shellFilter"];
+        LuaVar shellScript   = luaActionFunction["shellScript"];
+        LuaVar shellFilter   = luaActionFunction["shellFilter"];
+        LuaVar asyncFunction = luaActionFunction["asyncFunction"];
         
-        if (shellScript.isValid() && shellFilter.isValid()) {
-            throw ConfigException(String() << "Action '" << actionId.toString() << "' cannot contain both fields 'shellScript' and 'shellFilter'");
+        if (   (shellScript.isValid() && shellFilter.isValid())
+            || (asyncFunction.isValid() && (shellScript.isValid() || shellFilter.isValid())))
+        {
+            throw ConfigException(String() << "Action '" << actionId.toString() << "' must contain only one of the fields 'shellScript', 'shellFilter' or 'asyncFunction'");
+        }
+        else if (asyncFunction.isFunction())
+        {
+            for (int i = 0; i < asyncActions.getLength();)
+            {
+                if (!asyncActions[i].isValid() || !asyncActions[i]->isRunning()) {
+                    asyncActions.remove(i);
+                } else {
+                    ++i;
+                }
+            }
+            asyncActions.append(AsyncLuaAction::start(asyncFunction, textEditor, exceptionHandler));
+            processed = true;
         }
         else if (shellScript.isString() || shellFilter.isString())
         {
@@ -167,7 +206,7 @@ bool UserDefinedActionMethods::UserDefinedActionMethods::invokeActionMethod(Acti
             }
         }
         else {
-            throw ConfigException(String() << "Action '" << actionId.toString() << "' is table but has no field 'shellScript' or 'shellFilter'");
+            throw ConfigException(String() << "Action '" << actionId.toString() << "' is table but has no field 'shellScript', 'shellFilter' or 'asyncFunction'");
         }
     }
     else {
@@ -25,6 +25,9 @@
 #include "ActionMethods.hpp"
 #include "TextEditorWidget.hpp"
 #include "ProgramExecutor.hpp"
+#include "AsyncLuaAction.hpp"
+#include "ObjectArray.hpp"
+#include "Callback.hpp"
 #include "WeakPtr.hpp"
                     
 namespace LucED
@@ -49,11 +52,13 @@ public:
     };
 
     static Ptr create(WeakPtr<TextEditorWidget>   textEditor,
-                      ShellInvocationHandler::Ptr shellInvocationHandler = Null)
+                      ShellInvocationHandler::Ptr shellInvocationHandler = Null,
+                      Callback<>::Ptr             exceptionHandler       = Null)
                       
     {
         return Ptr(new UserDefinedActionMethods(textEditor,
-                                                shellInvocationHandler));
+                                                shellInvocationHandler,
+                                                exceptionHandler));
                                                 
     }
 
@@ -63,15 +68,22 @@ public:
     
 private:
     UserDefinedActionMethods(WeakPtr<TextEditorWidget>   textEditor,
-                             ShellInvocationHandler::Ptr shellInvocationHandler)
+                             ShellInvocationHandler::Ptr shellInvocationHandler,
+                             Callback<>::Ptr             exceptionHandler)
         : textEditor(textEditor),
-          shellInvocationHandler(shellInvocationHandler)
+          shellInvocationHandler(shellInvocationHandler),
+          exceptionHandler(exceptionHandler)
     {}
     
     LuaVar getLuaActionFunction(ActionId actionId);
+    
+    bool cancelAsyncActions();
 
     WeakPtr<TextEditorWidget>   textEditor;
     ShellInvocationHandler::Ptr shellInvocationHandler;
+    Callback<>::Ptr             exceptionHandler;
+    
+    ObjectArray<AsyncLuaAction::WeakPtr> asyncActions;
 };
 
 } // namespace LucED
@@ -19,12 +19,17 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////
 
+#include "util.hpp"
 #include "ViewLuaInterface.hpp"
 #include "ActionIdRegistry.hpp"
 #include "LuaCMethodArgChecker.hpp"
 #include "LuaArgException.hpp"
 #include "RegexException.hpp"
 #include "MatchLuaInterface.hpp"
+#include "TextRangeLuaInterface.hpp"
+#include "LineOperations.hpp"
+#include "SymbolIndex.hpp"
+#include "WordIndex.hpp"
 
 using namespace LucED;
 
@@ -160,6 +165,14 @@ LuaCFunctionResult ViewLuaInterface::insert(const LuaCFunctionArguments& args)
     
     long  insertPos = args[0].toLong();
 
+    if (transactionFlag)
+    {
+        String insertString = args[1].toString();
+
+        editList.append(insertPos, 0, insertString);
+        
+        return LuaCFunctionResult(luaAccess) << insertString.getLength();
+    }
     m.moveToPos(insertPos);
 
     long insertedLength = textData->insertAtMark(m, args[1].toString());
@@ -267,6 +280,28 @@ LuaCFunctionResult ViewLuaInterface::getBytes(const LuaCFunctionArguments& args)
     return LuaCFunctionResult(luaAccess) << rslt;
 }
 
+LuaCFunctionResult ViewLuaInterface::getRange(const LuaCFunctionArguments& args)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+    
+    LuaCMethodArgChecker<long,long>::check(args);
+
+    long pos    = args[0].toLong();
+    long end    = args[1].toLong();
+    long length = textData->getLength();
+    
+    if (pos < 0) {
+        pos = 0;
+    }
+    if (end > length) {
+        end = length;
+    }
+    if (end < pos) {
+        end = pos;
+    }
+    return LuaCFunctionResult(luaAccess) << TextRangeLuaInterface::create(e, pos, end);
+}
+
 void ViewLuaInterface::parseAndSetFindUtilOptions(const LuaCFunctionArguments& args)
 {
     LuaAccess luaAccess = args.getLuaAccess();
@@ -457,6 +492,18 @@ LuaCFunctionResult ViewLuaInterface::getSelection(const LuaCFunctionArguments& a
     return LuaCFunctionResult(luaAccess) << rslt;
 }
 
+LuaCFunctionResult ViewLuaInterface::getSelectionRange(const LuaCFunctionArguments& args)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+    
+    if (e->hasPrimarySelection() || e->hasPseudoSelection())
+    {
+        return LuaCFunctionResult(luaAccess) << TextRangeLuaInterface::create(e, e->getBeginSelectionPos(),
+                                                                                 e->getEndSelectionPos());
+    }
+    return LuaCFunctionResult(luaAccess);
+}
+
 LuaCFunctionResult ViewLuaInterface::replaceSelection(const LuaCFunctionArguments& args)
 {
     LuaAccess luaAccess = args.getLuaAccess();
@@ -509,14 +556,273 @@ LuaCFunctionResult ViewLuaInterface::remove(const LuaCFunctionArguments& args)
     
     if (epos > spos)
     {
-        TextData::TextMark m = e->createNewMarkFromCursor();
-        m.moveToPos(spos);
-        textData->removeAtMark(m, epos - spos);
+        if (transactionFlag) {
+            editList.append(spos, epos - spos, NULL, 0);
+        }
+        else {
+            TextData::TextMark m = e->createNewMarkFromCursor();
+            m.moveToPos(spos);
+            textData->removeAtMark(m, epos - spos);
+        }
     }
     return LuaCFunctionResult(luaAccess);
 }
 
 
+long ViewLuaInterface::applyEditList(const LuaAccess& luaAccess)
+{
+    if (!editList.sortByPosition()) {
+        editList.clear();
+        throw LuaException(luaAccess, "overlapping edits");
+    }
+    long rslt = textData->applyEdits(editList);
+    editList.clear();
+    
+    return rslt;
+}
+
+
+LuaCFunctionResult ViewLuaInterface::applyEdits(const LuaCFunctionArguments& args)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+
+    if (args.getLength() != 1 || !args[0].isTable()) {
+        throw LuaArgException(luaAccess, "argument must be list of edits {beginPos, endPos, insertString}");
+    }
+    if (transactionFlag) {
+        throw LuaException(luaAccess, "applyEdits cannot be called within a transaction");
+    }
+    const long length = textData->getLength();
+    
+    editList.clear();
+    
+    for (int i = 1; ; ++i)
+    {
+        LuaVar edit = args[0][i];
+        
+        if (edit.isNil()) {
+            break;
+        }
+        if (!edit.isTable()) {
+            editList.clear();
+            throw LuaArgException(luaAccess, String() << "invalid edit at index " << i);
+        }
+        LuaVar spos = edit[1];
+        LuaVar epos = edit[2];
+        LuaVar text = edit[3];
+        
+        if (!spos.isNumber() || !epos.isNumber() || !(text.isNil() || text.isString())) {
+            editList.clear();
+            throw LuaArgException(luaAccess, String() << "invalid edit at index " << i);
+        }
+        long b = util::maximum(0L,     spos.toLong());
+        long e = util::minimum(length, epos.toLong());
+        
+        editList.append(b, util::maximum(0L, e - b), text.isString() ? text.toString() : String());
+    }
+    return LuaCFunctionResult(luaAccess) << applyEditList(luaAccess);
+}
+
+
+/**
+ * Within the transaction function view:insert() and view:remove() are
+ * only collected, their positions refer to the text as it was before 
+ * the transaction. The edits are applied after the function returns.
+ */
+LuaCFunctionResult ViewLuaInterface::transaction(const LuaCFunctionArguments& args)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+
+    if (args.getLength() != 1 || !args[0].isFunction()) {
+        throw LuaArgException(luaAccess, "argument must be function");
+    }
+    if (transactionFlag) {
+        args[0].call();
+        return LuaCFunctionResult(luaAccess);
+    }
+    transactionFlag = true;
+    editList.clear();
+    
+    try {
+        args[0].call();
+    }
+    catch (...) {
+        transactionFlag = false;
+        editList.clear();
+        throw;
+    }
+    transactionFlag = false;
+    
+    return LuaCFunctionResult(luaAccess) << applyEditList(luaAccess);
+}
+
+
+/**
+ * The line operations take beginPos and endPos of a span that is extended 
+ * to whole lines and return begin and end of the resulting lines.
+ */
+LuaCFunctionResult ViewLuaInterface::sortLines(const LuaCFunctionArguments& args)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+
+    if (   !LuaCMethodArgChecker<long,long,MoreArgs>::isValid(args)
+        || args.getLength() > 3
+        || (args.getLength() == 3 && !args[2].isTable()))
+    {
+        throw LuaArgException(luaAccess, "arguments must be beginPos, endPos and optional table "
+                                         "{numeric, reverse, ignoreCase, column, regex}");
+    }
+    if (transactionFlag) {
+        throw LuaException(luaAccess, "sortLines cannot be called within a transaction");
+    }
+    LineOperations::SortOptions options;
+    
+    if (args.getLength() == 3)
+    {
+        LuaVar column = args[2]["column"];
+        LuaVar regex  = args[2]["regex"];
+        
+        if (!(column.isNil() || column.isNumber()) || !(regex.isNil() || regex.isString())) {
+            throw LuaArgException(luaAccess, "invalid sort options");
+        }
+        options.numeric    = args[2]["numeric"].toBoolean();
+        options.reverse    = args[2]["reverse"].toBoolean();
+        options.ignoreCase = args[2]["ignoreCase"].toBoolean();
+        
+        if (column.isNumber()) {
+            options.keyColumn = util::maximum(0L, column.toLong());
+        }
+        if (regex.isString()) {
+            options.keyRegex = regex.toString();
+        }
+    }
+    LineOperations lineOperations(textData, args[0].toLong(), args[1].toLong());
+    try {
+        lineOperations.sort(options);
+    } catch (RegexException& ex) {
+        throw LuaException(luaAccess, String() << "Invalid Regex '" << options.keyRegex 
+                                               << "': " << ex.getMessage()); 
+    }
+    return LuaCFunctionResult(luaAccess) << lineOperations.getBeginPos()
+                                         << lineOperations.getEndPos();
+}
+
+
+LuaCFunctionResult ViewLuaInterface::uniqueLines(const LuaCFunctionArguments& args)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+
+    LuaCMethodArgChecker<long,long>::check(args);
+
+    if (transactionFlag) {
+        throw LuaException(luaAccess, "uniqueLines cannot be called within a transaction");
+    }
+    LineOperations lineOperations(textData, args[0].toLong(), args[1].toLong());
+    lineOperations.unique();
+
+    return LuaCFunctionResult(luaAccess) << lineOperations.getBeginPos()
+                                         << lineOperations.getEndPos();
+}
+
+
+LuaCFunctionResult ViewLuaInterface::reverseLines(const LuaCFunctionArguments& args)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+
+    LuaCMethodArgChecker<long,long>::check(args);
+
+    if (transactionFlag) {
+        throw LuaException(luaAccess, "reverseLines cannot be called within a transaction");
+    }
+    LineOperations lineOperations(textData, args[0].toLong(), args[1].toLong());
+    lineOperations.reverse();
+
+    return LuaCFunctionResult(luaAccess) << lineOperations.getBeginPos()
+                                         << lineOperations.getEndPos();
+}
+
+
+LuaCFunctionResult ViewLuaInterface::filterLines(const LuaCFunctionArguments& args)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+
+    if (   !LuaCMethodArgChecker<long,long,MoreArgs>::isValid(args)
+        || args.getLength() < 3 || args.getLength() > 4
+        || !args[2].isString())
+    {
+        throw LuaArgException(luaAccess, "arguments must be beginPos, endPos, regex and optional invert flag");
+    }
+    if (transactionFlag) {
+        throw LuaException(luaAccess, "filterLines cannot be called within a transaction");
+    }
+    String regex  = args[2].toString();
+    bool   invert = (args.getLength() == 4) && args[3].toBoolean();
+    
+    LineOperations lineOperations(textData, args[0].toLong(), args[1].toLong());
+    try {
+        lineOperations.filter(regex, invert);
+    } catch (RegexException& ex) {
+        throw LuaException(luaAccess, String() << "Invalid Regex '" << regex 
+                                               << "': " << ex.getMessage()); 
+    }
+    return LuaCFunctionResult(luaAccess) << lineOperations.getBeginPos()
+                                         << lineOperations.getEndPos();
+}
+
+
+LuaCFunctionResult ViewLuaInterface::findDefinitions(const LuaCFunctionArguments& args)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+
+    LuaCMethodArgChecker<String>::check(args);
+    
+    LuaVar rslt = luaAccess.newTable();
+    
+    if (!textData->isFileNamePseudo())
+    {
+        SymbolIndex::WeakPtr                  index       = SymbolIndex::getInstanceForFile(textData->getFileName());
+        ObjectArray<SymbolIndex::Definition>  definitions = index->findDefinitions(args[0].toString());
+        
+        for (int i = 0; i < definitions.getLength(); ++i)
+        {
+            LuaVar definition = luaAccess.newTable();
+                   definition["fileName"] = definitions[i].fileName;
+                   definition["line"]     = definitions[i].lineNumber;
+                   definition["kind"]     = definitions[i].kind;
+                   definition["name"]     = definitions[i].name;
+            rslt[i + 1] = definition;
+        }
+    }
+    return LuaCFunctionResult(luaAccess) << rslt;
+}
+
+
+LuaCFunctionResult ViewLuaInterface::findSymbolNames(const LuaCFunctionArguments& args)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+
+    if (   args.getLength() < 1 || args.getLength() > 2
+        || !args[0].isString()
+        || (args.getLength() == 2 && !args[1].isNumber()))
+    {
+        throw LuaArgException(luaAccess, "arguments must be prefix and optional maximal number of results");
+    }
+    int    maxResults = (args.getLength() == 2) ? args[1].toInt() : 100;
+    LuaVar rslt       = luaAccess.newTable();
+    
+    if (!textData->isFileNamePseudo())
+    {
+        SymbolIndex::WeakPtr index = SymbolIndex::getInstanceForFile(textData->getFileName());
+        ObjectArray<String>  names = index->findSymbolNames(args[0].toString(), maxResults);
+        
+        for (int i = 0; i < names.getLength(); ++i) {
+            rslt[i + 1] = names[i];
+        }
+    }
+    return LuaCFunctionResult(luaAccess) << rslt;
+}
+
+
 LuaCFunctionResult ViewLuaInterface::assureCursorVisible(const LuaCFunctionArguments& args)
 {
     LuaAccess luaAccess = args.getLuaAccess();
@@ -527,6 +833,52 @@ LuaCFunctionResult ViewLuaInterface::assureCursorVisible(const LuaCFunctionArgum
 }
 
 
+/**
+ * view:replayMacro([count]) replays the last recorded keyboard macro count 
+ * times or, without count, until the end of the file. Returns the number 
+ * of repetitions.
+ */
+LuaCFunctionResult ViewLuaInterface::replayMacro(const LuaCFunctionArguments& args)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+
+    long count = 0;
+    
+    if (args.getLength() >= 1 && args[0].isNumber()) {
+        count = args[0].toLong();
+        if (count <= 0) {
+            return LuaCFunctionResult(luaAccess) << 0;
+        }
+    }
+    return LuaCFunctionResult(luaAccess) << e->replayKeyboardMacro(count);
+}
+
+
+/**
+ * view:findWords(prefix [, maxResults]) returns words of all open files
+ * starting with prefix, recently completed and frequent words first.
+ */
+LuaCFunctionResult ViewLuaInterface::findWords(const LuaCFunctionArguments& args)
+{
+    LuaAccess luaAccess = args.getLuaAccess();
+
+    if (   args.getLength() < 1 || args.getLength() > 2
+        || !args[0].isString()
+        || (args.getLength() == 2 && !args[1].isNumber()))
+    {
+        throw LuaArgException(luaAccess, "arguments must be prefix and optional maximal number of results");
+    }
+    int                 maxResults = (args.getLength() == 2) ? args[1].toInt() : 100;
+    LuaVar              rslt       = luaAccess.newTable();
+    ObjectArray<String> words      = WordIndex::getInstance()->findWords(args[0].toString(), maxResults, textData);
+    
+    for (int i = 0; i < words.getLength(); ++i) {
+        rslt[i + 1] = words[i];
+    }
+    return LuaCFunctionResult(luaAccess) << rslt;
+}
+
+
 LuaCFunctionResult ViewLuaInterface::setCurrentActionCategory(const LuaCFunctionArguments& args)
 {
     LuaAccess luaAccess = args.getLuaAccess();
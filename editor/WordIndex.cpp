@@ -0,0 +1,400 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "WordIndex.hpp"
+#include "EventDispatcher.hpp"
+#include "MilliSeconds.hpp"
+#include "util.hpp"
+
+using namespace LucED;
+
+SingletonInstance<WordIndex> WordIndex::instance;
+
+
+namespace // anonymous namespace
+{
+
+inline bool isWordByte(byte c)
+{
+    return    ('a' <= c && c <= 'z')
+           || ('A' <= c && c <= 'Z')
+           || ('0' <= c && c <= '9')
+           ||  c == '_'
+           ||  c >= 0x80;
+}
+
+} // anonymous namespace
+
+
+class WordIndex::Candidate
+{
+public:
+    Candidate()
+    {}
+    Candidate(const Word& word, int wordId, long order)
+        : wordId(wordId), lastUsed(word.lastUsed), count(word.count), order(order)
+    {}
+    bool operator<(const Candidate& rhs) const {
+        if (lastUsed != rhs.lastUsed) {
+            return lastUsed > rhs.lastUsed;
+        }
+        if (count != rhs.count) {
+            return count > rhs.count;
+        }
+        return order < rhs.order;
+    }
+    int  wordId;
+    long lastUsed;
+    long count;
+    long order;
+};
+
+
+WordIndex* WordIndex::getInstance()
+{
+    return instance.getPtr();
+}
+
+
+WordIndex::WordIndex()
+    : usageCounter(0)
+{
+    processHandler = ProcessHandler::create(this, &WordIndex::process,
+                                                  &WordIndex::needsProcessing);
+    EventDispatcher::getInstance()->registerProcess(processHandler);
+}
+
+
+WordIndex::BufferTracker::BufferTracker(RawPtr<WordIndex> index, RawPtr<TextData> textData)
+    : textData(textData),
+      index(index),
+      numberOfUnindexedBlocks(1)
+{
+    textData->flushPendingUpdates();
+    blocks.append(Block(0, textData->getLength()));
+    
+    textData->registerUpdateListener(newCallback(this, &BufferTracker::treatTextDataUpdate));
+}
+
+
+/**
+ * The blocks touched by the change are merged into one block
+ * that has to be tokenized again.
+ */
+void WordIndex::BufferTracker::treatTextDataUpdate(TextData::UpdateInfo update)
+{
+    int n     = blocks.getLength();
+    int first = 0;
+    int last  = n - 1;
+    
+    while (first < last)
+    {
+        int mid = (first + last) / 2;
+        if (blocks[mid].endPos < update.beginChangedPos) {
+            first = mid + 1;
+        } else {
+            last = mid;
+        }
+    }
+    last = first;
+    while (last + 1 < n && blocks[last + 1].beginPos <= update.oldEndChangedPos) {
+        ++last;
+    }
+    for (int i = first; i <= last; ++i)
+    {
+        if (blocks[i].isIndexed) {
+            index->removeWordCounts(blocks[i].wordCounts);
+        } else {
+            --numberOfUnindexedBlocks;
+        }
+    }
+    long newEndPos = blocks[last].endPos + update.changedAmount;
+
+    blocks.removeAmount(first + 1, last - first);
+    blocks[first].endPos    = newEndPos;
+    blocks[first].isIndexed = false;
+    blocks[first].wordCounts.clear();
+    ++numberOfUnindexedBlocks;
+    
+    for (int i = first + 1, n = blocks.getLength(); i < n; ++i) {
+        blocks[i].beginPos += update.changedAmount;
+        blocks[i].endPos   += update.changedAmount;
+    }
+}
+
+
+void WordIndex::BufferTracker::indexBlocks(TimeStamp endTime)
+{
+    textData->flushPendingUpdates();
+    
+    while (numberOfUnindexedBlocks > 0)
+    {
+        indexNextBlock();
+        
+        if (TimeStamp::now() >= endTime) {
+            break;
+        }
+    }
+}
+
+
+/**
+ * Tokenizes the first unindexed block. Large blocks, e.g. of a newly 
+ * opened file, are split at the first line end after BLOCK_SIZE bytes.
+ */
+void WordIndex::BufferTracker::indexNextBlock()
+{
+    int i = 0;
+    while (blocks[i].isIndexed) {
+        ++i;
+    }
+    long beginPos = blocks[i].beginPos;
+    long length   = blocks[i].endPos - beginPos;
+    long cutPos   = length;
+    
+    if (length > BLOCK_SIZE)
+    {
+        long        searchLength = util::minimum((long) BLOCK_SIZE + MAX_LINE_END_DISTANCE, length);
+        const byte* text         = textData->getAmount(beginPos, searchLength);
+        const void* lineEnd      = memchr(text + BLOCK_SIZE - 1, '\n', searchLength - (BLOCK_SIZE - 1));
+        
+        if (lineEnd != NULL) {
+            cutPos = (const byte*) lineEnd + 1 - text;
+        }
+        else if (searchLength < length)
+        {
+            // text without near line end, e.g. minified files, 
+            // is split behind a non-word byte
+            
+            cutPos = BLOCK_SIZE;
+            while (cutPos > 0 && isWordByte(text[cutPos - 1])) {
+                --cutPos;
+            }
+            if (cutPos == 0) {
+                cutPos = BLOCK_SIZE;
+            }
+        }
+    }
+    const byte*   text = textData->getAmount(beginPos, cutPos);
+    MemArray<int> wordIds;
+    
+    for (long p = 0; p < cutPos;)
+    {
+        if (!isWordByte(text[p])) {
+            ++p;
+            continue;
+        }
+        long q = p + 1;
+        while (q < cutPos && isWordByte(text[q])) {
+            ++q;
+        }
+        if (   MIN_WORD_LENGTH <= q - p && q - p <= MAX_WORD_LENGTH
+            && !('0' <= text[p] && text[p] <= '9'))
+        {
+            wordIds.append(index->getWordId((const char*) text + p, q - p));
+        }
+        p = q;
+    }
+    std::sort(wordIds.getPtr(0), wordIds.getPtr(0) + wordIds.getLength());
+    
+    Block block(beginPos, beginPos + cutPos);
+          block.isIndexed = true;
+
+    for (long j = 0, n = wordIds.getLength(); j < n;)
+    {
+        long k = j + 1;
+        while (k < n && wordIds[k] == wordIds[j]) {
+            ++k;
+        }
+        block.wordCounts.append(WordCount(wordIds[j], k - j));
+        j = k;
+    }
+    index->addWordCounts(block.wordCounts);
+
+    if (cutPos < length) {
+        blocks[i].beginPos = beginPos + cutPos;
+        blocks.insert(i, block);
+    } else {
+        blocks[i].isIndexed = true;
+        blocks[i].wordCounts.takeOver(&block.wordCounts);
+        --numberOfUnindexedBlocks;
+    }
+}
+
+
+void WordIndex::BufferTracker::removeAllWordCounts()
+{
+    for (int i = 0; i < blocks.getLength(); ++i) {
+        if (blocks[i].isIndexed) {
+            index->removeWordCounts(blocks[i].wordCounts);
+        }
+    }
+    blocks.clear();
+    numberOfUnindexedBlocks = 0;
+}
+
+
+int WordIndex::getWordId(const char* word, long length)
+{
+    String            name(word, length);
+    NameMap::iterator entry = names.find(name);
+    
+    if (entry != names.end()) {
+        return entry->second;
+    }
+    int wordId;
+    
+    if (freeWordIds.getLength() > 0) {
+        wordId = freeWordIds.getAndRemoveLast();
+    } else {
+        wordId = words.getLength();
+        words.append(Word());
+    }
+    words[wordId].entry = names.insert(std::make_pair(name, wordId)).first;
+
+    return wordId;
+}
+
+
+void WordIndex::addWordCounts(const MemArray<WordCount>& wordCounts)
+{
+    for (long i = 0, n = wordCounts.getLength(); i < n; ++i) {
+        words[wordCounts[i].wordId].count += wordCounts[i].count;
+    }
+}
+
+
+/**
+ * Words that do not occur anymore are removed, their ids are reused.
+ */
+void WordIndex::removeWordCounts(const MemArray<WordCount>& wordCounts)
+{
+    for (long i = 0, n = wordCounts.getLength(); i < n; ++i)
+    {
+        int   wordId = wordCounts[i].wordId;
+        Word& word   = words[wordId];
+        
+        word.count -= wordCounts[i].count;
+        
+        if (word.count <= 0) {
+            names.erase(word.entry);
+            word = Word();
+            freeWordIds.append(wordId);
+        }
+    }
+}
+
+
+void WordIndex::registerTextData(RawPtr<TextData> textData)
+{
+    for (int i = 0; i < trackers.getLength(); ++i) {
+        if (trackers[i]->textData == textData) {
+            return;
+        }
+    }
+    trackers.append(BufferTracker::create(this, textData));
+}
+
+
+ObjectArray<String> WordIndex::findWords(const String& prefix, int maxResults,
+                                         RawPtr<TextData> currentTextData)
+{
+    if (maxResults <= 0) {
+        return ObjectArray<String>();
+    }
+    for (int i = 0; i < trackers.getLength(); ++i)
+    {
+        if (trackers[i]->textData == currentTextData) {
+            trackers[i]->indexBlocks(TimeStamp::now() + MilliSeconds(MAX_LOOKUP_INDEXING_MS));
+            break;
+        }
+    }
+    MemArray<Candidate> candidates;
+    long                order = 0;
+    
+    for (NameMap::const_iterator entry = names.lower_bound(prefix);
+         entry != names.end() && entry->first.startsWith(prefix) && order < MAX_SCANNED_WORDS;
+         ++entry, ++order)
+    {
+        if (entry->first.getLength() > prefix.getLength()) {
+            candidates.append(Candidate(words[entry->second], entry->second, order));
+        }
+    }
+    long numberOfResults = util::minimum((long) maxResults, candidates.getLength());
+    
+    std::partial_sort(candidates.getPtr(0), 
+                      candidates.getPtr(0) + numberOfResults,
+                      candidates.getPtr(0) + candidates.getLength());
+    
+    ObjectArray<String> rslt;
+    
+    for (long i = 0; i < numberOfResults; ++i) {
+        rslt.append(words[candidates[i].wordId].entry->first);
+    }
+    return rslt;
+}
+
+
+void WordIndex::notifyAboutCompletedWord(const String& word)
+{
+    NameMap::iterator entry = names.find(word);
+    
+    if (entry != names.end()) {
+        words[entry->second].lastUsed = ++usageCounter;
+    }
+}
+
+
+bool WordIndex::needsProcessing()
+{
+    for (int i = 0; i < trackers.getLength(); ++i)
+    {
+        if (trackers[i]->hasUnindexedBlocks() || !trackers[i]->textData.isValid()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+int WordIndex::process(TimeStamp endTime)
+{
+    for (int i = 0; i < trackers.getLength(); ++i)
+    {
+        if (!trackers[i]->textData.isValid()) {
+            trackers[i]->removeAllWordCounts();
+            trackers.remove(i);
+            --i;
+        }
+        else if (trackers[i]->hasUnindexedBlocks()) {
+            trackers[i]->indexBlocks(endTime);
+            
+            if (TimeStamp::now() >= endTime) {
+                break;
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,175 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   LucED - The Lucid Editor
+//
+//   Copyright (C) 2005-2012 Oliver Schmidt, oliver at luced dot de
+//
+//   This program is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU General Public License Version 2 as published
+//   by the Free Software Foundation in June 1991.
+//
+//   This program is distributed in the hope that it will be useful, but WITHOUT
+//   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+//   more details.
+//
+//   You should have received a copy of the GNU General Public License along with 
+//   this program; if not, write to the Free Software Foundation, Inc., 
+//   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef WORD_INDEX_HPP
+#define WORD_INDEX_HPP
+
+#include <map>
+
+#include "HeapObject.hpp"
+#include "SingletonInstance.hpp"
+#include "OwningPtr.hpp"
+#include "WeakPtr.hpp"
+#include "RawPtr.hpp"
+#include "ObjectArray.hpp"
+#include "MemArray.hpp"
+#include "String.hpp"
+#include "TimeStamp.hpp"
+#include "ProcessHandler.hpp"
+#include "TextData.hpp"
+
+namespace LucED
+{
+
+/**
+ * Index of the words of all open editor windows for word completion.
+ *
+ * Each buffer is divided into blocks of whole lines. A block stores how 
+ * often each word occurs in it, so that a text change only needs to 
+ * subtract the counts of the blocks it touches and to tokenize these 
+ * blocks again. Tokenizing is done lazily: in the background while the 
+ * editor is idle and for the current buffer before a lookup.
+ */
+class WordIndex : public HeapObject
+{
+public:
+    static WordIndex* getInstance();
+    
+    /**
+     * Starts tracking the words of the text, called for each new editor window.
+     */
+    void registerTextData(RawPtr<TextData> textData);
+
+    /**
+     * Returns words starting with prefix but longer than prefix, the 
+     * recently completed words first, then the most frequent ones.
+     */
+    ObjectArray<String> findWords(const String& prefix, int maxResults,
+                                  RawPtr<TextData> currentTextData = Null);
+
+    /**
+     * Ranks the word before all other words in the next lookups.
+     */
+    void notifyAboutCompletedWord(const String& word);
+
+private:
+    friend class SingletonInstance<WordIndex>;
+    static SingletonInstance<WordIndex> instance;
+    
+    enum {
+        BLOCK_SIZE              = 64 * 1024,
+        MAX_LINE_END_DISTANCE   = 16 * 1024,
+        MIN_WORD_LENGTH         = 2,
+        MAX_WORD_LENGTH         = 100,
+        MAX_SCANNED_WORDS       = 20000,
+        MAX_LOOKUP_INDEXING_MS  = 50
+    };
+    
+    typedef std::map<String, int> NameMap;
+
+    class Word
+    {
+    public:
+        Word()
+            : count(0), lastUsed(0)
+        {}
+        long              count;
+        long              lastUsed;
+        NameMap::iterator entry;
+    };
+    
+    class WordCount
+    {
+    public:
+        WordCount()
+        {}
+        WordCount(int wordId, long count)
+            : wordId(wordId), count(count)
+        {}
+        int  wordId;
+        long count;
+    };
+    
+    class Block
+    {
+    public:
+        Block()
+        {}
+        Block(long beginPos, long endPos)
+            : beginPos(beginPos), endPos(endPos), isIndexed(false)
+        {}
+        long                beginPos;
+        long                endPos;
+        bool                isIndexed;
+        MemArray<WordCount> wordCounts;
+    };
+    
+    class BufferTracker : public HeapObject
+    {
+    public:
+        typedef LucED::OwningPtr<BufferTracker> Ptr;
+        
+        static Ptr create(RawPtr<WordIndex> index, RawPtr<TextData> textData) {
+            return Ptr(new BufferTracker(index, textData));
+        }
+        
+        bool hasUnindexedBlocks() const {
+            return numberOfUnindexedBlocks > 0;
+        }
+        void indexBlocks(TimeStamp endTime);
+        void removeAllWordCounts();
+        
+        LucED::WeakPtr<TextData> textData;
+
+    private:
+        BufferTracker(RawPtr<WordIndex> index, RawPtr<TextData> textData);
+
+        void treatTextDataUpdate(TextData::UpdateInfo update);
+        void indexNextBlock();
+
+        RawPtr<WordIndex>  index;
+        ObjectArray<Block> blocks;
+        long               numberOfUnindexedBlocks;
+    };
+    
+    class Candidate;
+    
+    WordIndex();
+
+    int  getWordId(const char* word, long length);
+    void addWordCounts   (const MemArray<WordCount>& wordCounts);
+    void removeWordCounts(const MemArray<WordCount>& wordCounts);
+    
+    bool needsProcessing();
+    int  process(TimeStamp endTime);
+    
+    NameMap                         names;
+    ObjectArray<Word>               words;
+    MemArray<int>                   freeWordIds;
+    long                            usageCounter;
+    
+    ObjectArray<BufferTracker::Ptr> trackers;
+    ProcessHandler::Ptr             processHandler;
+};
+
+} // namespace LucED
+
+#endif // WORD_INDEX_HPP
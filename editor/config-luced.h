@@ -59,6 +59,42 @@
 
 
 
+/* usage of epoll, timerfd and signalfd in the event loop */
+
+#if !defined(LUCED_USE_EPOLL)
+#  if HAVE_SYS_EPOLL_H && HAVE_SYS_TIMERFD_H && HAVE_SYS_SIGNALFD_H && !DISABLE_EPOLL
+#    define LUCED_USE_EPOLL 1
+#  else
+#    define LUCED_USE_EPOLL 0
+#  endif
+#endif
+
+
+
+/* pooled storage for small HeapObjects */
+
+#if !defined(LUCED_USE_HEAP_OBJECT_POOL)
+#  if !DISABLE_HEAP_OBJECT_POOL
+#    define LUCED_USE_HEAP_OBJECT_POOL 1
+#  else
+#    define LUCED_USE_HEAP_OBJECT_POOL 0
+#  endif
+#endif
+
+
+
+/* per class statistics of created HeapObjects, printed at program exit */
+
+#if !defined(LUCED_USE_HEAP_OBJECT_STATISTICS)
+#  if ENABLE_HEAP_OBJECT_STATISTICS
+#    define LUCED_USE_HEAP_OBJECT_STATISTICS 1
+#  else
+#    define LUCED_USE_HEAP_OBJECT_STATISTICS 0
+#  endif
+#endif
+
+
+
 /* usage of xkblib */
 
 #if !defined(LUCED_USE_XKBLIB)
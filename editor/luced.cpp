@@ -39,6 +39,7 @@
 #include "ProgramName.hpp"
 #include "DefaultConfig.hpp"
 #include "ConfigException.hpp"
+#include "StartupTiming.hpp"
 
 
 using namespace LucED;
@@ -86,6 +87,8 @@ static void startupServer(int argc, char** argv)
 
 int main(int argc, char** argv)
 {
+    StartupTiming::start();
+
     setlocale(LC_CTYPE, "");
 
     int rc = 0;
@@ -2186,12 +2186,35 @@ static int printpat_l (lua_State *L) {
 }
 
 
+/*
+** optional reader for subjects that are not strings (used by the
+** embedding application to match directly on its own buffers)
+*/
+typedef const char *(*lpeg_SubjectReader) (lua_State *L, int idx, size_t *l);
+
+static lpeg_SubjectReader subjectreader = NULL;
+
+void lpeg_setsubjectreader (lpeg_SubjectReader reader);
+void lpeg_setsubjectreader (lpeg_SubjectReader reader) {
+  subjectreader = reader;
+}
+
+
+static const char *checksubject (lua_State *L, size_t *l) {
+  if (subjectreader != NULL && lua_type(L, SUBJIDX) == LUA_TUSERDATA) {
+    const char *s = subjectreader(L, SUBJIDX, l);
+    if (s != NULL) return s;
+  }
+  return luaL_checklstring(L, SUBJIDX, l);
+}
+
+
 static int matchl (lua_State *L) {
   Capture capture[IMAXCAPTURES];
   const char *r;
   size_t l;
   Instruction *p = getpatt(L, 1, NULL);
-  const char *s = luaL_checklstring(L, SUBJIDX, &l);
+  const char *s = checksubject(L, &l);
   int ptop = lua_gettop(L);
   lua_Integer ii = luaL_optinteger(L, 3, 1);
   size_t i = (ii > 0) ?
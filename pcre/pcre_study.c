@@ -544,6 +544,16 @@ do
       tcode += 2 + 2*LINK_SIZE;
       break;
 
+      /* Skip over zero-width assertions: the match still has to start with
+      one of the characters of the following item. */
+
+      case OP_WORD_BOUNDARY:
+      case OP_NOT_WORD_BOUNDARY:
+      case OP_CIRC:
+      case OP_DOLL:
+      tcode++;
+      break;
+
       /* Skip over lookbehind and negative lookahead assertions */
 
       case OP_ASSERT_NOT: